@@ -30,6 +30,7 @@
 
 #include <di/core/ProcessingNetwork.h>
 #include <di/core/Connection.h>
+#include <di/core/CompressedFile.h>
 #include <di/core/Filesystem.h>
 #include <di/core/StringUtils.h>
 
@@ -45,6 +46,8 @@
 
 #include <di/io/RegionLabelReader.h>
 #include <di/io/PlyReader.h>
+#include <di/io/PlyWriter.h>
+#include <di/io/FreeSurferSurfaceReader.h>
 
 #include <di/gui/ViewWidget.h>
 #include <di/gui/AlgorithmStrategies.h>
@@ -88,6 +91,31 @@ namespace di
                     m_screenShotMode = true;
                     LogD << "Commandline: screenshot mode activated." << LogEnd;
                 }
+                else if( argument == "--mesh-cache" )
+                {
+                    m_meshCache = true;
+                    LogD << "Commandline: mesh cache activated." << LogEnd;
+                }
+                else if( argument.find( "--mesh-preview=" ) != std::string::npos )
+                {
+                    auto len = std::string( "--mesh-preview=" ).length();
+                    try
+                    {
+                        m_meshPreviewTriangles = std::stoul( argument.substr( len, argument.length() - len ) );
+                        LogD << "Commandline: mesh preview every " << m_meshPreviewTriangles << " triangles." << LogEnd;
+                    }
+                    catch( const std::exception& )
+                    {
+                        LogW << "Commandline: invalid number of preview triangles. Ignoring." << LogEnd;
+                    }
+                }
+                else if( argument.find( "--export=" ) != std::string::npos )
+                {
+                    // NOTE: use the original arg to keep the case of the path.
+                    auto len = std::string( "--export=" ).length();
+                    m_exportPath = arg.substr( len, arg.length() - len );
+                    LogD << "Commandline: export results to \"" << m_exportPath << "\"." << LogEnd;
+                }
                 else if( argument.find( "--screenshot-path=" ) != std::string::npos )
                 {
                     auto len = std::string( "--screenshot-path=" ).length();
@@ -174,18 +202,24 @@ namespace di
             // Hard-coded processing network ... ugly but working for now. The optimal solution would be a generic UI which provides this to the user
             // BEGIN:
 
-            // Load mesh
-            m_meshFile = new di::gui::FileWidget( std::make_shared< di::io::PlyReader >(),
+            // Load mesh. Previews are useless in screenshot mode as only the final result is shown.
+            auto meshReader = std::make_shared< di::io::PlyReader >( !m_screenShotMode, m_meshCache, m_screenShotMode ? 0 : m_meshPreviewTriangles );
+            m_meshFile = new di::gui::FileWidget( meshReader,
                                                   "Mesh",
                                                   QIcon( QPixmap( iconMesh_xpm ) ),
-                                                  QString( "Stanford Poly Format (*.ply)" ) );
+                                                  QString( "Stanford Poly Format (*.ply *.ply.gz *.ply.zst);;"
+                                                           "FreeSurfer Surface (*.pial *.white *.inflated *.orig *.smoothwm *.sphere *.midthickness "
+                                                           "*.graymid);;"
+                                                           "GIfTI Surface (*.surf.gii)" ) );
             m_dataWidget->addFileWidget( m_meshFile );
 
             // Load Labels
             m_labelFile = new di::gui::FileWidget( std::make_shared< di::io::RegionLabelReader >(),
                                                    "Region Labels",
                                                    QIcon( QPixmap( iconLabels_xpm ) ),
-                                                   QString( "Region Labels File (*.labels)" ) );
+                                                   QString( "Region Labels File (*.labels *.labels.gz *.labels.zst);;"
+                                                            "FreeSurfer Annotation (*.annot);;"
+                                                            "GIfTI Labels (*.label.gii)" ) );
             m_dataWidget->addFileWidget( m_labelFile );
 
             // Load Label Order List
@@ -248,7 +282,8 @@ namespace di
             // loader for each incoming file. We are forced to use extension.
             for( auto filename : m_deferLoad )
             {
-                auto ext = di::core::toLower( di::core::getFileExtension( filename ) );
+                // Compressed files are routed by the extension of their contents.
+                auto ext = di::core::toLower( di::core::getFileExtension( di::core::getUncompressedFilename( filename ) ) );
                 if( ext == "project" )
                 {
                     loadProject( QString::fromStdString( filename ) );
@@ -259,12 +294,14 @@ namespace di
                     m_labelOrderFile->load( filename );
                     continue;
                 }
-                if( ext == "labels" )
+                // GIfTI files contain surfaces or labels. They are named accordingly.
+                bool isGiftiLabels = ( ext == "gii" ) && di::core::toLower( filename ).find( ".label.gii" ) != std::string::npos;
+                if( ( ext == "labels" ) || ( ext == "annot" ) || isGiftiLabels )
                 {
                     m_labelFile->load( filename );
                     continue;
                 }
-                if( ext == "ply" )
+                if( ( ext == "ply" ) || ( ext == "gii" ) || di::io::FreeSurferSurfaceReader().canLoad( filename ) )
                 {
                     m_meshFile->load( filename );
                     continue;
@@ -286,9 +323,20 @@ namespace di
                 LogD << "Issuing update command." << LogEnd;
                 getProcessingNetwork()->runNetwork();
 
+                // Export before the screenshot. The app closes afterwards.
+                if( !m_exportPath.empty() )
+                {
+                    exportResults( QString::fromStdString( m_exportPath ) );
+                }
+
                 // Trigger the screenshot function when done. But use the runInUIThread adapter to ensure this is done in the UI thread.
                 getProcessingNetwork()->callback( runInUIThread( std::bind( &di::gui::ViewWidget::screenshot, m_viewWidget, m_screenShotPath ) ) );
             }
+            else if( !m_exportPath.empty() )
+            {
+                getProcessingNetwork()->runNetwork();
+                exportResults( QString::fromStdString( m_exportPath ) );
+            }
         }
 
         void App::close()
@@ -296,6 +344,12 @@ namespace di
             LogD << "Shutdown. Bye!" << LogEnd;
         }
 
+        void App::exportResults( const QString& filename )
+        {
+            getProcessingNetwork()->writeFile( std::make_shared< di::io::PlyWriter >(), m_extractRegions->getAlgorithm(), "Annotated Directionality",
+                                               filename.toStdString() );
+        }
+
         void App::loadProject( const QString& filename )
         {
             di::core::State s = di::core::State::fromFile( filename.toStdString() );
@@ -118,6 +118,14 @@ namespace di
             virtual void saveProject( const QString& filename,
                                       bool all = true, bool viewOnly = false, bool paramsOnly = false, bool dataOnly = false ) override;
 
+            /**
+             * Export the extracted directions along with the mesh, its colors and labels as PLY file. The export runs in the processing network
+             * after all pending work.
+             *
+             * \param filename the file to write
+             */
+            virtual void exportResults( const QString& filename ) override;
+
             /**
              * Handle the provided switches and parameters. Return false if the provided parameters are faulty. This causes the application to stop.
              * It is your choice to either use the argument vector or argc,argv. If you do not override this method, it will allow all parameters but
@@ -182,10 +190,25 @@ namespace di
              */
             bool m_screenShotMode = false;
 
+            /**
+             * If true, meshes are cached next to their source file for faster loading next time.
+             */
+            bool m_meshCache = false;
+
+            /**
+             * Show a preview of large meshes each time this number of triangles is loaded. 0 disables previews. Never used in screenshot mode.
+             */
+            size_t m_meshPreviewTriangles = 0;
+
             /**
              * The path where to store the screenshots. Needs to be absolute.
              */
             std::string m_screenShotPath;
+
+            /**
+             * If not empty, the results are exported to this file after the network ran.
+             */
+            std::string m_exportPath;
         };
     }
 }
@@ -49,7 +49,7 @@ namespace di
             // nothing to clean up so far
         }
 
-        void DataInject::process()
+        void DataInject::process( const di::core::CancellationToken& /* token */ )
         {
             std::lock_guard<std::mutex> lock( m_injectionDataMutex );
             if( !isUpdateRequested() )
@@ -53,8 +53,10 @@ namespace di
 
             /**
              * Does nothing in this case, besides setting the injection data.
+             *
+             * \param token cancellation token of this run
              */
-            virtual void process();
+            virtual void process( const di::core::CancellationToken& token );
 
             /**
              * Inject this data.
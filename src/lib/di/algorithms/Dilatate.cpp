@@ -27,6 +27,9 @@
 #include <vector>
 #include <utility>
 
+#include <di/core/VolumeConnector.h>
+#include <di/core/data/SlabStreaming.h>
+
 #include "Dilatate.h"
 
 #include <di/core/Logger.h>
@@ -36,97 +39,118 @@ namespace di
 {
     namespace algorithms
     {
-        Dilatate::Dilatate():
+        template< typename ValueT >
+        Dilatate< ValueT >::Dilatate():
             Algorithm( "Dilatate",
                        "Apply a morphological dilatation to the input data." )
         {
             // 1: the output
-            m_dataOutput = addOutput< di::core::DataSetScalarRegular3d >(
+            m_dataOutput = addOutput< di::core::DataSetScalarRegular3< ValueT > >(
                     "Dilatated",
                     "The dilatated input data."
             );
 
             // 2: the input
-            m_dataInput = addInput< di::core::DataSetScalarRegular3d >(
+            m_dataInput = std::make_shared< di::core::VolumeConnector< ValueT > >(
                     "Input",
-                    "The data to process."
+                    "The data to process. Volumes of other value types are converted."
             );
+            addInput( m_dataInput );
         }
 
-        Dilatate::~Dilatate()
+        template< typename ValueT >
+        Dilatate< ValueT >::~Dilatate()
         {
             // nothing to clean up so far
         }
 
-        void Dilatate::process()
+        template< typename ValueT >
+        void Dilatate< ValueT >::process( const di::core::CancellationToken& token )
         {
             // Get input data
             auto inputData = m_dataInput->getData();
-            auto inputValues = inputData->getAttributes<0>();
+            auto inputValues = inputData->template getAttributes< 0 >();
 
             auto grid = inputData->getGrid();
-            auto values = std::make_shared< std::vector< double > >( grid->getSize() );
+            auto values = core::createVolumeArray< ValueT >( grid->getSize() );
 
-            // Iterate each voxel:
-            for( size_t z = 1; z < grid->getSizeZ() - 1; ++z )
-            {
-                for( size_t y = 1; y < grid->getSizeY() - 1; ++y )
+            // Iterate each voxel. Process the volume in Z-slabs in parallel. Each slab reads one layer of halo above and below.
+            size_t layerSize = grid->getSizeX() * grid->getSizeY();
+            auto slabDepth = core::getSlabDepth( grid->getSizeZ(), 2 * layerSize * sizeof( ValueT ) );
+            core::processSlabs( 1, grid->getSizeZ() - 1, slabDepth,
+                [ & ]( size_t slabBegin, size_t slabEnd )
                 {
-                    for( size_t x = 1; x < grid->getSizeX() - 1; ++x )
+                    for( size_t z = slabBegin; z < slabEnd; ++z )
                     {
-                        // center
-                        auto cIdx = grid->index( x, y, z );
-                        // neighbour
-                        bool neighbourFilled = false;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y, z ) ] != 0.0 ? true : neighbourFilled;
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y + 1, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-                        // Include vertex-neighbours?
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y - 1, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y - 1, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y - 1, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y + 1, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y + 1, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x - 1, y + 1, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y + 1, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x, y + 1, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y - 1, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y - 1, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y - 1, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y + 1, z ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y + 1, z - 1 ) ] != 0.0 ? true : neighbourFilled;
-                        neighbourFilled = ( *inputValues )[ grid->index( x + 1, y + 1, z + 1 ) ] != 0.0 ? true : neighbourFilled;
-
-                        ( *values )[ cIdx ] = neighbourFilled ? 1.0 : 0.0;
+                        token.throwIfCancelled();
+                        for( size_t y = 1; y < grid->getSizeY() - 1; ++y )
+                        {
+                            for( size_t x = 1; x < grid->getSizeX() - 1; ++x )
+                            {
+                                // center
+                                auto cIdx = grid->index( x, y, z );
+                                // neighbour
+                                bool neighbourFilled = false;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y + 1, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                // Include vertex-neighbours?
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y - 1, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y - 1, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y - 1, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y + 1, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y + 1, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x - 1, y + 1, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y - 1, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y + 1, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x, y + 1, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y - 1, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y - 1, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y - 1, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y + 1, z ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y + 1, z - 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+                                neighbourFilled = ( *inputValues )[ grid->index( x + 1, y + 1, z + 1 ) ] != ValueT( 0 ) ? true : neighbourFilled;
+
+                                ( *values )[ cIdx ] = neighbourFilled ? ValueT( 1 ) : ValueT( 0 );
+                            }
+                        }
                     }
+
+                    // Done with this slab. If the volumes live in files, give the memory back.
+                    inputValues->release( slabBegin * layerSize, ( slabEnd - slabBegin ) * layerSize );
+                    values->release( slabBegin * layerSize, ( slabEnd - slabBegin ) * layerSize );
                 }
-            }
+            );
 
             // Construct result dataset:
-            m_dataOutput->setData( std::make_shared< di::core::DataSetScalarRegular3d >( "Dilatetd", grid, values ) );
+            m_dataOutput->setData( std::make_shared< di::core::DataSetScalarRegular3< ValueT > >( "Dilatetd", grid, values ) );
         }
+
+        // Instantiate for all supported value types
+        template class Dilatate< double >;
+        template class Dilatate< float >;
+        template class Dilatate< uint16_t >;
+        template class Dilatate< uint8_t >;
     }
 }
-
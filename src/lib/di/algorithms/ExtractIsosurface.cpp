@@ -0,0 +1,680 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <di/core/Parallel.h>
+#include <di/core/VolumeConnector.h>
+
+#include "ExtractIsosurface.h"
+
+#include <di/core/Logger.h>
+#define LogTag "algorithms/ExtractIsosurface"
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Marching cubes edge table. Bit i is set if cube edge i is intersected by the surface. The case index of a cube has bit n set if corner n
+         * is inside (value >= iso value). Corner and edge numbering follows Paul Bourke, "Polygonising a scalar field".
+         */
+        static const int s_edgeTable[ 256 ] =
+        {
+                0x000, 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
+                0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
+                0x190, 0x099, 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
+                0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
+                0x230, 0x339, 0x033, 0x13a, 0x636, 0x73f, 0x435, 0x53c,
+                0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
+                0x3a0, 0x2a9, 0x1a3, 0x0aa, 0x7a6, 0x6af, 0x5a5, 0x4ac,
+                0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
+                0x460, 0x569, 0x663, 0x76a, 0x066, 0x16f, 0x265, 0x36c,
+                0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
+                0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0x0ff, 0x3f5, 0x2fc,
+                0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
+                0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x055, 0x15c,
+                0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
+                0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0x0cc,
+                0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
+                0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
+                0x0cc, 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
+                0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
+                0x15c, 0x055, 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
+                0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
+                0x2fc, 0x3f5, 0x0ff, 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
+                0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
+                0x36c, 0x265, 0x16f, 0x066, 0x76a, 0x663, 0x569, 0x460,
+                0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
+                0x4ac, 0x5a5, 0x6af, 0x7a6, 0x0aa, 0x1a3, 0x2a9, 0x3a0,
+                0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
+                0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x033, 0x339, 0x230,
+                0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
+                0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x099, 0x190,
+                0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
+                0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x000
+        };
+
+        /**
+         * Marching cubes triangle table. Lists up to 5 triangles per case as triplets of edge indices, terminated by -1. Ambiguous faces always
+         * separate the inside corners. As this decision only depends on the face itself, neighbouring cubes agree and the surface stays closed.
+         * Triangles are wound counter-clockwise when looked at from the outside (lower values).
+         */
+        static const int s_triangleTable[ 256 ][ 16 ] =
+        {
+                { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  2,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8, 10,  2,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9, 10,  2,  9,  2,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  9,  2,  9, 10, -1, -1, -1, -1, -1, -1, -1 },
+                { 11,  3,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0, 11,  3,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  2, 11,  1, 11,  8,  1,  8,  9, -1, -1, -1, -1, -1, -1, -1 },
+                { 10, 11,  3, 10,  3,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1, 10,  0, 10, 11,  0, 11,  8, -1, -1, -1, -1, -1, -1, -1 },
+                {  9, 10, 11,  9, 11,  3,  9,  3,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  9, 10,  8, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  7,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  7,  1,  7,  4,  1,  4,  9, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  2,  1,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  4, 10,  2,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9, 10,  2,  9,  2,  0,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  7,  2,  7,  4,  2,  4,  9,  2,  9, 10, -1, -1, -1, -1 },
+                { 11,  3,  2,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  7,  0,  7,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0, 11,  3,  2,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  2, 11,  1, 11,  7,  1,  7,  4,  1,  4,  9, -1, -1, -1, -1 },
+                { 10, 11,  3, 10,  3,  1,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1, 10,  0, 10, 11,  0, 11,  7,  0,  7,  4, -1, -1, -1, -1 },
+                {  9, 10, 11,  9, 11,  3,  9,  3,  0,  8,  7,  4, -1, -1, -1, -1 },
+                {  9, 10, 11,  9, 11,  7,  9,  7,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  5,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  4,  5,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  5,  1,  4,  1,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  4,  1,  4,  5, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  2,  1,  4,  5,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8, 10,  2,  1,  4,  5,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  5, 10,  4, 10,  2,  4,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  4,  2,  4,  5,  2,  5, 10, -1, -1, -1, -1 },
+                { 11,  3,  2,  4,  5,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  8,  4,  5,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  5,  1,  4,  1,  0, 11,  3,  2, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  2, 11,  1, 11,  8,  1,  8,  4,  1,  4,  5, -1, -1, -1, -1 },
+                { 10, 11,  3, 10,  3,  1,  4,  5,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1, 10,  0, 10, 11,  0, 11,  8,  4,  5,  9, -1, -1, -1, -1 },
+                {  4,  5, 10,  4, 10, 11,  4, 11,  3,  4,  3,  0, -1, -1, -1, -1 },
+                {  4,  5, 10,  4, 10, 11,  4, 11,  8, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  8,  7,  9,  7,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  5,  0,  5,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  7,  5,  8,  5,  1,  8,  1,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  7,  1,  7,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  2,  1,  9,  8,  7,  9,  7,  5, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  5,  0,  5,  9, 10,  2,  1, -1, -1, -1, -1 },
+                {  8,  7,  5,  8,  5, 10,  8, 10,  2,  8,  2,  0, -1, -1, -1, -1 },
+                {  2,  3,  7,  2,  7,  5,  2,  5, 10, -1, -1, -1, -1, -1, -1, -1 },
+                { 11,  3,  2,  9,  8,  7,  9,  7,  5, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  7,  0,  7,  5,  0,  5,  9, -1, -1, -1, -1 },
+                {  8,  7,  5,  8,  5,  1,  8,  1,  0, 11,  3,  2, -1, -1, -1, -1 },
+                {  1,  2, 11,  1, 11,  7,  1,  7,  5, -1, -1, -1, -1, -1, -1, -1 },
+                { 10, 11,  3, 10,  3,  1,  9,  8,  7,  9,  7,  5, -1, -1, -1, -1 },
+                {  0,  1, 10,  0, 10, 11,  0, 11,  7,  0,  7,  5,  0,  5,  9, -1 },
+                {  8,  7,  5,  8,  5, 10,  8, 10, 11,  8, 11,  3,  8,  3,  0, -1 },
+                { 10, 11,  7, 10,  7,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  5,  6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  9,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  5,  6,  2,  5,  2,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  5,  6,  2,  5,  2,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  5,  6,  9,  6,  2,  9,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  9,  2,  9,  5,  2,  5,  6, -1, -1, -1, -1 },
+                { 11,  3,  2,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  8,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0, 11,  3,  2,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  2, 11,  1, 11,  8,  1,  8,  9,  5,  6, 10, -1, -1, -1, -1 },
+                {  5,  6, 11,  5, 11,  3,  5,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1,  5,  0,  5,  6,  0,  6, 11,  0, 11,  8, -1, -1, -1, -1 },
+                {  9,  5,  6,  9,  6, 11,  9, 11,  3,  9,  3,  0, -1, -1, -1, -1 },
+                {  5,  6, 11,  5, 11,  8,  5,  8,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  7,  4,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  4,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  8,  7,  4,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  7,  1,  7,  4,  1,  4,  9,  5,  6, 10, -1, -1, -1, -1 },
+                {  5,  6,  2,  5,  2,  1,  8,  7,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  4,  5,  6,  2,  5,  2,  1, -1, -1, -1, -1 },
+                {  9,  5,  6,  9,  6,  2,  9,  2,  0,  8,  7,  4, -1, -1, -1, -1 },
+                {  2,  3,  7,  2,  7,  4,  2,  4,  9,  2,  9,  5,  2,  5,  6, -1 },
+                { 11,  3,  2,  8,  7,  4,  5,  6, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  7,  0,  7,  4,  5,  6, 10, -1, -1, -1, -1 },
+                {  9,  1,  0, 11,  3,  2,  8,  7,  4,  5,  6, 10, -1, -1, -1, -1 },
+                {  1,  2, 11,  1, 11,  7,  1,  7,  4,  1,  4,  9,  5,  6, 10, -1 },
+                {  5,  6, 11,  5, 11,  3,  5,  3,  1,  8,  7,  4, -1, -1, -1, -1 },
+                {  0,  1,  5,  0,  5,  6,  0,  6, 11,  0, 11,  7,  0,  7,  4, -1 },
+                {  9,  5,  6,  9,  6, 11,  9, 11,  3,  9,  3,  0,  8,  7,  4, -1 },
+                {  9,  5,  6,  9,  6, 11,  9, 11,  7,  9,  7,  4, -1, -1, -1, -1 },
+                {  4,  6, 10,  4, 10,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  4,  6, 10,  4, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  6, 10,  4, 10,  1,  4,  1,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  4,  1,  4,  6,  1,  6, 10, -1, -1, -1, -1 },
+                {  9,  4,  6,  9,  6,  2,  9,  2,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  9,  4,  6,  9,  6,  2,  9,  2,  1, -1, -1, -1, -1 },
+                {  4,  6,  2,  4,  2,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  4,  2,  4,  6, -1, -1, -1, -1, -1, -1, -1 },
+                { 11,  3,  2,  4,  6, 10,  4, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  8,  4,  6, 10,  4, 10,  9, -1, -1, -1, -1 },
+                {  4,  6, 10,  4, 10,  1,  4,  1,  0, 11,  3,  2, -1, -1, -1, -1 },
+                {  1,  2, 11,  1, 11,  8,  1,  8,  4,  1,  4,  6,  1,  6, 10, -1 },
+                {  9,  4,  6,  9,  6, 11,  9, 11,  3,  9,  3,  1, -1, -1, -1, -1 },
+                {  0,  1,  9,  0,  9,  4,  0,  4,  6,  0,  6, 11,  0, 11,  8, -1 },
+                {  4,  6, 11,  4, 11,  3,  4,  3,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  6, 11,  4, 11,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  9,  8, 10,  8,  7, 10,  7,  6, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  6,  0,  6, 10,  0, 10,  9, -1, -1, -1, -1 },
+                {  8,  7,  6,  8,  6, 10,  8, 10,  1,  8,  1,  0, -1, -1, -1, -1 },
+                {  1,  3,  7,  1,  7,  6,  1,  6, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  8,  7,  9,  7,  6,  9,  6,  2,  9,  2,  1, -1, -1, -1, -1 },
+                {  0,  3,  7,  0,  7,  6,  0,  6,  2,  0,  2,  1,  0,  1,  9, -1 },
+                {  8,  7,  6,  8,  6,  2,  8,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  7,  2,  7,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 11,  3,  2, 10,  9,  8, 10,  8,  7, 10,  7,  6, -1, -1, -1, -1 },
+                {  0,  2, 11,  0, 11,  7,  0,  7,  6,  0,  6, 10,  0, 10,  9, -1 },
+                {  8,  7,  6,  8,  6, 10,  8, 10,  1,  8,  1,  0, 11,  3,  2, -1 },
+                {  1,  2, 11,  1, 11,  7,  1,  7,  6,  1,  6, 10, -1, -1, -1, -1 },
+                {  9,  8,  7,  9,  7,  6,  9,  6, 11,  9, 11,  3,  9,  3,  1, -1 },
+                {  0,  1,  9, 11,  7,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  7,  6,  8,  6, 11,  8, 11,  3,  8,  3,  0, -1, -1, -1, -1 },
+                { 11,  7,  6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  6,  7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  9,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  2,  1,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8, 10,  2,  1,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1 },
+                {  9, 10,  2,  9,  2,  0,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  9,  2,  9, 10,  6,  7, 11, -1, -1, -1, -1 },
+                {  6,  7,  3,  6,  3,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2,  6,  0,  6,  7,  0,  7,  8, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  6,  7,  3,  6,  3,  2, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  2,  6,  1,  6,  7,  1,  7,  8,  1,  8,  9, -1, -1, -1, -1 },
+                { 10,  6,  7, 10,  7,  3, 10,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1, 10,  0, 10,  6,  0,  6,  7,  0,  7,  8, -1, -1, -1, -1 },
+                {  9, 10,  6,  9,  6,  7,  9,  7,  3,  9,  3,  0, -1, -1, -1, -1 },
+                {  6,  7,  8,  6,  8,  9,  6,  9, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  8, 11,  6,  8,  6,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11,  6,  0,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  8, 11,  6,  8,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3, 11,  1, 11,  6,  1,  6,  4,  1,  4,  9, -1, -1, -1, -1 },
+                { 10,  2,  1,  8, 11,  6,  8,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11,  6,  0,  6,  4, 10,  2,  1, -1, -1, -1, -1 },
+                {  9, 10,  2,  9,  2,  0,  8, 11,  6,  8,  6,  4, -1, -1, -1, -1 },
+                {  2,  3, 11,  2, 11,  6,  2,  6,  4,  2,  4,  9,  2,  9, 10, -1 },
+                {  6,  4,  8,  6,  8,  3,  6,  3,  2, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2,  6,  0,  6,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  6,  4,  8,  6,  8,  3,  6,  3,  2, -1, -1, -1, -1 },
+                {  1,  2,  6,  1,  6,  4,  1,  4,  9, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  6,  4, 10,  4,  8, 10,  8,  3, 10,  3,  1, -1, -1, -1, -1 },
+                {  0,  1, 10,  0, 10,  6,  0,  6,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  9, 10,  6,  9,  6,  4,  9,  4,  8,  9,  8,  3,  9,  3,  0, -1 },
+                {  9, 10,  6,  9,  6,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  5,  9,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  4,  5,  9,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  5,  1,  4,  1,  0,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  4,  1,  4,  5,  6,  7, 11, -1, -1, -1, -1 },
+                { 10,  2,  1,  4,  5,  9,  6,  7, 11, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8, 10,  2,  1,  4,  5,  9,  6,  7, 11, -1, -1, -1, -1 },
+                {  4,  5, 10,  4, 10,  2,  4,  2,  0,  6,  7, 11, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  4,  2,  4,  5,  2,  5, 10,  6,  7, 11, -1 },
+                {  6,  7,  3,  6,  3,  2,  4,  5,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2,  6,  0,  6,  7,  0,  7,  8,  4,  5,  9, -1, -1, -1, -1 },
+                {  4,  5,  1,  4,  1,  0,  6,  7,  3,  6,  3,  2, -1, -1, -1, -1 },
+                {  1,  2,  6,  1,  6,  7,  1,  7,  8,  1,  8,  4,  1,  4,  5, -1 },
+                { 10,  6,  7, 10,  7,  3, 10,  3,  1,  4,  5,  9, -1, -1, -1, -1 },
+                {  0,  1, 10,  0, 10,  6,  0,  6,  7,  0,  7,  8,  4,  5,  9, -1 },
+                {  4,  5, 10,  4, 10,  6,  4,  6,  7,  4,  7,  3,  4,  3,  0, -1 },
+                {  4,  5, 10,  4, 10,  6,  4,  6,  7,  4,  7,  8, -1, -1, -1, -1 },
+                {  9,  8, 11,  9, 11,  6,  9,  6,  5, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11,  6,  0,  6,  5,  0,  5,  9, -1, -1, -1, -1 },
+                {  8, 11,  6,  8,  6,  5,  8,  5,  1,  8,  1,  0, -1, -1, -1, -1 },
+                {  1,  3, 11,  1, 11,  6,  1,  6,  5, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  2,  1,  9,  8, 11,  9, 11,  6,  9,  6,  5, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11,  6,  0,  6,  5,  0,  5,  9, 10,  2,  1, -1 },
+                {  8, 11,  6,  8,  6,  5,  8,  5, 10,  8, 10,  2,  8,  2,  0, -1 },
+                {  2,  3, 11,  2, 11,  6,  2,  6,  5,  2,  5, 10, -1, -1, -1, -1 },
+                {  6,  5,  9,  6,  9,  8,  6,  8,  3,  6,  3,  2, -1, -1, -1, -1 },
+                {  0,  2,  6,  0,  6,  5,  0,  5,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  3,  2,  8,  2,  6,  8,  6,  5,  8,  5,  1,  8,  1,  0, -1 },
+                {  1,  2,  6,  1,  6,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  6,  5, 10,  5,  9, 10,  9,  8, 10,  8,  3, 10,  3,  1, -1 },
+                {  0,  1, 10,  0, 10,  6,  0,  6,  5,  0,  5,  9, -1, -1, -1, -1 },
+                {  8,  3,  0, 10,  6,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  6,  5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  5,  7, 11,  5, 11, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  5,  7, 11,  5, 11, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0,  5,  7, 11,  5, 11, 10, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  9,  5,  7, 11,  5, 11, 10, -1, -1, -1, -1 },
+                {  5,  7, 11,  5, 11,  2,  5,  2,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  5,  7, 11,  5, 11,  2,  5,  2,  1, -1, -1, -1, -1 },
+                {  9,  5,  7,  9,  7, 11,  9, 11,  2,  9,  2,  0, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  9,  2,  9,  5,  2,  5,  7,  2,  7, 11, -1 },
+                { 10,  5,  7, 10,  7,  3, 10,  3,  2, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 10,  0, 10,  5,  0,  5,  7,  0,  7,  8, -1, -1, -1, -1 },
+                {  9,  1,  0, 10,  5,  7, 10,  7,  3, 10,  3,  2, -1, -1, -1, -1 },
+                {  1,  2, 10,  1, 10,  5,  1,  5,  7,  1,  7,  8,  1,  8,  9, -1 },
+                {  5,  7,  3,  5,  3,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1,  5,  0,  5,  7,  0,  7,  8, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  5,  7,  9,  7,  3,  9,  3,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  5,  7,  8,  5,  8,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  8, 11, 10,  8, 10,  5,  8,  5,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11, 10,  0, 10,  5,  0,  5,  4, -1, -1, -1, -1 },
+                {  9,  1,  0,  8, 11, 10,  8, 10,  5,  8,  5,  4, -1, -1, -1, -1 },
+                {  1,  3, 11,  1, 11, 10,  1, 10,  5,  1,  5,  4,  1,  4,  9, -1 },
+                {  5,  4,  8,  5,  8, 11,  5, 11,  2,  5,  2,  1, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11,  2,  0,  2,  1,  0,  1,  5,  0,  5,  4, -1 },
+                {  9,  5,  4,  9,  4,  8,  9,  8, 11,  9, 11,  2,  9,  2,  0, -1 },
+                {  2,  3, 11,  9,  5,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  5,  4, 10,  4,  8, 10,  8,  3, 10,  3,  2, -1, -1, -1, -1 },
+                {  0,  2, 10,  0, 10,  5,  0,  5,  4, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  1,  0, 10,  5,  4, 10,  4,  8, 10,  8,  3, 10,  3,  2, -1 },
+                {  1,  2, 10,  1, 10,  5,  1,  5,  4,  1,  4,  9, -1, -1, -1, -1 },
+                {  5,  4,  8,  5,  8,  3,  5,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1,  5,  0,  5,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  5,  4,  9,  4,  8,  9,  8,  3,  9,  3,  0, -1, -1, -1, -1 },
+                {  9,  5,  4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  7, 11,  4, 11, 10,  4, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3,  8,  4,  7, 11,  4, 11, 10,  4, 10,  9, -1, -1, -1, -1 },
+                {  4,  7, 11,  4, 11, 10,  4, 10,  1,  4,  1,  0, -1, -1, -1, -1 },
+                {  1,  3,  8,  1,  8,  4,  1,  4,  7,  1,  7, 11,  1, 11, 10, -1 },
+                {  9,  4,  7,  9,  7, 11,  9, 11,  2,  9,  2,  1, -1, -1, -1, -1 },
+                {  0,  3,  8,  9,  4,  7,  9,  7, 11,  9, 11,  2,  9,  2,  1, -1 },
+                {  4,  7, 11,  4, 11,  2,  4,  2,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3,  8,  2,  8,  4,  2,  4,  7,  2,  7, 11, -1, -1, -1, -1 },
+                { 10,  9,  4, 10,  4,  7, 10,  7,  3, 10,  3,  2, -1, -1, -1, -1 },
+                {  0,  2, 10,  0, 10,  9,  0,  9,  4,  0,  4,  7,  0,  7,  8, -1 },
+                {  4,  7,  3,  4,  3,  2,  4,  2, 10,  4, 10,  1,  4,  1,  0, -1 },
+                {  1,  2, 10,  4,  7,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  4,  7,  9,  7,  3,  9,  3,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1,  9,  0,  9,  4,  0,  4,  7,  0,  7,  8, -1, -1, -1, -1 },
+                {  4,  7,  3,  4,  3,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  4,  7,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 11, 10,  9, 11,  9,  8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11, 10,  0, 10,  9, -1, -1, -1, -1, -1, -1, -1 },
+                {  8, 11, 10,  8, 10,  1,  8,  1,  0, -1, -1, -1, -1, -1, -1, -1 },
+                {  1,  3, 11,  1, 11, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  8, 11,  9, 11,  2,  9,  2,  1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  3, 11,  0, 11,  2,  0,  2,  1,  0,  1,  9, -1, -1, -1, -1 },
+                {  8, 11,  2,  8,  2,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  2,  3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { 10,  9,  8, 10,  8,  3, 10,  3,  2, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  2, 10,  0, 10,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  3,  2,  8,  2, 10,  8, 10,  1,  8,  1,  0, -1, -1, -1, -1 },
+                {  1,  2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  9,  8,  3,  9,  3,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  0,  1,  9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                {  8,  3,  0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+                { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }
+        };
+
+        /**
+         * Each cube edge as the voxel it starts at (offset to the cube origin) and its axis (0 = x, 1 = y, 2 = z).
+         */
+        static const size_t s_edgeVoxel[ 12 ][ 4 ] =
+        {
+            { 0, 0, 0, 0 }, { 1, 0, 0, 1 }, { 0, 1, 0, 0 }, { 0, 0, 0, 1 },
+            { 0, 0, 1, 0 }, { 1, 0, 1, 1 }, { 0, 1, 1, 0 }, { 0, 0, 1, 1 },
+            { 0, 0, 0, 2 }, { 1, 0, 0, 2 }, { 1, 1, 0, 2 }, { 0, 1, 0, 2 }
+        };
+
+        /**
+         * The offsets of the 8 cube corners relative to the cube origin.
+         */
+        static const size_t s_cornerOffset[ 8 ][ 3 ] =
+        {
+            { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 },
+            { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 }
+        };
+
+        /**
+         * Marks an edge without vertex in the edge cache.
+         */
+        static const uint32_t s_noVertex = std::numeric_limits< uint32_t >::max();
+
+        /**
+         * The part of the volume handled by one thread. A slab owns the voxel layers [zBegin, zEnd) and therefore all edges starting in these
+         * layers. It triangulates the cells starting in these layers.
+         */
+        struct IsosurfaceSlab
+        {
+            /**
+             * First voxel layer.
+             */
+            size_t zBegin = 0;
+
+            /**
+             * The layer after the last one.
+             */
+            size_t zEnd = 0;
+
+            /**
+             * Edge cache. Three entries per voxel (x, y, z edge) with the slab-local vertex index or s_noVertex.
+             */
+            std::vector< uint32_t > edgeCache;
+
+            /**
+             * The vertices on the edges owned by this slab.
+             */
+            Vec3Array vertices;
+
+            /**
+             * The normals of these vertices.
+             */
+            NormalArray normals;
+
+            /**
+             * The triangles of the cells of this slab. Uses global vertex indices.
+             */
+            IndexVec3Array triangles;
+
+            /**
+             * Index of the first vertex of this slab in the final mesh.
+             */
+            size_t vertexOffset = 0;
+
+            /**
+             * Index of the first triangle of this slab in the final mesh.
+             */
+            size_t triangleOffset = 0;
+        };
+
+        ExtractIsosurface::ExtractIsosurface():
+            Algorithm( "Extract Isosurface",
+                       "Extract a triangle mesh of the surface where the input data equals the iso value (marching cubes)." )
+        {
+            // 1: the output
+            m_dataOutput = addOutput< di::core::TriangleDataSet >(
+                    "Isosurface",
+                    "The surface as triangle mesh."
+            );
+
+            // 2: the input
+            m_dataInput = std::make_shared< di::core::VolumeConnector< double > >(
+                    "Input",
+                    "The data to process. Volumes of other value types are converted."
+            );
+            addInput( m_dataInput );
+
+            m_isoValue = addParameter< double >(
+                    "Iso Value",
+                    "The surface is placed where the data equals this value.",
+                    0.5
+            );
+            m_isoValue->setRangeHint( 0.0, 1.0 );
+
+            m_color = addParameter< di::Color >(
+                    "Color",
+                    "The color of the surface.",
+                    di::Color( 1.0, 1.0, 1.0, 1.0 )
+            );
+        }
+
+        ExtractIsosurface::~ExtractIsosurface()
+        {
+            // nothing to clean up so far
+        }
+
+        /**
+         * Calculate the gradient of the data at the given voxel in grid-space. Uses central differences and one-sided differences at the border.
+         *
+         * \tparam ValueArrayType the value array type
+         * \param values the data
+         * \param sizes the grid size
+         * \param x x coordinate
+         * \param y y coordinate
+         * \param z z coordinate
+         *
+         * \return the gradient
+         */
+        template< typename ValueArrayType >
+        glm::dvec3 gradientAt( const ValueArrayType& values, const std::array< size_t, 3 >& sizes, size_t x, size_t y, size_t z )
+        {
+            // NOTE: the linear index is calculated directly as GridRegular::index is recursive and checks its arguments.
+            auto at = [ & ]( size_t px, size_t py, size_t pz )
+            {
+                return static_cast< double >( values[ px + sizes[ 0 ] * ( py + sizes[ 1 ] * pz ) ] );
+            };
+
+            size_t xl = ( x > 0 ) ? x - 1 : x;
+            size_t yl = ( y > 0 ) ? y - 1 : y;
+            size_t zl = ( z > 0 ) ? z - 1 : z;
+            size_t xh = std::min( x + 1, sizes[ 0 ] - 1 );
+            size_t yh = std::min( y + 1, sizes[ 1 ] - 1 );
+            size_t zh = std::min( z + 1, sizes[ 2 ] - 1 );
+
+            return glm::dvec3( ( at( xh, y, z ) - at( xl, y, z ) ) / static_cast< double >( xh - xl ),
+                               ( at( x, yh, z ) - at( x, yl, z ) ) / static_cast< double >( yh - yl ),
+                               ( at( x, y, zh ) - at( x, y, zl ) ) / static_cast< double >( zh - zl ) );
+        }
+
+        void ExtractIsosurface::process( const di::core::CancellationToken& token )
+        {
+            // Get input data
+            auto inputData = m_dataInput->getData();
+            if( !inputData )
+            {
+                return;
+            }
+
+            const auto& values = *inputData->getAttributes< 0 >();
+            auto grid = inputData->getGrid();
+            const auto& transform = grid->getTransformation();
+
+            std::array< size_t, 3 > sizes = { { grid->getSizeX(), grid->getSizeY(), grid->getSizeZ() } };
+            const size_t sx = sizes[ 0 ];
+            const size_t sy = sizes[ 1 ];
+            const size_t sz = sizes[ 2 ];
+            if( ( sx < 2 ) || ( sy < 2 ) || ( sz < 2 ) )
+            {
+                LogW << "The grid needs at least two voxels in each direction. Ignoring." << LogEnd;
+                return;
+            }
+
+            const double iso = m_isoValue->get();
+            auto at = [ & ]( size_t x, size_t y, size_t z )
+            {
+                return static_cast< double >( values[ x + sx * ( y + sy * z ) ] );
+            };
+
+            // Normals are gradients. Bring them to world-space using the transposed linear part of the world-to-grid transformation.
+            const glm::dmat3 gradientToWorld = glm::transpose( glm::dmat3( transform.getMatrix() ) );
+
+            // Split the volume into slabs of voxel layers.
+            const size_t numSlabs = std::min( di::core::getNumberOfThreads(), sz );
+            std::vector< IsosurfaceSlab > slabs( numSlabs );
+            for( size_t s = 0; s < numSlabs; ++s )
+            {
+                slabs[ s ].zBegin = ( s * sz ) / numSlabs;
+                slabs[ s ].zEnd = ( ( s + 1 ) * sz ) / numSlabs;
+            }
+
+            // Pass 1: create a vertex on each edge crossing the iso value and remember it in the edge cache of the slab owning the edge.
+            di::core::parallelFor( 0, numSlabs, [ & ]( size_t first, size_t last, size_t /* chunk */ )
+            {
+                for( size_t s = first; s < last; ++s )
+                {
+                    token.throwIfCancelled();
+                    auto& slab = slabs[ s ];
+                    slab.edgeCache.assign( 3 * sx * sy * ( slab.zEnd - slab.zBegin ), s_noVertex );
+
+                    for( size_t z = slab.zBegin; z < slab.zEnd; ++z )
+                    {
+                        for( size_t y = 0; y < sy; ++y )
+                        {
+                            for( size_t x = 0; x < sx; ++x )
+                            {
+                                const double v0 = at( x, y, z );
+                                const bool inside0 = ( v0 >= iso );
+                                for( size_t axis = 0; axis < 3; ++axis )
+                                {
+                                    const size_t nx = x + ( ( axis == 0 ) ? 1 : 0 );
+                                    const size_t ny = y + ( ( axis == 1 ) ? 1 : 0 );
+                                    const size_t nz = z + ( ( axis == 2 ) ? 1 : 0 );
+                                    if( ( nx >= sx ) || ( ny >= sy ) || ( nz >= sz ) )
+                                    {
+                                        continue;
+                                    }
+
+                                    const double v1 = at( nx, ny, nz );
+                                    if( ( v1 >= iso ) == inside0 )
+                                    {
+                                        continue;
+                                    }
+
+                                    // NOTE: v0 != v1 as exactly one of them is below iso.
+                                    const double t = ( iso - v0 ) / ( v1 - v0 );
+                                    const glm::dvec3 p0( x, y, z );
+                                    const glm::dvec3 p1( nx, ny, nz );
+                                    const auto gradient = glm::mix( gradientAt( values, sizes, x, y, z ),
+                                                                    gradientAt( values, sizes, nx, ny, nz ), t );
+
+                                    // Normals point towards lower values.
+                                    auto normal = -( gradientToWorld * gradient );
+                                    const double len = glm::length( normal );
+                                    normal = ( len > 0.0 ) ? normal / len : glm::dvec3( 0.0, 0.0, 1.0 );
+
+                                    slab.edgeCache[ 3 * ( x + sx * ( y + sy * ( z - slab.zBegin ) ) ) + axis ] =
+                                        static_cast< uint32_t >( slab.vertices.size() );
+                                    slab.vertices.push_back( transform.toWorld( glm::vec3( glm::mix( p0, p1, t ) ) ) );
+                                    slab.normals.push_back( glm::vec3( normal ) );
+                                }
+                            }
+                        }
+                    }
+                }
+            } );
+
+            // The vertices of all slabs get concatenated. Calculate offsets.
+            size_t numVertices = 0;
+            for( auto& slab : slabs )
+            {
+                slab.vertexOffset = numVertices;
+                numVertices += slab.vertices.size();
+            }
+
+            // Pass 2: triangulate each cell. The edges of the top layer of a slab's last cell layer belong to the next slab.
+            di::core::parallelFor( 0, numSlabs, [ & ]( size_t first, size_t last, size_t /* chunk */ )
+            {
+                for( size_t s = first; s < last; ++s )
+                {
+                    token.throwIfCancelled();
+                    auto& slab = slabs[ s ];
+                    auto vertexOf = [ & ]( size_t x, size_t y, size_t z, int edge )
+                    {
+                        const size_t* e = s_edgeVoxel[ edge ];
+                        const size_t ez = z + e[ 2 ];
+                        const auto& owner = ( ez < slab.zEnd ) ? slab : slabs[ s + 1 ];
+                        const size_t local = owner.edgeCache[ 3 * ( ( x + e[ 0 ] ) + sx * ( ( y + e[ 1 ] ) + sy * ( ez - owner.zBegin ) ) ) + e[ 3 ] ];
+                        return static_cast< int >( owner.vertexOffset + local );
+                    };
+
+                    for( size_t z = slab.zBegin; z < std::min( slab.zEnd, sz - 1 ); ++z )
+                    {
+                        for( size_t y = 0; y < sy - 1; ++y )
+                        {
+                            for( size_t x = 0; x < sx - 1; ++x )
+                            {
+                                size_t caseIndex = 0;
+                                for( size_t corner = 0; corner < 8; ++corner )
+                                {
+                                    const size_t* c = s_cornerOffset[ corner ];
+                                    caseIndex |= ( at( x + c[ 0 ], y + c[ 1 ], z + c[ 2 ] ) >= iso ) ? ( 1 << corner ) : 0;
+                                }
+
+                                if( s_edgeTable[ caseIndex ] == 0 )
+                                {
+                                    continue;
+                                }
+
+                                const int* tris = s_triangleTable[ caseIndex ];
+                                for( size_t i = 0; tris[ i ] != -1; i += 3 )
+                                {
+                                    slab.triangles.push_back( glm::ivec3( vertexOf( x, y, z, tris[ i ] ),
+                                                                          vertexOf( x, y, z, tris[ i + 1 ] ),
+                                                                          vertexOf( x, y, z, tris[ i + 2 ] ) ) );
+                                }
+                            }
+                        }
+                    }
+                }
+            } );
+
+            size_t numTriangles = 0;
+            for( auto& slab : slabs )
+            {
+                slab.triangleOffset = numTriangles;
+                numTriangles += slab.triangles.size();
+            }
+
+            // Stitch the slabs together.
+            Vec3Array vertices( numVertices );
+            NormalArray normals( numVertices );
+            IndexVec3Array triangles( numTriangles );
+            di::core::parallelFor( 0, numSlabs, [ & ]( size_t first, size_t last, size_t /* chunk */ )
+            {
+                for( size_t s = first; s < last; ++s )
+                {
+                    token.throwIfCancelled();
+                    auto& slab = slabs[ s ];
+                    std::copy( slab.vertices.begin(), slab.vertices.end(), vertices.begin() + slab.vertexOffset );
+                    std::copy( slab.normals.begin(), slab.normals.end(), normals.begin() + slab.vertexOffset );
+                    std::copy( slab.triangles.begin(), slab.triangles.end(), triangles.begin() + slab.triangleOffset );
+                }
+            } );
+            slabs.clear();
+
+            LogD << "Extracted isosurface at " << iso << " with " << numVertices << " vertices and " << numTriangles << " triangles." << LogEnd;
+
+            auto mesh = std::make_shared< di::core::TriangleMesh >();
+            mesh->setVertices( std::move( vertices ) );
+            mesh->setNormals( std::move( normals ) );
+            mesh->setTriangles( std::move( triangles ) );
+            mesh->calculateInverseIndex();
+
+            auto colors = std::make_shared< RGBAArray >( numVertices, m_color->get() );
+
+            // Construct result dataset:
+            m_dataOutput->setData( std::make_shared< di::core::TriangleDataSet >( "Isosurface", mesh, colors ) );
+        }
+    }
+}
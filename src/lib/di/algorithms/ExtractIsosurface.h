@@ -0,0 +1,88 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#ifndef DI_EXTRACTISOSURFACE_H
+#define DI_EXTRACTISOSURFACE_H
+
+#include <di/core/Algorithm.h>
+#include <di/core/ParameterTypes.h>
+#include <di/core/data/DataSetTypes.h>
+
+namespace di
+{
+    namespace algorithms
+    {
+        /**
+         * Extract an isosurface from the given scalar volume using marching cubes. The volume is split into Z-slabs that are processed in parallel.
+         * Vertices on cell edges are shared between cells (and slabs) using per-slab edge caches, so the resulting mesh is connected and its
+         * normals are smooth. Normals are derived from the scalar gradient and point towards lower values. The inverse index of the mesh is built
+         * before it is handed out.
+         */
+        class ExtractIsosurface: public di::core::Algorithm
+        {
+        public:
+            /**
+             * Constructor. Initialize all inputs, outputs and parameters.
+             */
+            ExtractIsosurface();
+
+            /**
+             * Destructor. Clean up if needed.
+             */
+            virtual ~ExtractIsosurface();
+
+            /**
+             * Extract the surface.
+             *
+             * \param token cancellation token of this run
+             */
+            virtual void process( const di::core::CancellationToken& token );
+        protected:
+        private:
+            /**
+             * The scalar input to use.
+             */
+            SPtr< di::core::Connector< di::core::DataSetScalarRegular3d > > m_dataInput;
+
+            /**
+             * The resulting surface.
+             */
+            SPtr< di::core::Connector< di::core::TriangleDataSet > > m_dataOutput;
+
+            /**
+             * The iso value to extract.
+             */
+            core::ParamDouble m_isoValue;
+
+            /**
+             * The color of the surface.
+             */
+            core::ParamColor m_color;
+        };
+    }
+}
+
+#endif  // DI_EXTRACTISOSURFACE_H
+
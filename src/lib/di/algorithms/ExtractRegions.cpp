@@ -66,6 +66,11 @@ namespace di
                     "Extracted continuous directions on the mesh."
             );
 
+            m_annotatedVectorOutput = addOutput< di::core::TriangleAnnotatedVectorField >(
+                    "Annotated Directionality",
+                    "Extracted directions along with the colors and labels of the mesh. Useful to export the results."
+            );
+
             // 2: the input
             m_dataInput = addInput< di::core::TriangleDataSet >(
                     "Triangle Mesh",
@@ -115,7 +120,7 @@ namespace di
             }
         }
 
-        void ExtractRegions::process()
+        void ExtractRegions::process( const di::core::CancellationToken& token )
         {
             // Get input data
             auto triangleDataSet = m_dataInput->getData();
@@ -126,6 +131,16 @@ namespace di
                 return;
             }
 
+            // Wait for the complete mesh. Extracting regions from a preview is expensive and gets replaced soon anyway. The results of the previous
+            // mesh do not match the preview. Remove them to avoid rendering or exporting them along with the preview.
+            if( triangleDataSet->isPreview() )
+            {
+                LogD << "Ignoring mesh preview. Resetting previous results." << LogEnd;
+                m_vectorOutput->setData( nullptr );
+                m_annotatedVectorOutput->setData( nullptr );
+                return;
+            }
+
             auto triangles = triangleDataSet->getGrid();
             auto attribute = triangleDataSet->getAttributes< 0 >(); // the color in our case
             auto labels = triangleLabelDataSet->getAttributes< 0 >();
@@ -170,6 +185,7 @@ namespace di
                 // This case is mostly trivial. Calculate a direction for each vertex of the mesh:
                 for( size_t vertexID = 0; vertexID < triangles->getNumVertices(); ++vertexID )
                 {
+                    token.throwIfCancelled();
                     // Get neighbours
                     auto neighbours = triangles->getNeighbourVertices( vertexID );
 
@@ -214,6 +230,9 @@ namespace di
                 // Update outputs
                 LogD << "Done. Updating output." << LogEnd;
                 m_vectorOutput->setData( std::make_shared< di::core::TriangleVectorField >( "Directionality", triangles, vectorAttribute ) );
+                m_annotatedVectorOutput->setData( std::make_shared< di::core::TriangleAnnotatedVectorField >(
+                    "Annotated Directionality", triangles, vectorAttribute, triangleDataSet->getAttributes< 0 >(),
+                    triangleLabelDataSet->getAttributes< 0 >() ) );
 
                 // Case 1 finished. Stop here.
                 return;
@@ -251,6 +270,7 @@ namespace di
             size_t regionVertexCount = 0; // keep track of how many vertices where associated
             for( size_t vertID = 0; vertID < triangles->getNumVertices(); ++vertID )
             {
+                token.throwIfCancelled();
                 // already visited?
                 if( !visited[ vertID ] )
                 {
@@ -386,6 +406,7 @@ namespace di
             // Iterate all vertices, decide for directionality if it is a border vertex
             for( size_t vertexID = 0; vertexID < triangles->getNumVertices(); ++vertexID )
             {
+                token.throwIfCancelled();
                 if( vertexIgnore.at( vertexID ) )
                 {
                     continue;
@@ -467,6 +488,9 @@ namespace di
             bool keepRunning = true;
             while( keepRunning )
             {
+                // The spreading can take many iterations. Stop as soon as the result is outdated.
+                token.throwIfCancelled();
+
                 auto nowSet = vectorAttributeSet;
 
                 // Iterate all vertices
@@ -618,6 +642,9 @@ namespace di
             // Update outputs
             LogD << "Done. Updating output." << LogEnd;
             m_vectorOutput->setData( std::make_shared< di::core::TriangleVectorField >( "Directionality", triangles, vectorAttribute ) );
+            m_annotatedVectorOutput->setData( std::make_shared< di::core::TriangleAnnotatedVectorField >(
+                "Annotated Directionality", triangles, vectorAttribute, triangleDataSet->getAttributes< 0 >(),
+                triangleLabelDataSet->getAttributes< 0 >() ) );
         }
     }
 }
@@ -56,8 +56,10 @@ namespace di
 
             /**
              * Does nothing in this case, besides setting the injection data.
+             *
+             * \param token cancellation token of this run
              */
-            virtual void process();
+            virtual void process( const di::core::CancellationToken& token );
 
             /**
              * Associate each region with its neighbours. The size_t is the region index.
@@ -102,6 +104,11 @@ namespace di
              */
             SPtr< di::core::Connector< di::core::TriangleVectorField > > m_vectorOutput;
 
+            /**
+             * The vectors along with the colors and labels they were computed from. Used for exporting the results.
+             */
+            SPtr< di::core::Connector< di::core::TriangleAnnotatedVectorField > > m_annotatedVectorOutput;
+
             /**
              * The triangle mesh input to use.
              */
@@ -22,11 +22,15 @@
 //
 //---------------------------------------------------------------------------------------
 
-#include <fstream>
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <utility>
 
+#include <di/core/VolumeConnector.h>
+#include <di/core/data/SlabStreaming.h>
+#include <di/core/data/ValueConversion.h>
+
 #include "GaussSmooth.h"
 
 #include <di/core/Logger.h>
@@ -36,94 +40,172 @@ namespace di
 {
     namespace algorithms
     {
-        GaussSmooth::GaussSmooth():
+        template< typename ValueT >
+        GaussSmooth< ValueT >::GaussSmooth():
             Algorithm( "Gauss Smooth",
                        "Apply a Gaussian filter to the input data." )
         {
             // 1: the output
-            m_dataOutput = addOutput< di::core::DataSetScalarRegular3d >(
+            m_dataOutput = addOutput< di::core::DataSetScalarRegular3< ValueT > >(
                     "Gaussed",
                     "The Gaussed input data."
             );
 
             // 2: the input
-            m_dataInput = addInput< di::core::DataSetScalarRegular3d >(
+            m_dataInput = std::make_shared< di::core::VolumeConnector< ValueT > >(
                     "Input",
-                    "The data to process."
+                    "The data to process. Volumes of other value types are converted."
             );
+            addInput( m_dataInput );
         }
 
-        GaussSmooth::~GaussSmooth()
+        template< typename ValueT >
+        GaussSmooth< ValueT >::~GaussSmooth()
         {
             // nothing to clean up so far
         }
 
-        template< typename ValueT, typename GridT >
-        void filterField1D( SPtr< ValueT > values, const ValueT& valuesIn, SPtr< GridT > grid,
-                                                     size_t dx, size_t dy, size_t dz )
+        /**
+         * Apply the 1D Gauss kernel in X and then in Y direction to a single Z layer. Only inner voxels are filtered. All others are 0. This
+         * matches the behaviour of filtering the whole volume in X and Y direction.
+         *
+         * \tparam ValueArrayT the type of the input values
+         * \param valuesIn the input volume
+         * \param grid the grid
+         * \param z the layer to filter
+         * \param tmp temporary storage for one layer
+         * \param layer the resulting layer
+         */
+        template< typename ValueArrayT >
+        void filterLayerXY( const ValueArrayT& valuesIn, const core::GridRegular3& grid, size_t z,
+                            std::vector< double >& tmp, std::vector< double >& layer )
         {
-            for( size_t z = 1; z < grid->getSizeZ() - 1; ++z )
+            size_t sizeX = grid.getSizeX();
+            size_t sizeY = grid.getSizeY();
+
+            std::fill( layer.begin(), layer.end(), 0.0 );
+            if( ( z == 0 ) || ( z + 1 >= grid.getSizeZ() ) )
+            {
+                return;
+            }
+
+            // Linear index is x + sizeX * ( y + sizeY * z )
+            const auto* in = valuesIn.data() + z * sizeX * sizeY;
+
+            // run in X direction
+            std::fill( tmp.begin(), tmp.end(), 0.0 );
+            for( size_t y = 1; y + 1 < sizeY; ++y )
             {
-                for( size_t y = 1; y < grid->getSizeY() - 1; ++y )
+                for( size_t x = 1; x + 1 < sizeX; ++x )
                 {
-                    for( size_t x = 1; x < grid->getSizeX() - 1; ++x )
-                    {
-                        auto before = grid->index( x - dx, y - dy, z - dz );
-                        auto after  = grid->index( x + dx, y + dy, z + dz );
-                        auto center = grid->index( x, y, z );
+                    auto center = x + sizeX * y;
+                    tmp[ center ] = 0.25 * ( in[ center - 1 ] + 2.0 * in[ center ] + in[ center + 1 ] );
+                }
+            }
 
-                        ( *values )[ center ] = 0.25 * ( valuesIn[ before ] + 2.0 * valuesIn[ center ] + valuesIn[ after ] );
-                    }
+            // run in Y direction
+            for( size_t y = 1; y + 1 < sizeY; ++y )
+            {
+                for( size_t x = 1; x + 1 < sizeX; ++x )
+                {
+                    auto center = x + sizeX * y;
+                    layer[ center ] = 0.25 * ( tmp[ center - sizeX ] + 2.0 * tmp[ center ] + tmp[ center + sizeX ] );
                 }
             }
         }
 
-        template< typename ValueT, typename GridT >
-        SPtr< std::vector< double > > filterField( const ValueT& valuesIn, SPtr< GridT > grid )
+        /**
+         * Apply the 3D Gauss filter once. The volume is streamed in Z-slabs. Each slab keeps a sliding window of three XY-filtered layers and
+         * applies the Z kernel on them. This way, no full-size intermediate volume is needed and processed layers can be released immediately.
+         * Only inner voxels of the output are written.
+         *
+         * \tparam ValueArrayT the type of the input values
+         * \tparam ValueT the value type of the output
+         * \param valuesIn the input volume
+         * \param grid the grid
+         * \param valuesOut the output volume. Needs to be zero-initialized. Values are converted to its value type.
+         */
+        template< typename ValueArrayT, typename ValueT >
+        void filterVolume( const ValueArrayT& valuesIn, const core::GridRegular3& grid, core::ValueArray< ValueT >& valuesOut )
         {
-            // apply 1D gauss three times. Ping-Pong data:
-            auto values1 = std::make_shared< std::vector< double > >( grid->getSize() );
-            auto values2 = std::make_shared< std::vector< double > >( grid->getSize() );
+            size_t sizeX = grid.getSizeX();
+            size_t sizeY = grid.getSizeY();
+            size_t sizeZ = grid.getSizeZ();
+            size_t layerSize = sizeX * sizeY;
+            if( sizeZ < 3 )
+            {
+                return;
+            }
 
-            filterField1D( values1, valuesIn, grid, 1, 0, 0 ); // run in X direction
-            filterField1D( values2, *values1, grid, 0, 1, 0 ); // run in Y direction
-            filterField1D( values1, *values2, grid, 0, 0, 1 ); // run in Z direction
+            auto slabDepth = core::getSlabDepth( sizeZ, layerSize * ( sizeof( typename ValueArrayT::value_type ) + sizeof( ValueT ) ) );
+            core::processSlabs( 1, sizeZ - 1, slabDepth,
+                [ & ]( size_t slabBegin, size_t slabEnd )
+                {
+                    std::vector< double > tmp( layerSize );
+                    std::vector< double > previous( layerSize );
+                    std::vector< double > current( layerSize );
+                    std::vector< double > next( layerSize );
+
+                    filterLayerXY( valuesIn, grid, slabBegin - 1, tmp, previous );
+                    filterLayerXY( valuesIn, grid, slabBegin, tmp, current );
+                    for( size_t z = slabBegin; z < slabEnd; ++z )
+                    {
+                        filterLayerXY( valuesIn, grid, z + 1, tmp, next );
+
+                        // run in Z direction
+                        ValueT* out = valuesOut.data() + z * layerSize;
+                        for( size_t y = 1; y + 1 < sizeY; ++y )
+                        {
+                            for( size_t x = 1; x + 1 < sizeX; ++x )
+                            {
+                                auto center = x + sizeX * y;
+                                out[ center ] = core::convertValue< ValueT >( 0.25 * ( previous[ center ] + 2.0 * current[ center ] + next[ center ] ) );
+                            }
+                        }
+
+                        std::swap( previous, current );
+                        std::swap( current, next );
+                    }
 
-            return values1;
+                    // Done with this slab. If the volumes live in files, give the memory back.
+                    valuesIn.release( slabBegin * layerSize, ( slabEnd - slabBegin ) * layerSize );
+                    valuesOut.release( slabBegin * layerSize, ( slabEnd - slabBegin ) * layerSize );
+                }
+            );
         }
 
-        void GaussSmooth::process()
+        template< typename ValueT >
+        void GaussSmooth< ValueT >::process( const di::core::CancellationToken& token )
         {
             // Get input data
             auto inputData = m_dataInput->getData();
-            auto inputValues = inputData->getAttributes<0>();
+            auto inputValues = inputData->template getAttributes< 0 >();
 
             auto grid = inputData->getGrid();
 
-            // Iterate as often as requested
+            // Iterate as often as requested. Ping-Pong data. Both volumes are swapped to disk if they exceed the memory budget.
             size_t m_iterations = 10;
-            auto src = inputValues;
+            auto ping = core::createVolumeArray< ValueT >( grid->getSize() );
+            auto pong = core::createVolumeArray< ValueT >( grid->getSize() );
+            ConstSPtr< core::ValueArray< ValueT > > src = inputValues;
             for( size_t i = 0; i < m_iterations; ++i )
             {
+                token.throwIfCancelled();
                 LogD << "Gauss filter - iteration: " << i + 1 << LogEnd;
-                src = filterField( *src, grid );
-            }
-            /*
-            std::ofstream f( "/home/seth/smooth222t" + std::to_string( grid->getSizeX() ) + "_" +
-                                                 std::to_string( grid->getSizeY() ) + "_" +
-                                                 std::to_string( grid->getSizeZ() ) +
-                    ".raw" , std::ios::out | std::ios::binary );
-            if( f.good() )
-            {
-                f.write( reinterpret_cast<const char*>(&src->data()[0]), src->size() * sizeof( double ) );
+                auto dst = ( i % 2 == 0 ) ? ping : pong;
+                filterVolume( *src, *grid, *dst );
+                src = dst;
+                reportProgress( static_cast< double >( i + 1 ) / m_iterations );
             }
 
-            f.close();
-            */
-
             // Construct result dataset:
-            m_dataOutput->setData( std::make_shared< di::core::DataSetScalarRegular3d >( "Gaussed", grid, src ) );
+            m_dataOutput->setData( std::make_shared< di::core::DataSetScalarRegular3< ValueT > >( "Gaussed", grid, src ) );
         }
+
+        // Instantiate for all supported value types
+        template class GaussSmooth< double >;
+        template class GaussSmooth< float >;
+        template class GaussSmooth< uint16_t >;
+        template class GaussSmooth< uint8_t >;
     }
 }
-
@@ -25,6 +25,7 @@
 #ifndef DI_GAUSSSMOOTH_H
 #define DI_GAUSSSMOOTH_H
 
+#include <cstdint>
 #include <mutex>
 
 #include <di/core/Algorithm.h>
@@ -36,7 +37,10 @@ namespace di
     {
         /**
          * Gaussian filter the given scalar data.
+         *
+         * \tparam ValueT the value type of the output. Values are filtered in double precision and stored as ValueT after each iteration.
          */
+        template< typename ValueT = float >
         class GaussSmooth: public di::core::Algorithm
         {
         public:
@@ -52,19 +56,21 @@ namespace di
 
             /**
              * Does nothing in this case, besides setting the injection data.
+             *
+             * \param token cancellation token of this run
              */
-            virtual void process();
+            virtual void process( const di::core::CancellationToken& token );
         protected:
         private:
             /**
              * The scalar input to use.
              */
-            SPtr< di::core::Connector< di::core::DataSetScalarRegular3d > > m_dataInput;
+            SPtr< di::core::Connector< di::core::DataSetScalarRegular3< ValueT > > > m_dataInput;
 
             /**
              * The voxel output to use.
              */
-            SPtr< di::core::Connector< di::core::DataSetScalarRegular3d > > m_dataOutput;
+            SPtr< di::core::Connector< di::core::DataSetScalarRegular3< ValueT > > > m_dataOutput;
         };
     }
 }
@@ -183,7 +183,7 @@ namespace di
             return;
         }
 
-        void RenderIllustrativeLines::process()
+        void RenderIllustrativeLines::process( const di::core::CancellationToken& /* token */ )
         {
             // Get input data
             auto data = m_triangleDataInput->getData();
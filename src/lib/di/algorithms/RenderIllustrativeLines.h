@@ -67,8 +67,10 @@ namespace di
 
             /**
              * Process the data in the inputs and update output data. Keep in mind that this might be called in its own thread thread.
+             *
+             * \param token cancellation token of this run
              */
-            virtual void process() override;
+            virtual void process( const di::core::CancellationToken& token ) override;
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Visualization Specific Methods
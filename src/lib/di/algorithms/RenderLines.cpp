@@ -59,7 +59,7 @@ namespace di
             // nothing to clean up so far
         }
 
-        void RenderLines::process()
+        void RenderLines::process( const di::core::CancellationToken& /* token */ )
         {
             // Get input data
             auto data = m_lineDataInput->getData();
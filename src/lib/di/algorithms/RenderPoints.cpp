@@ -59,7 +59,7 @@ namespace di
             // nothing to clean up so far
         }
 
-        void RenderPoints::process()
+        void RenderPoints::process( const di::core::CancellationToken& /* token */ )
         {
             // Get input data
             auto data = m_pointDataInput->getData();
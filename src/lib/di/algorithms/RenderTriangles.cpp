@@ -59,7 +59,7 @@ namespace di
             // nothing to clean up so far
         }
 
-        void RenderTriangles::process()
+        void RenderTriangles::process( const di::core::CancellationToken& /* token */ )
         {
             // Get input data
             auto data = m_triangleDataInput->getData();
@@ -62,8 +62,10 @@ namespace di
 
             /**
              * Process the data in the inputs and update output data. Keep in mind that this might be called in its own thread thread.
+             *
+             * \param token cancellation token of this run
              */
-            virtual void process();
+            virtual void process( const di::core::CancellationToken& token );
 
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
             // Visualization Specific Methods
@@ -65,7 +65,7 @@ namespace di
             // nothing to clean up so far
         }
 
-        void SurfaceLIC::process()
+        void SurfaceLIC::process( const di::core::CancellationToken& /* token */ )
         {
             // Get input data
             auto data = m_triangleDataInput->getData();
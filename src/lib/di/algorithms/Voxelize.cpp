@@ -27,6 +27,7 @@
 #include <vector>
 #include <utility>
 
+#include <di/core/data/SlabStreaming.h>
 #include <di/core/data/TriangleDataSet.h>
 
 #include "Voxelize.h"
@@ -38,12 +39,13 @@ namespace di
 {
     namespace algorithms
     {
-        Voxelize::Voxelize():
+        template< typename ValueT >
+        Voxelize< ValueT >::Voxelize():
             Algorithm( "Voxelize",
                        "Create a voxel-version of the input data." )
         {
             // 1: the output
-            m_dataOutput = addOutput< di::core::DataSetScalarRegular3d >(
+            m_dataOutput = addOutput< di::core::DataSetScalarRegular3< ValueT > >(
                     "Voxel Mask",
                     "The triangle data as bunch of voxels."
             );
@@ -60,47 +62,55 @@ namespace di
                     128 );*/
         }
 
-        Voxelize::~Voxelize()
+        template< typename ValueT >
+        Voxelize< ValueT >::~Voxelize()
         {
             // nothing to clean up so far
         }
 
-        void Voxelize::process()
+        template< typename ValueT >
+        void Voxelize< ValueT >::process( const di::core::CancellationToken& token )
         {
             // Get input data
             auto triangleDataSet = m_dataInput->getData();
 
             // Create the grid with the desired resolution:
             auto grid = regularGridForBoundingBox( triangleDataSet->getGrid()->getBoundingBox(), m_resoultion, 10 );
-            auto values = std::make_shared< std::vector< double > >( grid->getSize() );
+            auto values = core::createVolumeArray< ValueT >( grid->getSize() );
 
             LogD << "Using grid: " << *grid << LogEnd;
 
             // Iterate each triangle
             for( auto tri : triangleDataSet->getGrid()->getTriangles() )
             {
+                token.throwIfCancelled();
                 // Note: this is probably the worst way of rasterizing a triangle. Sufficient for now.
                 auto v1 = triangleDataSet->getGrid()->getVertex( tri.x );
                 auto v2 = triangleDataSet->getGrid()->getVertex( tri.y );
                 auto v3 = triangleDataSet->getGrid()->getVertex( tri.z );
 
-                ( *values )[ grid->voxelIndex( v1 ) ] = 1.0;
-                ( *values )[ grid->voxelIndex( v2 ) ] = 1.0;
-                ( *values )[ grid->voxelIndex( v3 ) ] = 1.0;
+                ( *values )[ grid->voxelIndex( v1 ) ] = ValueT( 1 );
+                ( *values )[ grid->voxelIndex( v2 ) ] = ValueT( 1 );
+                ( *values )[ grid->voxelIndex( v3 ) ] = ValueT( 1 );
 
                 // Raster in between .. the ugly way:
                 auto v21m = v1 + 0.5f * ( v2 - v1 );
                 auto v31m = v1 + 0.5f * ( v3 - v1 );
                 auto v32m = v1 + 0.5f * ( v3 - v2 );
 
-                ( *values )[ grid->voxelIndex( v21m ) ] = 1.0;
-                ( *values )[ grid->voxelIndex( v31m ) ] = 1.0;
-                ( *values )[ grid->voxelIndex( v32m ) ] = 1.0;
+                ( *values )[ grid->voxelIndex( v21m ) ] = ValueT( 1 );
+                ( *values )[ grid->voxelIndex( v31m ) ] = ValueT( 1 );
+                ( *values )[ grid->voxelIndex( v32m ) ] = ValueT( 1 );
             }
 
             // Construct result dataset:
-            m_dataOutput->setData( std::make_shared< di::core::DataSetScalarRegular3d >( "Voxels", grid, values ) );
+            m_dataOutput->setData( std::make_shared< di::core::DataSetScalarRegular3< ValueT > >( "Voxels", grid, values ) );
         }
+
+        // Instantiate for all supported value types
+        template class Voxelize< double >;
+        template class Voxelize< float >;
+        template class Voxelize< uint16_t >;
+        template class Voxelize< uint8_t >;
     }
 }
-
@@ -25,6 +25,7 @@
 #ifndef DI_VOXELIZE_H
 #define DI_VOXELIZE_H
 
+#include <cstdint>
 #include <mutex>
 
 #include <di/core/Algorithm.h>
@@ -36,7 +37,10 @@ namespace di
     {
         /**
          * Extract a voxelized version of the given input.
+         *
+         * \tparam ValueT the value type of the output mask.
          */
+        template< typename ValueT = uint8_t >
         class Voxelize: public di::core::Algorithm
         {
         public:
@@ -52,8 +56,10 @@ namespace di
 
             /**
              * Does nothing in this case, besides setting the injection data.
+             *
+             * \param token cancellation token of this run
              */
-            virtual void process();
+            virtual void process( const di::core::CancellationToken& token );
         protected:
         private:
             /**
@@ -64,7 +70,7 @@ namespace di
             /**
              * The voxel output to use.
              */
-            SPtr< di::core::Connector< di::core::DataSetScalarRegular3d > > m_dataOutput;
+            SPtr< di::core::Connector< di::core::DataSetScalarRegular3< ValueT > > > m_dataOutput;
 
             /**
              * The resolution used for voxelizing.
@@ -0,0 +1,108 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_INJECTDATA_H
+#define DI_INJECTDATA_H
+
+#include <string>
+
+#include <di/core/CommandObserver.h>
+#include <di/core/Command.h>
+#include <di/core/ConnectorTransferable.h>
+
+#include <di/algorithms/DataInject.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace commands
+    {
+        /**
+         * Implements a command to inject data into a \ref di::algorithms::DataInject and to propagate it through the network right away. In
+         * contrast to a \ref RunNetwork command, this never waits for pending reads. It is used to show previews of data that is still loading.
+         */
+        class InjectData: public di::core::Command
+        {
+        public:
+            /**
+             * Create a command to inject the data.
+             *
+             * \param inject the algorithm to inject the data to
+             * \param data the data. Can be nullptr.
+             * \param observer an object that gets notified upon changes in this command's state
+             */
+            InjectData( SPtr< di::algorithms::DataInject > inject, ConstSPtr< di::core::ConnectorTransferable > data,
+                        SPtr< di::core::CommandObserver > observer = nullptr );
+
+            /**
+             * Clean up.
+             */
+            virtual ~InjectData();
+
+            /**
+             * Get the human-readable title of this command. This should be something like "Adding Algorithm".
+             *
+             * \return the title
+             */
+            virtual std::string getName() const;
+
+            /**
+             * Get the human-readable description of this command. This is a more detailed description of what is going on, like "Adding a algorithm
+             * to the network without connecting them".
+             *
+             * \return the description
+             */
+            virtual std::string getDescription() const;
+
+            /**
+             * The algorithm to inject the data to.
+             *
+             * \return the injector
+             */
+            SPtr< di::algorithms::DataInject > getDataInject() const;
+
+            /**
+             * The data to inject.
+             *
+             * \return the data
+             */
+            ConstSPtr< di::core::ConnectorTransferable > getData() const;
+        protected:
+        private:
+            /**
+             * The injector.
+             */
+            SPtr< di::algorithms::DataInject > m_inject = nullptr;
+
+            /**
+             * The data.
+             */
+            ConstSPtr< di::core::ConnectorTransferable > m_data = nullptr;
+        };
+    }
+}
+
+#endif  // DI_INJECTDATA_H
+
@@ -30,8 +30,9 @@ namespace di
 {
     namespace commands
     {
-        QueryState::QueryState( SPtr< di::core::CommandObserver > observer ):
-            Command( observer )
+        QueryState::QueryState( SPtr< di::core::CommandObserver > observer, bool includeStatistics ):
+            Command( observer ),
+            m_includeStatistics( includeStatistics )
         {
         }
 
@@ -52,11 +53,32 @@ namespace di
         void QueryState::setState( const di::core::State& state )
         {
             m_state = state;
+
+            for( auto merged : getMergedCommands() )
+            {
+                std::static_pointer_cast< QueryState >( merged )->setState( state );
+            }
         }
 
         const di::core::State& QueryState::getState() const
         {
             return m_state;
         }
+
+        bool QueryState::getIncludeStatistics() const
+        {
+            return m_includeStatistics;
+        }
+
+        di::core::Command::Priority QueryState::getPriority() const
+        {
+            return Priority::High;
+        }
+
+        bool QueryState::canMerge( ConstSPtr< di::core::Command > later ) const
+        {
+            auto laterQuery = std::dynamic_pointer_cast< const QueryState >( later );
+            return isWaiting() && laterQuery && ( laterQuery->m_includeStatistics == m_includeStatistics );
+        }
     }
 }
@@ -44,11 +44,12 @@ namespace di
         {
         public:
             /**
-             * Create a command to re-run the whole network.
+             * Create a command to query the network state.
              *
              * \param observer an object that gets notified upon changes in this command's state
+             * \param includeStatistics if true, the state also contains the run statistics of the algorithms in a state named "Statistics".
              */
-            explicit QueryState( SPtr< di::core::CommandObserver > observer = nullptr );
+            explicit QueryState( SPtr< di::core::CommandObserver > observer = nullptr, bool includeStatistics = false );
 
             /**
              * Clean up.
@@ -84,12 +85,40 @@ namespace di
              */
             void setState( const di::core::State& state );
 
+            /**
+             * Check whether the run statistics were requested.
+             *
+             * \return true if the state should contain the statistics.
+             */
+            bool getIncludeStatistics() const;
+
+            /**
+             * Queries are answered before other commands.
+             *
+             * \return \ref di::core::Command::Priority::High
+             */
+            virtual Priority getPriority() const;
+
+            /**
+             * Waiting queries are merged. They get the same state.
+             *
+             * \param later the command that got committed after this one.
+             *
+             * \return true if the later command is a query for the same contents.
+             */
+            virtual bool canMerge( ConstSPtr< di::core::Command > later ) const;
+
         protected:
         private:
             /**
              * The result state
              */
             di::core::State m_state;
+
+            /**
+             * True if the statistics were requested.
+             */
+            bool m_includeStatistics = false;
         };
     }
 }
@@ -26,6 +26,8 @@
 
 #include <di/core/Reader.h>
 
+#include <di/commands/RunNetwork.h>
+
 #include "ReadFile.h"
 
 namespace di
@@ -70,6 +72,11 @@ namespace di
         void ReadFile::setResult( SPtr< di::core::DataSetBase > result )
         {
             m_result = result;
+
+            for( auto merged : getMergedCommands() )
+            {
+                std::static_pointer_cast< ReadFile >( merged )->setResult( result );
+            }
         }
 
         SPtr< core::Reader > ReadFile::getReader() const
@@ -81,5 +88,23 @@ namespace di
         {
             return m_inject;
         }
+
+        bool ReadFile::canMerge( ConstSPtr< di::core::Command > later ) const
+        {
+            auto laterRead = std::dynamic_pointer_cast< const ReadFile >( later );
+            return isWaiting() && laterRead &&
+                   ( laterRead->m_filename == m_filename ) && ( laterRead->m_reader == m_reader ) && ( laterRead->m_inject == m_inject );
+        }
+
+        bool ReadFile::canMoveBefore( ConstSPtr< di::core::Command > earlier ) const
+        {
+            if( std::dynamic_pointer_cast< const RunNetwork >( earlier ) )
+            {
+                return true;
+            }
+
+            auto earlierRead = std::dynamic_pointer_cast< const ReadFile >( earlier );
+            return earlierRead && ( !m_inject || ( earlierRead->m_inject != m_inject ) );
+        }
     }
 }
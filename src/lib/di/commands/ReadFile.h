@@ -124,6 +124,25 @@ namespace di
              * \return the injector.
              */
             SPtr< di::algorithms::DataInject > getDataInject() const;
+
+            /**
+             * Waiting loads of the same file with the same reader and injector are merged. Loads that are already running are not, as the file
+             * might have changed in between.
+             *
+             * \param later the command that got committed after this one.
+             *
+             * \return true if the later command loads the same file in the same way.
+             */
+            virtual bool canMerge( ConstSPtr< di::core::Command > later ) const;
+
+            /**
+             * Loads can be moved before runs and before loads into other injectors. The network state after both commands is the same.
+             *
+             * \param earlier the command committed earlier and still waiting.
+             *
+             * \return true if the order does not matter.
+             */
+            virtual bool canMoveBefore( ConstSPtr< di::core::Command > earlier ) const;
         protected:
         private:
             /**
@@ -48,5 +48,10 @@ namespace di
         {
             return "Re-run a whole processing network.";
         }
+
+        bool RunNetwork::canMerge( ConstSPtr< di::core::Command > later ) const
+        {
+            return isWaiting() && ( std::dynamic_pointer_cast< const RunNetwork >( later ) != nullptr );
+        }
     }
 }
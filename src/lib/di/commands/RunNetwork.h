@@ -68,6 +68,15 @@ namespace di
              * \return the description
              */
             virtual std::string getDescription() const;
+
+            /**
+             * Adjacent runs are merged. A waiting run uses the latest state anyway.
+             *
+             * \param later the command that got committed after this one.
+             *
+             * \return true if the later command is a run.
+             */
+            virtual bool canMerge( ConstSPtr< di::core::Command > later ) const;
         protected:
         private:
         };
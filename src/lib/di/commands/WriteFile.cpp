@@ -0,0 +1,81 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <string>
+
+#include <di/core/Algorithm.h>
+#include <di/core/Writer.h>
+
+#include "WriteFile.h"
+
+namespace di
+{
+    namespace commands
+    {
+        WriteFile::WriteFile( SPtr< core::Writer > writer, ConstSPtr< core::Algorithm > algorithm, const std::string& connectorName,
+                              const std::string& filename, SPtr< di::core::CommandObserver > observer ):
+            Command( observer ),
+            m_writer( writer ),
+            m_algorithm( algorithm ),
+            m_connectorName( connectorName ),
+            m_filename( filename )
+        {
+        }
+
+        WriteFile::~WriteFile()
+        {
+        }
+
+        std::string WriteFile::getName() const
+        {
+            return "Write File";
+        }
+
+        std::string WriteFile::getDescription() const
+        {
+            return "Write the data of an algorithm output to disk.";
+        }
+
+        SPtr< core::Writer > WriteFile::getWriter() const
+        {
+            return m_writer;
+        }
+
+        ConstSPtr< core::Algorithm > WriteFile::getAlgorithm() const
+        {
+            return m_algorithm;
+        }
+
+        const std::string& WriteFile::getConnectorName() const
+        {
+            return m_connectorName;
+        }
+
+        const std::string& WriteFile::getFilename() const
+        {
+            return m_filename;
+        }
+    }
+}
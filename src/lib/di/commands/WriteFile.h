@@ -0,0 +1,139 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#ifndef DI_WRITEFILE_H
+#define DI_WRITEFILE_H
+
+#include <string>
+
+#include <di/core/CommandObserver.h>
+#include <di/core/Command.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        class Algorithm;
+        class Writer;
+    }
+
+    namespace commands
+    {
+        /**
+         * Implements a command to write the current data of an algorithm output to disk. As it is processed in order with all other commands,
+         * committing it after a \ref RunNetwork writes the results of that run.
+         */
+        class WriteFile: public di::core::Command
+        {
+        public:
+            /**
+             * Create a command to write the data of the specified output.
+             *
+             * \param writer the writer to use
+             * \param algorithm the algorithm providing the data
+             * \param connectorName the name of the output connector
+             * \param filename the file to write
+             * \param observer an object that gets notified upon changes in this command's state.
+             */
+            WriteFile( SPtr< core::Writer > writer, ConstSPtr< core::Algorithm > algorithm, const std::string& connectorName,
+                       const std::string& filename, SPtr< di::core::CommandObserver > observer = nullptr );
+
+            /**
+             * Clean up.
+             */
+            virtual ~WriteFile();
+
+            /**
+             * Get the human-readable title of this command. This should be something like "Adding Algorithm".
+             *
+             * \return the title
+             */
+            virtual std::string getName() const;
+
+            /**
+             * Get the human-readable description of this command. This is a more detailed description of what is going on, like "Adding a algorithm
+             * to the network without connecting them".
+             *
+             * \return the description
+             */
+            virtual std::string getDescription() const;
+
+            /**
+             * Get the writer to use.
+             *
+             * \return the writer
+             */
+            SPtr< core::Writer > getWriter() const;
+
+            /**
+             * Get the algorithm providing the data.
+             *
+             * \return the algorithm
+             */
+            ConstSPtr< core::Algorithm > getAlgorithm() const;
+
+            /**
+             * Get the name of the output connector.
+             *
+             * \return the name
+             */
+            const std::string& getConnectorName() const;
+
+            /**
+             * Get the filename specified.
+             *
+             * \return the filename
+             */
+            const std::string& getFilename() const;
+
+        protected:
+        private:
+            /**
+             * The writer.
+             */
+            SPtr< core::Writer > m_writer = nullptr;
+
+            /**
+             * The algorithm providing the data.
+             */
+            ConstSPtr< core::Algorithm > m_algorithm = nullptr;
+
+            /**
+             * The output connector name.
+             */
+            std::string m_connectorName = "";
+
+            /**
+             * The filename.
+             */
+            std::string m_filename = "";
+        };
+    }
+}
+
+#endif  // DI_WRITEFILE_H
+
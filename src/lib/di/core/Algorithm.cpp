@@ -23,10 +23,14 @@
 //---------------------------------------------------------------------------------------
 
 #include <algorithm>
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <di/core/ObserverCallback.h>
 #include <di/core/ObserverParameter.h>
+#include <di/core/Trace.h>
 
 #include "Algorithm.h"
 
@@ -147,20 +151,34 @@ namespace di
 
         void Algorithm::requestUpdate( bool request )
         {
-            if( ( m_updateRequested == request ) || ( !request ) )
+            bool notifyObservers = false;
             {
+                std::lock_guard< std::mutex > lock( m_updateRequestMutex );
+
+                // While running, each request makes the current run outdated. Always notify to allow the network to react.
+                notifyObservers = request && ( !m_updateRequested || m_running );
+                m_updateRequestedWhileRunning = m_updateRequestedWhileRunning || ( request && m_running );
                 m_updateRequested = request;
-                return;
             }
-            m_updateRequested = request;
-            notify();
+
+            if( notifyObservers )
+            {
+                notify();
+            }
         }
 
         bool Algorithm::isUpdateRequested() const
         {
+            std::lock_guard< std::mutex > lock( m_updateRequestMutex );
             return m_updateRequested;
         }
 
+        bool Algorithm::isUpdateRequestedWhileRunning() const
+        {
+            std::lock_guard< std::mutex > lock( m_updateRequestMutex );
+            return m_running && m_updateRequestedWhileRunning;
+        }
+
         bool Algorithm::isSource() const
         {
             return ( getInputs().empty() && !getOutputs().empty() );
@@ -200,10 +218,146 @@ namespace di
             return os;
         }
 
-        void Algorithm::run()
+        void Algorithm::run( const CancellationToken& token )
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_updateRequestMutex );
+                m_running = true;
+                m_updateRequestedWhileRunning = false;
+            }
+
+            std::vector< SPtr< AlgorithmObserver > > observers;
+            {
+                std::lock_guard< std::mutex > lock( m_statisticsMutex );
+                m_statistics.running = true;
+                m_statistics.progress = 0.0;
+                m_statistics.inputSize = getDataSize( getInputs() );
+                observers = m_runObservers;
+            }
+            for( auto observer : observers )
+            {
+                observer->started( *this );
+            }
+
+            TraceSpan span( "algorithm", getName(), getRuntimeName() );
+            auto wallStart = std::chrono::steady_clock::now();
+            CPUTimeAccount cpuAccount;
+            try
+            {
+                process( token );
+            }
+            catch( const OperationCancelled& )
+            {
+                finishRun( wallStart, cpuAccount, RunResult::Cancelled );
+                throw;
+            }
+            catch( ... )
+            {
+                finishRun( wallStart, cpuAccount, RunResult::Failed );
+                throw;
+            }
+            finishRun( wallStart, cpuAccount, RunResult::Finished );
+        }
+
+        void Algorithm::finishRun( std::chrono::steady_clock::time_point wallStart, const CPUTimeAccount& cpuAccount, RunResult result )
+        {
+            double wallTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - wallStart ).count();
+            double cpuTime = cpuAccount.getCPUTime();
+
+            // Done. Requests that came in while running still need another run. Failed runs keep the request.
+            {
+                std::lock_guard< std::mutex > lock( m_updateRequestMutex );
+                m_running = false;
+                if( result == RunResult::Finished )
+                {
+                    m_updateRequested = m_updateRequestedWhileRunning;
+                }
+            }
+
+            AlgorithmStatistics statistics;
+            std::vector< SPtr< AlgorithmObserver > > observers;
+            {
+                std::lock_guard< std::mutex > lock( m_statisticsMutex );
+                m_statistics.running = false;
+                m_statistics.lastWallTime = wallTime;
+                m_statistics.lastCPUTime = cpuTime;
+                m_statistics.totalWallTime += wallTime;
+                m_statistics.totalCPUTime += cpuTime;
+                m_statistics.outputSize = getDataSize( getOutputs() );
+                switch( result )
+                {
+                    case RunResult::Finished:
+                        m_statistics.finishedRuns++;
+                        m_statistics.progress = 1.0;
+                        break;
+                    case RunResult::Cancelled:
+                        m_statistics.cancelledRuns++;
+                        break;
+                    case RunResult::Failed:
+                        m_statistics.failedRuns++;
+                        break;
+                }
+                statistics = m_statistics;
+                observers = m_runObservers;
+            }
+
+            for( auto observer : observers )
+            {
+                observer->finished( *this, statistics );
+            }
+        }
+
+        template< typename ConnectorSetT >
+        size_t Algorithm::getDataSize( const ConnectorSetT& connectors )
+        {
+            size_t size = 0;
+            for( auto connector : connectors )
+            {
+                auto data = connector->getTransferable();
+                if( data )
+                {
+                    size += data->getMemorySize();
+                }
+            }
+            return size;
+        }
+
+        AlgorithmStatistics Algorithm::getStatistics() const
+        {
+            std::lock_guard< std::mutex > lock( m_statisticsMutex );
+            return m_statistics;
+        }
+
+        void Algorithm::observeRuns( SPtr< AlgorithmObserver > observer )
         {
-            process();
-            requestUpdate( false );
+            std::lock_guard< std::mutex > lock( m_statisticsMutex );
+            if( std::find( m_runObservers.begin(), m_runObservers.end(), observer ) == m_runObservers.end() )
+            {
+                m_runObservers.push_back( observer );
+            }
+        }
+
+        void Algorithm::removeRunObserver( SPtr< AlgorithmObserver > observer )
+        {
+            std::lock_guard< std::mutex > lock( m_statisticsMutex );
+            m_runObservers.erase( std::remove( m_runObservers.begin(), m_runObservers.end(), observer ), m_runObservers.end() );
+        }
+
+        void Algorithm::reportProgress( double progress )
+        {
+            progress = std::min( std::max( progress, 0.0 ), 1.0 );
+
+            std::vector< SPtr< AlgorithmObserver > > observers;
+            {
+                std::lock_guard< std::mutex > lock( m_statisticsMutex );
+                m_statistics.progress = progress;
+                observers = m_runObservers;
+            }
+
+            for( auto observer : observers )
+            {
+                observer->progress( *this, progress );
+            }
         }
 
         const std::string& Algorithm::getRuntimeName() const
@@ -27,13 +27,20 @@
 
 #include <atomic>
 #include <algorithm>
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include <di/core/AlgorithmObserver.h>
+#include <di/core/AlgorithmStatistics.h>
+#include <di/core/CancellationToken.h>
 #include <di/core/ConnectorBase.h>
 #include <di/core/Connector.h>
 #include <di/core/ParameterBase.h>
 #include <di/core/Parameter.h>
 #include <di/core/Observable.h>
+#include <di/core/Parallel.h>
 #include <di/core/ConnectorTransferable.h>
 
 #include <di/Types.h>
@@ -87,14 +94,50 @@ namespace di
             virtual std::string getInstanceInfo() const override;
 
             /**
-             * Process the inputs and update the outputs here. This method might be called in its own thread.
+             * Process the inputs and update the outputs here. This method might be called in its own thread. Long running implementations should
+             * poll the token regularly using \ref CancellationToken::throwIfCancelled. The network cancels a run if its results are outdated by
+             * a parameter change anyway.
+             *
+             * \param token the cancellation token of this run
+             */
+            virtual void process( const CancellationToken& token ) = 0;
+
+            /**
+             * Run the algorithm in the calling thread. It also resets the updateRequest, unless an update was requested while running.
+             *
+             * \param token the cancellation token. Passed to \ref process.
+             *
+             * \throw whatever process throws. The updateRequest is kept then.
+             */
+            void run( const CancellationToken& token );
+
+            /**
+             * Check whether an update was requested while the algorithm is running. The result of this run is outdated then.
+             *
+             * \return true if running and an update was requested since the run started.
              */
-            virtual void process() = 0;
+            bool isUpdateRequestedWhileRunning() const;
 
             /**
-             * Run the algorithm in the calling thread. It also resets the updateRequest.
+             * Get the timing and data statistics of the runs so far. Thread-safe.
+             *
+             * \return the statistics
              */
-            void run();
+            AlgorithmStatistics getStatistics() const;
+
+            /**
+             * Get notified about runs and progress of this algorithm. If already registered, nothing happens.
+             *
+             * \param observer the observer
+             */
+            void observeRuns( SPtr< AlgorithmObserver > observer );
+
+            /**
+             * Stop getting notified about runs.
+             *
+             * \param observer the observer to remove.
+             */
+            void removeRunObserver( SPtr< AlgorithmObserver > observer );
 
             /**
              * Method checks whether this algorithm is a source. This means, whether it only has outputs and no inputs.
@@ -393,7 +436,45 @@ namespace di
              * \param parameter the parameter that notified this
              */
             virtual void onParameterChange( SPtr< ParameterBase > parameter );
+
+            /**
+             * Report the progress of the current run. Call this from within \ref process. It is thread-safe, but notifies all run observers. Do not
+             * call it for each element.
+             *
+             * \param progress the progress in [0, 1]
+             */
+            void reportProgress( double progress );
         private:
+            /**
+             * The outcome of a run.
+             */
+            enum class RunResult
+            {
+                Finished,
+                Cancelled,
+                Failed
+            };
+
+            /**
+             * Update the statistics after a run and notify the run observers.
+             *
+             * \param wallStart the wall time when the run started
+             * \param cpuAccount the CPU time account of the run
+             * \param result the outcome of the run
+             */
+            void finishRun( std::chrono::steady_clock::time_point wallStart, const CPUTimeAccount& cpuAccount, RunResult result );
+
+            /**
+             * Sum up the memory of the data in the given connectors.
+             *
+             * \tparam ConnectorSetT the set of connectors
+             * \param connectors the connectors
+             *
+             * \return the size in bytes
+             */
+            template< typename ConnectorSetT >
+            static size_t getDataSize( const ConnectorSetT& connectors );
+
             /**
              * Algorithm inputs. Fill during construction.
              */
@@ -433,6 +514,36 @@ namespace di
              * If true, an update was requested.
              */
             bool m_updateRequested = false;
+
+            /**
+             * True while \ref run is executed.
+             */
+            bool m_running = false;
+
+            /**
+             * True if an update was requested while running.
+             */
+            bool m_updateRequestedWhileRunning = false;
+
+            /**
+             * Secures the update request state.
+             */
+            mutable std::mutex m_updateRequestMutex;
+
+            /**
+             * The statistics of all runs.
+             */
+            AlgorithmStatistics m_statistics;
+
+            /**
+             * The observers of the runs.
+             */
+            std::vector< SPtr< AlgorithmObserver > > m_runObservers;
+
+            /**
+             * Secures the statistics and the run observers.
+             */
+            mutable std::mutex m_statisticsMutex;
         };
 
         /**
@@ -0,0 +1,89 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_ALGORITHMOBSERVER_H
+#define DI_ALGORITHMOBSERVER_H
+
+#include <di/core/AlgorithmStatistics.h>
+#include <di/core/Observer.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        class Algorithm;
+
+        /**
+         * Implements a class to monitor the runs of an \ref Algorithm. Use it to measure where time goes, to show progress or to alert on slow
+         * algorithms.
+         *
+         * \note The notifications are issued by the thread running the algorithm. Progress can also be reported by threads started by the
+         * algorithm. Keep the implementations short and thread-safe.
+         */
+        class AlgorithmObserver: public Observer
+        {
+        public:
+            /**
+             * The algorithm started a run.
+             *
+             * \param algorithm the algorithm that issued this notification.
+             */
+            virtual void started( const Algorithm& algorithm ) = 0;
+
+            /**
+             * The algorithm reported progress.
+             *
+             * \param algorithm the algorithm that issued this notification.
+             * \param progress the progress in [0, 1]
+             */
+            virtual void progress( const Algorithm& algorithm, double progress ) = 0;
+
+            /**
+             * The algorithm finished a run. Also called if the run failed or was cancelled.
+             *
+             * \param algorithm the algorithm that issued this notification.
+             * \param statistics the statistics including this run.
+             */
+            virtual void finished( const Algorithm& algorithm, const AlgorithmStatistics& statistics ) = 0;
+
+        protected:
+            /**
+             * Constructor. Does nothing.
+             */
+            AlgorithmObserver();
+
+            /**
+             * Destructor. Does nothing.
+             */
+            virtual ~AlgorithmObserver();
+
+        private:
+        };
+    }
+}
+
+#endif  // DI_ALGORITHMOBSERVER_H
+
@@ -0,0 +1,48 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include "AlgorithmStatistics.h"
+
+namespace di
+{
+    namespace core
+    {
+        State AlgorithmStatistics::toState() const
+        {
+            State s;
+            s.set( "finishedRuns", finishedRuns );
+            s.set( "cancelledRuns", cancelledRuns );
+            s.set( "failedRuns", failedRuns );
+            s.set( "running", running );
+            s.set( "progress", progress );
+            s.set( "lastWallTime", lastWallTime );
+            s.set( "lastCPUTime", lastCPUTime );
+            s.set( "totalWallTime", totalWallTime );
+            s.set( "totalCPUTime", totalCPUTime );
+            s.set( "inputSize", inputSize );
+            s.set( "outputSize", outputSize );
+            return s;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_ALGORITHMSTATISTICS_H
+#define DI_ALGORITHMSTATISTICS_H
+
+#include <cstddef>
+
+#include <di/core/State.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Timing and data statistics of the runs of an algorithm. Times are in milliseconds, sizes in bytes.
+         */
+        struct AlgorithmStatistics
+        {
+            /**
+             * The number of runs that finished.
+             */
+            size_t finishedRuns = 0;
+
+            /**
+             * The number of runs that were cancelled.
+             */
+            size_t cancelledRuns = 0;
+
+            /**
+             * The number of runs that failed.
+             */
+            size_t failedRuns = 0;
+
+            /**
+             * True while running.
+             */
+            bool running = false;
+
+            /**
+             * The progress of the current or last run in [0, 1]. Only meaningful if the algorithm reports its progress.
+             */
+            double progress = 0.0;
+
+            /**
+             * Wall time of the last run.
+             */
+            double lastWallTime = 0.0;
+
+            /**
+             * CPU time of the last run. This is the CPU time of the thread that ran the algorithm plus the helper threads of \ref parallelFor and
+             * \ref processSlabs. Work handed to other threads, like a \ref WorkerPool, is not included.
+             */
+            double lastCPUTime = 0.0;
+
+            /**
+             * Sum of the wall times of all runs.
+             */
+            double totalWallTime = 0.0;
+
+            /**
+             * Sum of the CPU times of all runs.
+             */
+            double totalCPUTime = 0.0;
+
+            /**
+             * Memory of the input data of the last run. Data that does not report its size is not included.
+             */
+            size_t inputSize = 0;
+
+            /**
+             * Memory of the output data after the last run. Data that does not report its size is not included.
+             */
+            size_t outputSize = 0;
+
+            /**
+             * Convert to a state. Each statistic becomes a value named like the member.
+             *
+             * \return the state
+             */
+            State toState() const;
+        };
+    }
+}
+
+#endif  // DI_ALGORITHMSTATISTICS_H
+
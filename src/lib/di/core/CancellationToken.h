@@ -0,0 +1,109 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_CANCELLATIONTOKEN_H
+#define DI_CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Thrown by \ref CancellationToken::throwIfCancelled to leave a cancelled operation.
+         */
+        class OperationCancelled: public std::runtime_error
+        {
+        public:
+            /**
+             * Constructor.
+             *
+             * \param what the message
+             */
+            explicit OperationCancelled( const std::string& what = "Operation cancelled." );
+        };
+
+        /**
+         * A flag to cooperatively cancel a running operation. The owner of the operation cancels it. The operation polls the token in its long
+         * running loops and stops as soon as possible. It is thread-safe.
+         */
+        class CancellationToken
+        {
+        public:
+            /**
+             * Create a token. Not cancelled.
+             */
+            CancellationToken();
+
+            /**
+             * Destructor.
+             */
+            virtual ~CancellationToken() = default;
+
+            /**
+             * Request cancellation.
+             */
+            void cancel();
+
+            /**
+             * Check whether cancellation was requested.
+             *
+             * \return true if cancelled
+             */
+            bool isCancelled() const;
+
+            /**
+             * Leave the current operation if cancellation was requested. Call this in long running loops. It is cheap.
+             *
+             * \throw OperationCancelled if cancelled
+             */
+            void throwIfCancelled() const;
+
+        protected:
+        private:
+            /**
+             * Forbid copy. Operations need to see the token of their owner.
+             */
+            CancellationToken( const CancellationToken& ) = delete;
+
+            /**
+             * Forbid assignment.
+             *
+             * \return nothing
+             */
+            CancellationToken& operator=( const CancellationToken& ) = delete;
+
+            /**
+             * The flag.
+             */
+            std::atomic< bool > m_cancelled;
+        };
+    }
+}
+
+#endif  // DI_CANCELLATIONTOKEN_H
+
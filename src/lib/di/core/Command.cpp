@@ -52,21 +52,35 @@ namespace di
 
         void Command::busy()
         {
-            // Cannot be busy anymore.
-            if( isDone() )
+            SPtrVec< Command > merged;
             {
-                return;
+                std::lock_guard< std::mutex > lock( m_stateMutex );
+
+                // Cannot be busy anymore.
+                if( isDone() )
+                {
+                    return;
+                }
+
+                // Change state
+                m_isBusy = true;
+                m_isWaiting = false;
+                m_isDeferred = false;
+                merged = m_merged;
             }
 
             LogD << "Command \"" << getName() << "\", instance " << static_cast< void* >( this ) << ": busy." << LogEnd;
 
-            // Change state and notify
-            m_isBusy = true;
-            m_isWaiting = false;
+            // Notify outside the lock. Observers may query the state.
             if( m_observer )
             {
                 m_observer->busy( shared_from_this() );
             }
+
+            for( auto command : merged )
+            {
+                command->busy();
+            }
         }
 
         bool Command::isBusy() const
@@ -76,16 +90,20 @@ namespace di
 
         void Command::waiting()
         {
-            // Cannot be waiting anymore.
-            if( m_isBusy || isDone() )
             {
-                return;
+                std::lock_guard< std::mutex > lock( m_stateMutex );
+
+                // Cannot be waiting anymore.
+                if( m_isBusy || isDone() )
+                {
+                    return;
+                }
+
+                m_isWaiting = true;
             }
 
             LogD << "Command \"" << getName() << "\", instance " << static_cast< void* >( this ) << ": waiting." << LogEnd;
 
-            // Change state and notify
-            m_isWaiting = true;
             if( m_observer )
             {
                 m_observer->waiting( shared_from_this() );
@@ -97,24 +115,87 @@ namespace di
             return m_isWaiting;
         }
 
+        void Command::defer()
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_stateMutex );
+
+                // Only busy commands can be deferred.
+                if( !m_isBusy || isDone() )
+                {
+                    return;
+                }
+
+                m_isDeferred = true;
+            }
+
+            LogD << "Command \"" << getName() << "\", instance " << static_cast< void* >( this ) << ": deferred." << LogEnd;
+        }
+
+        void Command::deferredBusy()
+        {
+            SPtrVec< Command > merged;
+            {
+                std::lock_guard< std::mutex > lock( m_stateMutex );
+
+                // Only deferred commands continue asynchronously.
+                if( !m_isDeferred || isDone() )
+                {
+                    return;
+                }
+
+                merged = m_merged;
+            }
+
+            LogD << "Command \"" << getName() << "\", instance " << static_cast< void* >( this ) << ": busy (deferred)." << LogEnd;
+
+            if( m_observer )
+            {
+                m_observer->busy( shared_from_this() );
+            }
+
+            for( auto command : merged )
+            {
+                command->busy();
+            }
+        }
+
+        bool Command::isDeferred() const
+        {
+            return m_isDeferred;
+        }
+
         void Command::success()
         {
-            // Ignore the case if it already was marked as somehow finished or if it is still waiting.
-            if( isDone() || m_isWaiting )
+            SPtrVec< Command > merged;
             {
-                return;
+                std::lock_guard< std::mutex > lock( m_stateMutex );
+
+                // Ignore the case if it already was marked as somehow finished or if it is still waiting.
+                if( isDone() || m_isWaiting )
+                {
+                    return;
+                }
+
+                // Change state
+                m_isWaiting = false;
+                m_isBusy = false;
+                m_isDeferred = false;
+                m_isSuccessful = true;
+                merged = m_merged;
             }
 
             LogD << "Command \"" << getName() << "\", instance " << static_cast< void* >( this ) << ": success." << LogEnd;
 
-            // Change state and notify
-            m_isSuccessful = true;
-            m_isWaiting = false;
-            m_isBusy = false;
             if( m_observer )
             {
                 m_observer->success( shared_from_this() );
             }
+
+            for( auto command : merged )
+            {
+                command->success();
+            }
         }
 
         bool Command::isSuccessful() const
@@ -124,23 +205,36 @@ namespace di
 
         void Command::abort()
         {
-            // Ignore the case if it already was marked as somehow finished.
-            if( isDone() )
+            SPtrVec< Command > merged;
             {
-                return;
+                std::lock_guard< std::mutex > lock( m_stateMutex );
+
+                // Ignore the case if it already was marked as somehow finished.
+                if( isDone() )
+                {
+                    return;
+                }
+
+                // Change state
+                m_isWaiting = false;
+                m_isBusy = false;
+                m_isDeferred = false;
+                m_isSuccessful = false;
+                m_isAborted = true;
+                merged = m_merged;
             }
 
             LogD << "Command \"" << getName() << "\", instance " << static_cast< void* >( this ) << ": abort." << LogEnd;
 
-            // Change state and notify
-            m_isAborted = true;
-            m_isWaiting = false;
-            m_isBusy = false;
-            m_isSuccessful = false;
             if( m_observer )
             {
                 m_observer->abort( shared_from_this() );
             }
+
+            for( auto command : merged )
+            {
+                command->abort();
+            }
         }
 
         bool Command::isAborted() const
@@ -150,25 +244,38 @@ namespace di
 
         void Command::fail( const std::string& reason )
         {
-            // Ignore the case if it already was marked as somehow finished or if it is still waiting.
-            if( isDone() || m_isWaiting )
+            SPtrVec< Command > merged;
             {
-                return;
+                std::lock_guard< std::mutex > lock( m_stateMutex );
+
+                // Ignore the case if it already was marked as somehow finished or if it is still waiting.
+                if( isDone() || m_isWaiting )
+                {
+                    return;
+                }
+
+                // Change state. The reason is set first, so it is valid as soon as isFailed() is true.
+                m_failureReason = reason;
+                m_isWaiting = false;
+                m_isBusy = false;
+                m_isDeferred = false;
+                m_isSuccessful = false;
+                m_isAborted = true;
+                m_isFailed = true;
+                merged = m_merged;
             }
 
             LogE << "Command \"" << getName() << "\", instance " << static_cast< void* >( this ) << ": failed - Reason: " << reason << "" << LogEnd;
 
-            // Change state and notify
-            m_isFailed = true;
-            m_isAborted = true;
-            m_isWaiting = false;
-            m_isBusy = false;
-            m_isSuccessful = false;
-            m_failureReason = reason;
             if( m_observer )
             {
                 m_observer->fail( shared_from_this() );
             }
+
+            for( auto command : merged )
+            {
+                command->fail( reason );
+            }
         }
 
         void Command::fail( const std::exception& reason )
@@ -191,5 +298,35 @@ namespace di
         {
             return m_failureReason;
         }
+
+        Command::Priority Command::getPriority() const
+        {
+            return Priority::Normal;
+        }
+
+        bool Command::canMerge( ConstSPtr< Command > /* later */ ) const
+        {
+            return false;
+        }
+
+        bool Command::canMoveBefore( ConstSPtr< Command > /* earlier */ ) const
+        {
+            return false;
+        }
+
+        void Command::merge( SPtr< Command > later )
+        {
+            LogD << "Command \"" << later->getName() << "\", instance " << static_cast< void* >( later.get() ) << ": merged into instance "
+                 << static_cast< void* >( this ) << "." << LogEnd;
+
+            std::lock_guard< std::mutex > lock( m_stateMutex );
+            m_merged.push_back( later );
+        }
+
+        SPtrVec< Command > Command::getMergedCommands() const
+        {
+            std::lock_guard< std::mutex > lock( m_stateMutex );
+            return m_merged;
+        }
     }
 }
@@ -25,7 +25,9 @@
 #ifndef DI_COMMAND_H
 #define DI_COMMAND_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <exception>
 #include <string>
 
@@ -44,11 +46,28 @@ namespace di
          *
          * You can specify an CommandObserver instance during construction to get informed about changes in the command's state.
          *
+         * The state is thread-safe. It is changed by the queue thread and by the workers finishing deferred commands, while others query it.
+         *
          * Derive to implement specific commands.
          */
         class Command: public std::enable_shared_from_this< Command >
         {
         public:
+            /**
+             * Priority classes of commands. Command queues process all waiting commands of a higher class before those of a lower class.
+             * Commands of the same class keep their order.
+             */
+            enum class Priority
+            {
+                High = 0,   //!< commands that should not wait behind others, like queries for the UI.
+                Normal      //!< all commands whose order matters. The default.
+            };
+
+            /**
+             * The number of priority classes.
+             */
+            static const size_t NumPriorities = 2;
+
             /**
              * Create an empty command. Derive to add a meaning.
              *
@@ -116,6 +135,26 @@ namespace di
              */
             virtual bool isWaiting() const;
 
+            /**
+             * The command is busy but its processing continues asynchronously. The command-queue does not mark deferred commands as successful
+             * after processing. Whoever deferred the command is responsible for calling \ref success, \ref fail or \ref abort later. Calling
+             * \ref busy again resets the deferred state.
+             */
+            virtual void defer();
+
+            /**
+             * The asynchronous processing of a deferred command starts. Unlike \ref busy, the command stays deferred. The observer and the merged
+             * commands get notified about the busy state again. Does nothing if the command is not deferred.
+             */
+            virtual void deferredBusy();
+
+            /**
+             * Check whether the command was deferred during processing.
+             *
+             * \return true if deferred.
+             */
+            virtual bool isDeferred() const;
+
             /**
              * Called after finishing the command successfully.
              */
@@ -168,42 +207,99 @@ namespace di
              */
             virtual const std::string& getFailureReason() const;
 
+            /**
+             * The priority class of this command. Override to change. The default is \ref Priority::Normal.
+             *
+             * \return the priority
+             */
+            virtual Priority getPriority() const;
+
+            /**
+             * Check whether the given command can be merged into this one. This means that processing this command also has the effect of
+             * processing the later command. Only called for commands that are still waiting. The default is false.
+             *
+             * \param later the command that got committed after this one.
+             *
+             * \return true if the later command can be merged into this one.
+             */
+            virtual bool canMerge( ConstSPtr< Command > later ) const;
+
+            /**
+             * Check whether this command can be processed before the given, earlier command without changing the outcome. Command queues use this
+             * to find merge candidates further back in the queue. The default is false. Merging is then only done with the direct predecessor.
+             *
+             * \param earlier the command committed earlier and still waiting.
+             *
+             * \return true if the order of both commands does not matter.
+             */
+            virtual bool canMoveBefore( ConstSPtr< Command > earlier ) const;
+
+            /**
+             * Merge the given command into this one. The merged command is not processed on its own. It follows the state of this command
+             * instead. Use \ref canMerge first.
+             *
+             * \param later the command to merge.
+             */
+            virtual void merge( SPtr< Command > later );
+
         protected:
+            /**
+             * Get the commands merged into this one.
+             *
+             * \return a copy of the merged commands, as further commands might get merged concurrently.
+             */
+            SPtrVec< Command > getMergedCommands() const;
+
         private:
             /**
              * The observer
              */
             SPtr< CommandObserver > m_observer = nullptr;
 
+            /**
+             * Serializes the state transitions and guards \ref m_merged. The flags are atomic so the getters do not need to lock.
+             */
+            mutable std::mutex m_stateMutex;
+
             /**
              * State: waiting.
              */
-            bool m_isWaiting = false;
+            std::atomic< bool > m_isWaiting{ false };
 
             /**
              * State: busy.
              */
-            bool m_isBusy = false;
+            std::atomic< bool > m_isBusy{ false };
+
+            /**
+             * State: busy and processed asynchronously.
+             */
+            std::atomic< bool > m_isDeferred{ false };
 
             /**
              * State: done successfully.
              */
-            bool m_isSuccessful = false;
+            std::atomic< bool > m_isSuccessful{ false };
 
             /**
              * State: aborted.
              */
-            bool m_isAborted = false;
+            std::atomic< bool > m_isAborted{ false };
 
             /**
              * State: failed.
              */
-            bool m_isFailed = false;
+            std::atomic< bool > m_isFailed{ false };
 
             /**
-             * The reason for failure.
+             * The reason for failure. Set before \ref m_isFailed and never changed afterwards.
              */
             std::string m_failureReason = "";
+
+            /**
+             * The commands merged into this one. They follow the state of this command.
+             */
+            SPtrVec< Command > m_merged;
         };
     }
 }
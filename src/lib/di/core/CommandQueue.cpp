@@ -24,6 +24,8 @@
 
 #include <string>
 
+#include <di/core/Trace.h>
+
 #include "CommandQueue.h"
 
 #include <di/core/Logger.h>
@@ -33,87 +35,172 @@ namespace di
 {
     namespace core
     {
-        CommandQueue::CommandQueue()
+        CommandQueue::CommandQueue():
+            m_committed( nullptr ),
+            m_sleeping( false ),
+            m_running( false ),
+            m_gracefulStop( true )
         {
         }
 
         CommandQueue::~CommandQueue()
         {
             stop( false );
+
+            // Commands committed after the thread stopped were never taken.
+            Committed* committed = m_committed.exchange( nullptr );
+            while( committed )
+            {
+                Committed* previous = committed->previous;
+                delete committed;
+                committed = previous;
+            }
         }
 
         void CommandQueue::run()
         {
-            // Used to lock the command queue mutex
-            std::unique_lock< std::mutex > lock( m_commandQueueMutex );
+            Trace::setThreadName( "Command Queue" );
 
             // loop and handle ...
             while( m_running )
             {
-                if( m_commandQueue.empty() )
+                // Sort in what was committed meanwhile. This also merges commands.
+                takeCommitted();
+
+                // get command
+                SPtr< Command > command = popCommand();
+                if( !command )
                 {
                     LogD << "Empty queue. Sleeping." << LogEnd;
+                    waitForCommands();
+                    continue;
                 }
 
-                // was the thread notified again?
-                if( !m_notified )
+                processCommand( command );
+            }
+
+            // if stopping, process the remaining commands. Including those committed by the remaining commands.
+            for( takeCommitted(); auto command = popCommand(); takeCommitted() )
+            {
+                // If we stop gracefully, we allow each command to be processed.
+                if( m_gracefulStop )
+                {
+                    processCommand( command );
+                }
+                else // for a forced stop, we abort the remaining commands
                 {
-                    // No. We wait.
-                    m_commandQueueCond.wait( lock,
-                                             [ this ]  // keep waiting if not explicitly notified
-                                             {
-                                                 return m_notified || !m_commandQueue.empty();
-                                             }
-                                           );
+                    command->abort();
                 }
-                m_notified = false;
+            }
+        }
+
+        void CommandQueue::commitCommand( SPtr< Command > command )
+        {
+            // Change command state. Before publishing it, as the queue thread owns it afterwards.
+            command->waiting();
+
+            // Push onto the list. Only the queue thread removes elements, and it always takes the whole list. Hence, there is no ABA problem.
+            Committed* committed = new Committed{ command, m_committed.load( std::memory_order_relaxed ) };
+            while( !m_committed.compare_exchange_weak( committed->previous, committed ) )
+            {
+            }
 
-                // stop?
-                if( !m_running )
+            // Notify thread
+            notifyThread();
+        }
+
+        bool CommandQueue::takeCommitted()
+        {
+            Committed* committed = m_committed.exchange( nullptr, std::memory_order_acquire );
+            if( !committed )
+            {
+                return false;
+            }
+
+            // The list is newest first. Reverse to restore commit order.
+            Committed* oldest = nullptr;
+            while( committed )
+            {
+                Committed* previous = committed->previous;
+                committed->previous = oldest;
+                oldest = committed;
+                committed = previous;
+            }
+
+            while( oldest )
+            {
+                Committed* next = oldest->previous;
+                enqueue( oldest->command );
+                delete oldest;
+                oldest = next;
+            }
+            return true;
+        }
+
+        void CommandQueue::enqueue( SPtr< Command > command )
+        {
+            // Find a waiting command to merge with. Look further back as long as the order does not matter. Commands that are re-committed
+            // while busy are continuations and never merged.
+            auto& queue = m_commandQueues[ static_cast< size_t >( command->getPriority() ) ];
+            for( auto earlier = queue.rbegin(); command->isWaiting() && ( earlier != queue.rend() ); ++earlier )
+            {
+                if( ( *earlier )->canMerge( command ) )
                 {
-                    // if stopping, process the remaining commands:
-                    for( auto command : m_commandQueue )
-                    {
-                        // be fool-proof
-                        if( !command )
-                        {
-                            continue;
-                        }
-
-                        // If we stop gracefully, we allow each command to be processed.
-                        if( m_gracefulStop )
-                        {
-                            processCommand( command );
-                        }
-                        else // for a forced stop, we abort the remaining commands
-                        {
-                            command->abort();
-                        }
-                    }
-                    // Cleanup ...
-                    m_commandQueue.clear();
+                    ( *earlier )->merge( command );
+                    return;
                 }
-                else    // business as usual ... process command
+
+                if( !command->canMoveBefore( *earlier ) )
                 {
-                    // get command
-                    SPtr< Command > command;
-                    if( !m_commandQueue.empty() )
-                    {
-                        command = m_commandQueue.front();
-                        m_commandQueue.pop_front();
-                    }
-                    // be fool-proof
-                    if( !command )
-                    {
-                        continue;
-                    }
-
-                    // unlock as this would (otherwise) block the queue itself when "processCommand" is blocking
-                    lock.unlock();
-                    processCommand( command );
-                    lock.lock();
+                    break;
                 }
             }
+
+            queue.push_back( command );
+        }
+
+        SPtr< Command > CommandQueue::popCommand()
+        {
+            for( auto& queue : m_commandQueues )
+            {
+                if( !queue.empty() )
+                {
+                    auto command = queue.front();
+                    queue.pop_front();
+                    return command;
+                }
+            }
+            return nullptr;
+        }
+
+        void CommandQueue::waitForCommands()
+        {
+            // Announce the sleep first, then check again. Committing threads push first, then check m_sleeping. With sequentially consistent
+            // ordering, at least one side sees the other. Either this thread sees the command, or the committing thread wakes it up.
+            m_sleeping = true;
+
+            std::unique_lock< std::mutex > lock( m_sleepMutex );
+            m_commandQueueCond.wait( lock,
+                                     [ this ]  // keep waiting if nothing was committed
+                                     {
+                                         return !m_running || ( m_committed.load() != nullptr );
+                                     }
+                                   );
+
+            m_sleeping = false;
+        }
+
+        void CommandQueue::notifyThread()
+        {
+            // Lock-free if the queue thread is busy anyway.
+            if( !m_sleeping )
+            {
+                return;
+            }
+
+            // Lock to ensure the thread either did not yet check for commands or is already waiting.
+            std::lock_guard< std::mutex > lock( m_sleepMutex );
+            m_commandQueueCond.notify_one();
         }
 
         void CommandQueue::processCommand( SPtr< Command > command )
@@ -125,6 +212,7 @@ namespace di
             }
 
             // The command is now busy ...
+            TraceSpan span( "command", command->getName(), command->getDescription() );
             command->busy();
             try
             {
@@ -139,6 +227,12 @@ namespace di
                 command->fail( "Unknown exception occurred." );
             }
 
+            // Deferred commands get finished by whoever deferred them.
+            if( command->isDeferred() )
+            {
+                return;
+            }
+
             // maybe someone is waiting ... notify
             command->success();
         }
@@ -156,10 +250,16 @@ namespace di
             m_thread = SPtr< std::thread >( new std::thread( &CommandQueue::run, this ) );
         }
 
+        bool CommandQueue::isStarted() const
+        {
+            return m_thread != nullptr;
+        }
+
         void CommandQueue::stop( bool graceful )
         {
-            m_running = false;
+            // Set before stopping, as the thread might stop right away.
             m_gracefulStop = graceful;
+            m_running = false;
             if( m_thread )
             {
                 notifyThread();
@@ -167,12 +267,5 @@ namespace di
                 m_thread = nullptr;
             }
         }
-
-        void CommandQueue::notifyThread()
-        {
-            // Always set this variable to ensure that a busy thread continues to work if it is not waiting on m_commandQueueCond right now.
-            m_notified = true;
-            m_commandQueueCond.notify_one();
-        }
     }
 }
@@ -25,6 +25,8 @@
 #ifndef DI_COMMANDQUEUE_H
 #define DI_COMMANDQUEUE_H
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <list>
 #include <mutex>
@@ -41,6 +43,13 @@ namespace di
     {
         /**
          * Implements a command queue. Commit commands to the queue and they will be processed in a separate thread. Class is abstract.
+         *
+         * Commands are processed by priority class, see \ref Command::Priority. Within a class, they are processed in commit order. Committed
+         * commands get merged into waiting ones if possible, see \ref Command::canMerge. This way, a burst of network runs results in a single
+         * run.
+         *
+         * Committing is lock-free. Committed commands are pushed onto an atomic list. The queue thread takes the whole list at once and sorts it
+         * into its priority queues. Only committing to a sleeping queue thread takes a lock to wake it up.
         */
         class CommandQueue
         {
@@ -68,6 +77,13 @@ namespace di
              */
             virtual void stop( bool graceful = true );
 
+            /**
+             * Check whether the queue thread was started and not yet stopped. Call only from the thread that starts and stops the queue.
+             *
+             * \return true between \ref start and the end of \ref stop.
+             */
+            bool isStarted() const;
+
             /**
              * Commit the command to the queue.
              *
@@ -78,21 +94,7 @@ namespace di
             template< typename CommandType >
             SPtr< CommandType > commit( SPtr< CommandType > command )
             {
-                // grab lock
-                std::unique_lock< std::mutex > theLock( m_commandQueueMutex );
-
-                // add and notify processing thread ...
-                m_commandQueue.push_back( command );
-
-                // Change command state.
-                command->waiting();
-
-                // Done.
-                theLock.unlock();
-
-                // Notify thread
-                notifyThread();
-
+                commitCommand( command );
                 return command;
             }
 
@@ -109,53 +111,110 @@ namespace di
              */
             virtual void process( SPtr< Command > command ) = 0;
 
+            /**
+             * Handle a single command. This marks the command busy, calls \ref process and marks it as successful or failed afterwards. Commands
+             * that got deferred by \ref process are left untouched. Use this to re-process deferred commands from within the queue thread.
+             *
+             * \param command the command to handle
+             */
+            void processCommand( SPtr< Command > command );
+
         private:
             /**
-             * The thread of this command queue.
+             * A committed command in the list of committed commands.
              */
-            SPtr< std::thread > m_thread = nullptr;
+            struct Committed
+            {
+                /**
+                 * The command.
+                 */
+                SPtr< Command > command;
+
+                /**
+                 * The command committed before. Null if this is the oldest one.
+                 */
+                Committed* previous;
+            };
 
             /**
-             * The actual command queue.
+             * Push the command onto the list of committed commands and wake up the queue thread if needed. Lock-free unless the thread sleeps.
+             *
+             * \param command the command to commit.
              */
-            std::list< SPtr< Command > > m_commandQueue;
+            void commitCommand( SPtr< Command > command );
 
             /**
-             * Securing the command queue during processing.
+             * Move all committed commands to the queue of their priority class or merge them into waiting commands. Only called by the queue
+             * thread.
+             *
+             * \return true if there were committed commands.
              */
-            std::mutex m_commandQueueMutex;
+            bool takeCommitted();
 
             /**
-             * Used to notify the processing thread.
+             * Add the command to the queue of its priority class or merge it into a waiting command. Only called by the queue thread.
+             *
+             * \param command the command to enqueue.
              */
-            std::condition_variable m_commandQueueCond;
+            void enqueue( SPtr< Command > command );
 
             /**
-             * Denotes whether the queue thread is curring.
+             * Take the next command to process. Only called by the queue thread.
+             *
+             * \return the command of the highest priority class that was committed first. Null if there is none.
              */
-            bool m_running = false;
+            SPtr< Command > popCommand();
 
             /**
-             * Stop the command queue the graceful way. Finish all commands and stop.
+             * Sleep until commands get committed or the queue is stopped. Only called by the queue thread.
              */
-            bool m_gracefulStop = true;
+            void waitForCommands();
 
             /**
-             * Handles thread notification.
+             * Wake up the queue thread if it sleeps.
              */
             void notifyThread();
 
             /**
-             * If true, the thread was notified in the past (before the wait call).
+             * The thread of this command queue.
              */
-            bool m_notified = false;
+            SPtr< std::thread > m_thread = nullptr;
 
             /**
-             * Handle a single command.
-             *
-             * \param command the command to handle
+             * The committed commands not yet taken by the queue thread. The newest first. Pushed lock-free by any thread, taken as a whole by the
+             * queue thread.
              */
-            void processCommand( SPtr< Command > command );
+            std::atomic< Committed* > m_committed;
+
+            /**
+             * The actual command queues. One per priority class, indexed by the priority. Only accessed by the queue thread.
+             */
+            std::array< std::list< SPtr< Command > >, Command::NumPriorities > m_commandQueues;
+
+            /**
+             * True while the queue thread sleeps or is about to. Committing threads only need to wake it up then.
+             */
+            std::atomic< bool > m_sleeping;
+
+            /**
+             * Used with m_commandQueueCond to let the queue thread sleep.
+             */
+            std::mutex m_sleepMutex;
+
+            /**
+             * Used to notify the processing thread.
+             */
+            std::condition_variable m_commandQueueCond;
+
+            /**
+             * Denotes whether the queue thread is running.
+             */
+            std::atomic< bool > m_running;
+
+            /**
+             * Stop the command queue the graceful way. Finish all commands and stop.
+             */
+            std::atomic< bool > m_gracefulStop;
         };
     }
 }
@@ -0,0 +1,528 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef DI_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+#ifdef DI_HAVE_ZSTD
+    #include <zstd.h>
+#endif
+
+#include <di/core/Filesystem.h>
+#include <di/core/StringUtils.h>
+
+#include "CompressedFile.h"
+
+#include <di/core/Logger.h>
+#define LogTag "core/CompressedFile"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Size of the chunks read from compressed files.
+         */
+        const size_t compressedChunkSize = 4 * 1024 * 1024;
+
+        /**
+         * Number of chunks the reader thread may read ahead.
+         */
+        const size_t compressedChunksAhead = 4;
+
+        /**
+         * Source of compressed data. Provides the next chunk via data and size. Returns false at the end of the data. The chunk stays valid until
+         * the next call.
+         */
+        typedef std::function< bool( const char*& data, size_t& size ) > ChunkSource;
+
+        /**
+         * Reads a file chunk by chunk in a background thread. The caller decompresses the previous chunks meanwhile.
+         */
+        class ChunkPrefetcher
+        {
+        public:
+            /**
+             * Open the file and start reading.
+             *
+             * \param filename the file
+             *
+             * \throw std::ios_base::failure if the file cannot be opened
+             */
+            explicit ChunkPrefetcher( const std::string& filename ):
+                m_filename( filename ),
+                m_in( filename, std::ios::binary )
+            {
+                if( !m_in.good() )
+                {
+                    throw std::ios_base::failure( "Could not open \"" + filename + "\"." );
+                }
+                m_thread = std::thread( &ChunkPrefetcher::run, this );
+            }
+
+            /**
+             * Destructor. Stops reading if the caller gave up early.
+             */
+            ~ChunkPrefetcher()
+            {
+                {
+                    std::lock_guard< std::mutex > lock( m_mutex );
+                    m_stop = true;
+                }
+                m_changed.notify_all();
+                m_thread.join();
+            }
+
+            /**
+             * Wait for the next chunk. Usable as \ref ChunkSource.
+             *
+             * \param data the chunk data
+             * \param size the chunk size
+             *
+             * \throw std::ios_base::failure if reading failed
+             *
+             * \return false if the whole file was read.
+             */
+            bool next( const char*& data, size_t& size )
+            {
+                std::unique_lock< std::mutex > lock( m_mutex );
+                m_changed.wait( lock, [ this ]() { return !m_chunks.empty() || m_done; } );
+                if( m_chunks.empty() )
+                {
+                    if( m_failed )
+                    {
+                        throw std::ios_base::failure( "Could not read \"" + m_filename + "\"." );
+                    }
+                    return false;
+                }
+
+                m_current = std::move( m_chunks.front() );
+                m_chunks.pop_front();
+                lock.unlock();
+                m_changed.notify_all();
+
+                data = m_current.data();
+                size = m_current.size();
+                return true;
+            }
+
+        protected:
+        private:
+            /**
+             * The reader thread.
+             */
+            void run()
+            {
+                while( true )
+                {
+                    std::vector< char > chunk( compressedChunkSize );
+                    m_in.read( chunk.data(), chunk.size() );
+                    chunk.resize( static_cast< size_t >( m_in.gcount() ) );
+
+                    std::unique_lock< std::mutex > lock( m_mutex );
+                    if( !chunk.empty() )
+                    {
+                        m_chunks.push_back( std::move( chunk ) );
+                    }
+                    if( !m_in.good() )
+                    {
+                        m_failed = !m_in.eof();
+                        m_done = true;
+                    }
+                    m_changed.notify_all();
+                    m_changed.wait( lock, [ this ]() { return ( m_chunks.size() < compressedChunksAhead ) || m_stop; } );
+                    if( m_done || m_stop )
+                    {
+                        return;
+                    }
+                }
+            }
+
+            /**
+             * The file.
+             */
+            std::string m_filename;
+
+            /**
+             * The stream to read.
+             */
+            std::ifstream m_in;
+
+            /**
+             * The reader thread.
+             */
+            std::thread m_thread;
+
+            /**
+             * Protects the chunk queue and flags.
+             */
+            std::mutex m_mutex;
+
+            /**
+             * Signals new chunks, consumed chunks and stop requests.
+             */
+            std::condition_variable m_changed;
+
+            /**
+             * Chunks read but not yet consumed.
+             */
+            std::deque< std::vector< char > > m_chunks;
+
+            /**
+             * The chunk currently used by the caller.
+             */
+            std::vector< char > m_current;
+
+            /**
+             * True if the reader thread is done.
+             */
+            bool m_done = false;
+
+            /**
+             * True if reading failed before the end of the file.
+             */
+            bool m_failed = false;
+
+            /**
+             * True if the caller does not need more data.
+             */
+            bool m_stop = false;
+        };
+
+        /**
+         * Make sure there is free space behind the decompressed data. Grows the buffer geometrically.
+         *
+         * \param output the buffer
+         * \param produced the number of bytes used
+         */
+        void reserveOutput( std::vector< char >& output, size_t produced )
+        {
+            if( produced == output.size() )
+            {
+                output.resize( std::max( 2 * output.size(), compressedChunkSize ) );
+            }
+        }
+
+        /**
+         * Decompress gzip or zlib data.
+         *
+         * \param source provides the compressed data
+         * \param output the decompressed data. Existing size is used as initial buffer. Resized to the decompressed size.
+         * \param name the name of the data. For error messages.
+         *
+         * \throw std::ios_base::failure if the data is invalid or zlib is not available.
+         */
+        void decompressGzip( const ChunkSource& source, std::vector< char >& output, const std::string& name )
+        {
+#ifdef DI_HAVE_ZLIB
+            z_stream stream;
+            std::memset( &stream, 0, sizeof( stream ) );
+            // 15 bits window + 32: detect zlib and gzip headers automatically.
+            if( inflateInit2( &stream, 15 + 32 ) != Z_OK )
+            {
+                throw std::ios_base::failure( "Could not initialize decompression of \"" + name + "\"." );
+            }
+
+            size_t produced = 0;
+            int result = Z_OK;
+            try
+            {
+                const char* chunk = nullptr;
+                size_t chunkSize = 0;
+                while( source( chunk, chunkSize ) )
+                {
+                    while( chunkSize > 0 )
+                    {
+                        // Gzip allows to concatenate multiple members.
+                        if( result == Z_STREAM_END )
+                        {
+                            inflateReset( &stream );
+                        }
+
+                        size_t input = std::min( chunkSize, static_cast< size_t >( std::numeric_limits< uInt >::max() ) );
+                        stream.next_in = reinterpret_cast< Bytef* >( const_cast< char* >( chunk ) );
+                        stream.avail_in = static_cast< uInt >( input );
+                        do
+                        {
+                            reserveOutput( output, produced );
+                            size_t space = std::min( output.size() - produced, static_cast< size_t >( std::numeric_limits< uInt >::max() ) );
+                            stream.next_out = reinterpret_cast< Bytef* >( output.data() + produced );
+                            stream.avail_out = static_cast< uInt >( space );
+                            result = inflate( &stream, Z_NO_FLUSH );
+                            if( ( result != Z_OK ) && ( result != Z_STREAM_END ) && ( result != Z_BUF_ERROR ) )
+                            {
+                                throw std::ios_base::failure( "Could not decompress \"" + name + "\": " +
+                                                              ( stream.msg ? stream.msg : "invalid data" ) + "." );
+                            }
+                            produced += space - stream.avail_out;
+                        }
+                        while( ( result != Z_STREAM_END ) && ( ( stream.avail_in > 0 ) || ( stream.avail_out == 0 ) ) );
+
+                        size_t consumed = input - stream.avail_in;
+                        chunk += consumed;
+                        chunkSize -= consumed;
+                    }
+                }
+                if( result != Z_STREAM_END )
+                {
+                    throw std::ios_base::failure( "Compressed data in \"" + name + "\" is truncated." );
+                }
+            }
+            catch( ... )
+            {
+                inflateEnd( &stream );
+                throw;
+            }
+            inflateEnd( &stream );
+            output.resize( produced );
+#else
+            ( void )source;
+            ( void )output;
+            throw std::ios_base::failure( "Cannot decompress \"" + name + "\". This build does not support gzip." );
+#endif
+        }
+
+        /**
+         * Decompress zstd data.
+         *
+         * \param source provides the compressed data
+         * \param output the decompressed data. Existing size is used as initial buffer. Resized to the decompressed size.
+         * \param name the name of the data. For error messages.
+         *
+         * \throw std::ios_base::failure if the data is invalid or zstd is not available.
+         */
+        void decompressZstd( const ChunkSource& source, std::vector< char >& output, const std::string& name )
+        {
+#ifdef DI_HAVE_ZSTD
+            ZSTD_DStream* stream = ZSTD_createDStream();
+            if( !stream || ZSTD_isError( ZSTD_initDStream( stream ) ) )
+            {
+                ZSTD_freeDStream( stream );
+                throw std::ios_base::failure( "Could not initialize decompression of \"" + name + "\"." );
+            }
+
+            size_t produced = 0;
+            size_t result = 0;
+            try
+            {
+                const char* chunk = nullptr;
+                size_t chunkSize = 0;
+                while( source( chunk, chunkSize ) )
+                {
+                    ZSTD_inBuffer in = { chunk, chunkSize, 0 };
+                    while( true )
+                    {
+                        reserveOutput( output, produced );
+                        ZSTD_outBuffer out = { output.data() + produced, output.size() - produced, 0 };
+                        result = ZSTD_decompressStream( stream, &out, &in );
+                        if( ZSTD_isError( result ) )
+                        {
+                            throw std::ios_base::failure( "Could not decompress \"" + name + "\": " + ZSTD_getErrorName( result ) + "." );
+                        }
+                        produced += out.pos;
+
+                        // Done with this chunk if all input is consumed and the decoder does not have more output pending.
+                        if( ( in.pos == in.size ) && ( out.pos < out.size ) )
+                        {
+                            break;
+                        }
+                    }
+                }
+                if( result != 0 )
+                {
+                    throw std::ios_base::failure( "Compressed data in \"" + name + "\" is truncated." );
+                }
+            }
+            catch( ... )
+            {
+                ZSTD_freeDStream( stream );
+                throw;
+            }
+            ZSTD_freeDStream( stream );
+            output.resize( produced );
+#else
+            ( void )source;
+            ( void )output;
+            throw std::ios_base::failure( "Cannot decompress \"" + name + "\". This build does not support zstd." );
+#endif
+        }
+
+        /**
+         * Guess the decompressed size to avoid re-allocations. Gzip stores the size modulo 2^32 at the end, zstd optionally in the frame header.
+         *
+         * \param filename the file
+         * \param compression the compression of the file
+         *
+         * \return the guess. 0 if unknown.
+         */
+        size_t getDecompressedSizeHint( const std::string& filename, Compression compression )
+        {
+            std::ifstream in( filename, std::ios::binary | std::ios::ate );
+            if( !in.good() )
+            {
+                return 0;
+            }
+            size_t compressedSize = static_cast< size_t >( in.tellg() );
+
+            if( ( compression == Compression::Gzip ) && ( compressedSize >= 4 ) )
+            {
+                unsigned char size[ 4 ];
+                in.seekg( -4, std::ios::end );
+                if( in.read( reinterpret_cast< char* >( size ), 4 ) )
+                {
+                    size_t hint = static_cast< size_t >( size[ 0 ] ) | ( static_cast< size_t >( size[ 1 ] ) << 8 ) |
+                                  ( static_cast< size_t >( size[ 2 ] ) << 16 ) | ( static_cast< size_t >( size[ 3 ] ) << 24 );
+                    // The size wraps at 4GB. It cannot be smaller than the compressed data in that case.
+                    return std::max( hint, compressedSize );
+                }
+            }
+#ifdef DI_HAVE_ZSTD
+            if( compression == Compression::Zstd )
+            {
+                // The frame header has at most 18 bytes.
+                char header[ 18 ];
+                in.seekg( 0, std::ios::beg );
+                in.read( header, sizeof( header ) );
+                unsigned long long hint = ZSTD_getFrameContentSize( header, static_cast< size_t >( in.gcount() ) );
+                if( ( hint != ZSTD_CONTENTSIZE_UNKNOWN ) && ( hint != ZSTD_CONTENTSIZE_ERROR ) )
+                {
+                    return static_cast< size_t >( hint );
+                }
+            }
+#endif
+            return compressedSize;
+        }
+
+        Compression getFileCompression( const std::string& filename )
+        {
+            std::string ext = toLower( getFileExtension( filename ) );
+            if( ext == "gz" )
+            {
+                return Compression::Gzip;
+            }
+            if( ( ext == "zst" ) || ( ext == "zstd" ) )
+            {
+                return Compression::Zstd;
+            }
+            return Compression::None;
+        }
+
+        bool isCompressionSupported( Compression compression )
+        {
+            switch( compression )
+            {
+                case Compression::None:
+                    return true;
+                case Compression::Gzip:
+#ifdef DI_HAVE_ZLIB
+                    return true;
+#else
+                    return false;
+#endif
+                case Compression::Zstd:
+#ifdef DI_HAVE_ZSTD
+                    return true;
+#else
+                    return false;
+#endif
+            }
+            return false;
+        }
+
+        std::string getUncompressedFilename( const std::string& filename )
+        {
+            if( getFileCompression( filename ) == Compression::None )
+            {
+                return filename;
+            }
+            return filename.substr( 0, filename.find_last_of( "." ) );
+        }
+
+        SPtr< MappedFile > openFile( const std::string& filename )
+        {
+            Compression compression = getFileCompression( filename );
+            if( compression == Compression::None )
+            {
+                return std::make_shared< MappedFile >( filename );
+            }
+            if( !isCompressionSupported( compression ) )
+            {
+                throw std::ios_base::failure( "Cannot decompress \"" + filename + "\". This build does not support the compression format." );
+            }
+
+            std::vector< char > data( getDecompressedSizeHint( filename, compression ) );
+            ChunkPrefetcher prefetcher( filename );
+            ChunkSource source = [ &prefetcher ]( const char*& chunk, size_t& size )
+            {
+                return prefetcher.next( chunk, size );
+            };
+            if( compression == Compression::Gzip )
+            {
+                decompressGzip( source, data, filename );
+            }
+            else
+            {
+                decompressZstd( source, data, filename );
+            }
+
+            LogD << "Decompressed \"" << filename << "\" (" << data.size() << " bytes)." << LogEnd;
+            return std::make_shared< MappedFile >( filename, std::move( data ) );
+        }
+
+        void inflateData( const uint8_t* data, size_t size, std::vector< uint8_t >& result )
+        {
+            bool consumed = false;
+            ChunkSource source = [ & ]( const char*& chunk, size_t& chunkSize )
+            {
+                if( consumed )
+                {
+                    return false;
+                }
+                chunk = reinterpret_cast< const char* >( data );
+                chunkSize = size;
+                consumed = true;
+                return true;
+            };
+
+            std::vector< char > output( 4 * size );
+            decompressGzip( source, output, "compressed data" );
+            result.assign( output.begin(), output.end() );
+        }
+    }
+}
@@ -0,0 +1,104 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#ifndef DI_COMPRESSEDFILE_H
+#define DI_COMPRESSEDFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <di/core/MappedFile.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Compression formats of input files. Detected by the file extension.
+         */
+        enum class Compression
+        {
+            None,   //!< plain file
+            Gzip,   //!< ".gz"
+            Zstd    //!< ".zst"
+        };
+
+        /**
+         * Query the compression of a file by its extension.
+         *
+         * \param filename the file
+         *
+         * \return the compression
+         */
+        Compression getFileCompression( const std::string& filename );
+
+        /**
+         * Check whether this build can decompress the given format.
+         *
+         * \param compression the format
+         *
+         * \return true if supported.
+         */
+        bool isCompressionSupported( Compression compression );
+
+        /**
+         * Strip the compression extension. Readers use this to check the actual format: "mesh.ply.gz" becomes "mesh.ply".
+         *
+         * \param filename the file
+         *
+         * \return the filename without compression extension. Unchanged for uncompressed files.
+         */
+        std::string getUncompressedFilename( const std::string& filename );
+
+        /**
+         * Open a file for reading. Uncompressed files are mapped. Compressed files are decompressed into memory. Reading the file is done in a
+         * background thread while the data is being decompressed, so slow storage and decompression overlap. No temporary files are needed.
+         *
+         * \param filename the file
+         *
+         * \throw std::ios_base::failure if the file cannot be read or decompressed.
+         *
+         * \return the file contents
+         */
+        SPtr< MappedFile > openFile( const std::string& filename );
+
+        /**
+         * Decompress zlib or gzip data in memory. The format is detected automatically.
+         *
+         * \param data the compressed data
+         * \param size the size in bytes
+         * \param result the decompressed data. Replaced.
+         *
+         * \throw std::ios_base::failure if the data is invalid or zlib is not available.
+         */
+        void inflateData( const uint8_t* data, size_t size, std::vector< uint8_t >& result );
+    }
+}
+
+#endif  // DI_COMPRESSEDFILE_H
+
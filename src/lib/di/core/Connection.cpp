@@ -56,8 +56,8 @@ namespace di
         {
             m_packageInfo = "0";
 
-            // only propagate if needed
-            if( m_target->getTransferable() != m_source->getTransferable() )
+            // only propagate if needed. NOTE: compare with the unconverted data. Converting connectors would always differ otherwise.
+            if( m_target->getSourceTransferable() != m_source->getTransferable() )
             {
                 m_target->setTransferable( m_source->getTransferable() );
 
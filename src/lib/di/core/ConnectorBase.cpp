@@ -51,6 +51,11 @@ namespace di
         {
             return m_description;
         }
+
+        ConstSPtr< ConnectorTransferable > ConnectorBase::getSourceTransferable() const
+        {
+            return getTransferable();
+        }
     }
 }
 
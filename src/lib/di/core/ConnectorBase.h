@@ -81,6 +81,14 @@ namespace di
              */
             virtual ConstSPtr< ConnectorTransferable > getTransferable() const = 0;
 
+            /**
+             * Get the data as it was given to \ref setTransferable. Connectors converting their data return the unconverted data here. Use this to
+             * check whether new data needs to be set.
+             *
+             * \return the data. Can be nullptr. By default, this is \ref getTransferable.
+             */
+            virtual ConstSPtr< ConnectorTransferable > getSourceTransferable() const;
+
         protected:
             /**
              * Constructor.
@@ -37,6 +37,11 @@ namespace di
         {
             // clean up
         }
+
+        size_t ConnectorTransferable::getMemorySize() const
+        {
+            return 0;
+        }
     }
 }
 
@@ -25,6 +25,7 @@
 #ifndef DI_CONNECTORTRANSFERABLE_H
 #define DI_CONNECTORTRANSFERABLE_H
 
+#include <cstddef>
 #include <string>
 
 #include <di/Types.h>
@@ -40,6 +41,13 @@ namespace di
         class ConnectorTransferable
         {
         public:
+            /**
+             * The memory used by this data in bytes. Used for statistics only. Override to provide this. The default returns 0.
+             *
+             * \return the size in bytes or 0 if unknown.
+             */
+            virtual size_t getMemorySize() const;
+
         protected:
             /**
              * Constructor.
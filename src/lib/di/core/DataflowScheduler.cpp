@@ -0,0 +1,278 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <exception>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "DataflowScheduler.h"
+
+#include <di/core/Logger.h>
+#define LogTag "core/DataflowScheduler"
+
+namespace di
+{
+    namespace core
+    {
+        DataflowScheduler::DataflowScheduler( SPtr< WorkerPool > pool ):
+            m_pool( pool )
+        {
+        }
+
+        DataflowScheduler::DataflowScheduler( SPtr< WorkerPool > pool, const DataflowScheduler& graph ):
+            m_pool( pool ),
+            m_nodes( graph.m_nodes )
+        {
+        }
+
+        void DataflowScheduler::addAlgorithm( SPtr< Algorithm > algorithm )
+        {
+            m_nodes[ algorithm ];
+        }
+
+        void DataflowScheduler::addConnection( SPtr< Connection > connection, SPtr< Algorithm > source, SPtr< Algorithm > target )
+        {
+            m_nodes[ source ].outgoing.push_back( std::make_tuple( connection, target ) );
+            m_nodes[ target ].pendingInputs++;
+        }
+
+        void DataflowScheduler::setDataPropagated( SPtr< Algorithm > algorithm )
+        {
+            m_nodes[ algorithm ].dataPropagated = true;
+        }
+
+        void DataflowScheduler::cancel()
+        {
+            m_token.cancel();
+        }
+
+        bool DataflowScheduler::cancelIfStale()
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            for( const auto& node : m_nodes )
+            {
+                if( isStale( node.first, node.second ) )
+                {
+                    LogI << "Algorithm " << *node.first << " changed after it started. Cancelling run." << LogEnd;
+                    m_token.cancel();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool DataflowScheduler::isStale( SPtr< Algorithm > algorithm, const Node& node ) const
+        {
+            // Not yet started or inactive? The run picks up the change anyway or does not care.
+            if( !node.started || !algorithm->isActive() )
+            {
+                return false;
+            }
+            return algorithm->isUpdateRequestedWhileRunning() || ( node.done && algorithm->isUpdateRequested() );
+        }
+
+        std::set< SPtr< Algorithm > > DataflowScheduler::getUnfinishedData() const
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            std::set< SPtr< Algorithm > > result;
+            for( const auto& node : m_nodes )
+            {
+                if( node.second.dataPropagated && !node.second.done )
+                {
+                    result.insert( node.first );
+                }
+            }
+            return result;
+        }
+
+        bool DataflowScheduler::run()
+        {
+            // Start with all algorithms without inputs. Collect first, as dispatching modifies the nodes.
+            std::vector< SPtr< Algorithm > > sources;
+            for( const auto& node : m_nodes )
+            {
+                if( node.second.pendingInputs == 0 )
+                {
+                    sources.push_back( node.first );
+                }
+            }
+
+            for( auto algorithm : sources )
+            {
+                dispatch( algorithm );
+            }
+
+            // Completions dispatch their successors before being counted. Nothing is running anymore once this reaches zero.
+            std::unique_lock< std::mutex > lock( m_mutex );
+            m_completedCond.wait( lock, [ this ]() { return m_inFlight == 0; } );
+
+            if( m_error )
+            {
+                std::rethrow_exception( m_error );
+            }
+
+            if( m_token.isCancelled() )
+            {
+                return false;
+            }
+
+            for( const auto& node : m_nodes )
+            {
+                if( !node.second.done )
+                {
+                    LogE << "Algorithm " << *node.first << " was never ready. The network contains a cycle." << LogEnd;
+                }
+            }
+            return true;
+        }
+
+        void DataflowScheduler::dispatch( SPtr< Algorithm > algorithm )
+        {
+            bool dataPropagated = false;
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                if( m_error || m_token.isCancelled() )
+                {
+                    return;
+                }
+                m_inFlight++;
+                auto& node = m_nodes[ algorithm ];
+                node.started = true;
+                dataPropagated = node.dataPropagated;
+            }
+
+            if( !algorithm->isActive() || !( algorithm->isUpdateRequested() || dataPropagated ) )
+            {
+                LogI << "Ignoring algorithm"
+                     << " - " << *algorithm << " { Dirty: " << algorithm->isUpdateRequested() << ", Active: " << algorithm->isActive()
+                     << ", Data: " << dataPropagated << " }"
+                     << LogEnd;
+                complete( algorithm, true, nullptr );
+                return;
+            }
+
+            LogI << "Running algorithm"
+                 << " - " << *algorithm << " { Dirty: " << algorithm->isUpdateRequested() << ", Active: " << algorithm->isActive()
+                 << ", Data: " << dataPropagated << " }"
+                 << LogEnd;
+
+            auto task = [ this, algorithm ]()
+            {
+                std::exception_ptr error;
+                bool finished = true;
+                try
+                {
+                    algorithm->run( m_token );
+
+                    auto statistics = algorithm->getStatistics();
+                    LogI << "Finished algorithm - " << *algorithm << " { Wall: " << statistics.lastWallTime << " ms, CPU: "
+                         << statistics.lastCPUTime << " ms, Input: " << statistics.inputSize << " bytes, Output: " << statistics.outputSize
+                         << " bytes }" << LogEnd;
+                }
+                catch( const OperationCancelled& )
+                {
+                    LogI << "Cancelled algorithm - " << *algorithm << LogEnd;
+                    finished = false;
+                }
+                catch( ... )
+                {
+                    error = std::current_exception();
+                }
+                complete( algorithm, finished, error );
+            };
+
+            // Pool not running? Do it here.
+            if( !m_pool || !m_pool->submit( task ) )
+            {
+                task();
+            }
+        }
+
+        void DataflowScheduler::complete( SPtr< Algorithm > algorithm, bool finished, std::exception_ptr error )
+        {
+            std::vector< std::tuple< SPtr< Connection >, SPtr< Algorithm > > > outgoing;
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                auto& node = m_nodes[ algorithm ];
+                node.done = finished;
+                if( error && !m_error )
+                {
+                    m_error = error;
+                }
+
+                // Changed in between the end of the run and now? This was not seen by cancelIfStale.
+                if( finished && isStale( algorithm, node ) )
+                {
+                    m_token.cancel();
+                }
+
+                // Even if cancelled, the outputs of finished algorithms are propagated. The next run uses them.
+                if( finished && !m_error )
+                {
+                    outgoing = node.outgoing;
+                }
+            }
+
+            // Propagate without holding the lock. Propagation might convert the whole data set and would block all other completions.
+            std::vector< bool > results;
+            for( const auto& edge : outgoing )
+            {
+                auto connection = std::get< 0 >( edge );
+                bool result = connection->propagate();
+                LogD << "Propagation: " << *algorithm << ":" << *connection << ":" << *std::get< 1 >( edge ) << " - Result: " << result << LogEnd;
+                results.push_back( result );
+            }
+
+            // Find the successors that have all their inputs now.
+            std::vector< SPtr< Algorithm > > ready;
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                for( size_t i = 0; i < outgoing.size(); ++i )
+                {
+                    auto target = std::get< 1 >( outgoing[ i ] );
+                    auto& targetNode = m_nodes[ target ];
+                    targetNode.dataPropagated = targetNode.dataPropagated || results[ i ];
+                    targetNode.pendingInputs--;
+                    if( ( targetNode.pendingInputs == 0 ) && !m_token.isCancelled() && !m_error )
+                    {
+                        ready.push_back( target );
+                    }
+                }
+            }
+
+            for( auto successor : ready )
+            {
+                dispatch( successor );
+            }
+
+            // Count this one as completed after the successors are in flight. Notify while holding the lock, as the waiting thread may destroy
+            // this instance right after.
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_inFlight--;
+            m_completedCond.notify_all();
+        }
+    }
+}
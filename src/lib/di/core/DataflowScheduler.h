@@ -0,0 +1,236 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_DATAFLOWSCHEDULER_H
+#define DI_DATAFLOWSCHEDULER_H
+
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <di/core/Algorithm.h>
+#include <di/core/CancellationToken.h>
+#include <di/core/Connection.h>
+#include <di/core/WorkerPool.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Runs a network of algorithms in dataflow order. An algorithm becomes ready as soon as all of its incoming connections have been
+         * propagated. Ready algorithms are run in a worker pool. Their completion propagates their outgoing connections and readies their
+         * successors. Unlike running the network layer by layer, a fast branch never waits for a slow, unrelated one.
+         *
+         * Like in the layered model, an algorithm only runs if it is active and either requested an update or received new data. Algorithms that
+         * do not run still propagate their outgoing connections. The scheduler is meant to be used for a single run.
+         *
+         * A run can be cancelled. The algorithms get the cancellation token of the run. No further algorithms are started after cancellation.
+         * Use \ref getUnfinishedData to continue with a new run later.
+         */
+        class DataflowScheduler
+        {
+        public:
+            /**
+             * Create a scheduler.
+             *
+             * \param pool the pool to run the algorithms in. If it is null or not running, the algorithms are run by the calling thread.
+             */
+            explicit DataflowScheduler( SPtr< WorkerPool > pool );
+
+            /**
+             * Create a scheduler for a new run of the algorithms and connections of another scheduler. Use this to build the graph once and run it
+             * many times.
+             *
+             * \param pool the pool to run the algorithms in. If it is null or not running, the algorithms are run by the calling thread.
+             * \param graph the scheduler to copy the graph from. Needs to be unused, as the state of a run would be copied too.
+             */
+            DataflowScheduler( SPtr< WorkerPool > pool, const DataflowScheduler& graph );
+
+            /**
+             * Destructor.
+             */
+            virtual ~DataflowScheduler() = default;
+
+            /**
+             * Add an algorithm.
+             *
+             * \param algorithm the algorithm
+             */
+            void addAlgorithm( SPtr< Algorithm > algorithm );
+
+            /**
+             * Add a connection between two algorithms. Both need to be added before.
+             *
+             * \param connection the connection
+             * \param source the algorithm providing the data
+             * \param target the algorithm receiving the data
+             */
+            void addConnection( SPtr< Connection > connection, SPtr< Algorithm > source, SPtr< Algorithm > target );
+
+            /**
+             * Mark an algorithm as having received new data already. Use this to continue a cancelled run.
+             *
+             * \param algorithm the algorithm. Needs to be added before.
+             */
+            void setDataPropagated( SPtr< Algorithm > algorithm );
+
+            /**
+             * Run all algorithms and wait for them.
+             *
+             * \throw the first exception thrown by an algorithm. No further algorithms are started after an error. All running algorithms have
+             * finished when this throws.
+             *
+             * \return true if all algorithms were run. False if the run was cancelled.
+             */
+            bool run();
+
+            /**
+             * Cancel the run. Running algorithms see the cancelled token, no further algorithms are started. Thread-safe.
+             */
+            void cancel();
+
+            /**
+             * Cancel the run if its results are outdated. This is the case if an active algorithm that already ran requested another update, or
+             * if an update was requested while it is running. Changes to algorithms that did not yet start are picked up by the run anyway.
+             * Thread-safe.
+             *
+             * \return true if cancelled.
+             */
+            bool cancelIfStale();
+
+            /**
+             * Get the algorithms that received new data but did not finish. After a cancelled run, this data needs to be processed by the next
+             * run.
+             *
+             * \return the algorithms
+             */
+            std::set< SPtr< Algorithm > > getUnfinishedData() const;
+
+        protected:
+        private:
+            /**
+             * An algorithm in the dataflow graph.
+             */
+            struct Node
+            {
+                /**
+                 * The outgoing connections and their target algorithms.
+                 */
+                std::vector< std::tuple< SPtr< Connection >, SPtr< Algorithm > > > outgoing;
+
+                /**
+                 * The number of incoming connections not yet propagated.
+                 */
+                size_t pendingInputs = 0;
+
+                /**
+                 * True if any incoming connection propagated new data.
+                 */
+                bool dataPropagated = false;
+
+                /**
+                 * True once the algorithm was dispatched.
+                 */
+                bool started = false;
+
+                /**
+                 * True once the algorithm was run or skipped. Algorithms that were cancelled are not done.
+                 */
+                bool done = false;
+            };
+
+            /**
+             * Run or skip a ready algorithm.
+             *
+             * \param algorithm the algorithm
+             */
+            void dispatch( SPtr< Algorithm > algorithm );
+
+            /**
+             * Called when an algorithm has finished, was skipped or cancelled. Propagates the outgoing connections of finished algorithms and
+             * dispatches the algorithms that became ready. Propagation is done without holding m_mutex.
+             *
+             * \param algorithm the algorithm
+             * \param finished false if the algorithm was cancelled.
+             * \param error the exception thrown by the algorithm. Null if successful.
+             */
+            void complete( SPtr< Algorithm > algorithm, bool finished, std::exception_ptr error );
+
+            /**
+             * Check whether the results of the given algorithm are outdated. Needs m_mutex to be locked.
+             *
+             * \param algorithm the algorithm
+             * \param node the node of the algorithm
+             *
+             * \return true if outdated.
+             */
+            bool isStale( SPtr< Algorithm > algorithm, const Node& node ) const;
+
+            /**
+             * The pool to run the algorithms.
+             */
+            SPtr< WorkerPool > m_pool;
+
+            /**
+             * The graph.
+             */
+            std::map< SPtr< Algorithm >, Node > m_nodes;
+
+            /**
+             * Protects m_nodes, m_inFlight and m_error during the run.
+             */
+            mutable std::mutex m_mutex;
+
+            /**
+             * Notifies about completed algorithms.
+             */
+            std::condition_variable m_completedCond;
+
+            /**
+             * The number of dispatched algorithms that did not yet complete.
+             */
+            size_t m_inFlight = 0;
+
+            /**
+             * The first error.
+             */
+            std::exception_ptr m_error;
+
+            /**
+             * The token passed to the algorithms.
+             */
+            CancellationToken m_token;
+        };
+    }
+}
+
+#endif  // DI_DATAFLOWSCHEDULER_H
+
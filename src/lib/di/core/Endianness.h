@@ -0,0 +1,81 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_ENDIANNESS_H
+#define DI_ENDIANNESS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Check whether the host stores multi-byte values in little endian order.
+         *
+         * \return true if little endian.
+         */
+        inline bool isLittleEndian()
+        {
+            const uint16_t probe = 1;
+            uint8_t firstByte;
+            std::memcpy( &firstByte, &probe, 1 );
+            return firstByte == 1;
+        }
+
+        /**
+         * Reverse the byte order of a value in-place.
+         *
+         * \tparam ValueType the type of the value. Needs to be trivially copyable.
+         * \param value the value to swap
+         */
+        template< typename ValueType >
+        void swapBytes( ValueType& value )
+        {
+            uint8_t* bytes = reinterpret_cast< uint8_t* >( &value );
+            std::reverse( bytes, bytes + sizeof( ValueType ) );
+        }
+
+        /**
+         * Reverse the byte order of each element in a raw byte buffer.
+         *
+         * \param data the buffer
+         * \param count the number of elements in the buffer
+         * \param elementSize the size of a single element in bytes
+         */
+        inline void swapBytes( void* data, size_t count, size_t elementSize )
+        {
+            uint8_t* bytes = reinterpret_cast< uint8_t* >( data );
+            for( size_t i = 0; i < count; ++i )
+            {
+                std::reverse( bytes + i * elementSize, bytes + ( i + 1 ) * elementSize );
+            }
+        }
+    }
+}
+
+#endif  // DI_ENDIANNESS_H
+
@@ -22,11 +22,16 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <fstream>
 #include <streambuf>
 #include <stdexcept>
+#include <thread>
+
+#include <sys/stat.h>
 
 #include "Filesystem.h"
 
@@ -41,6 +46,16 @@ namespace di
             return filename.substr( filename.find_last_of( "." ) + 1 );
         }
 
+        std::string getFileDirectory( const std::string& filename )
+        {
+            auto separator = filename.find_last_of( "/\\" );
+            if( separator == std::string::npos )
+            {
+                return "";
+            }
+            return filename.substr( 0, separator + 1 );
+        }
+
         std::string readTextFile( const std::string& filename )
         {
             std::ifstream t( filename );
@@ -63,6 +78,25 @@ namespace di
             return str;
         }
 
+        bool getFileInfo( const std::string& filename, uint64_t& size, int64_t& modificationTime )
+        {
+            struct stat info;
+            if( stat( filename.c_str(), &info ) != 0 )
+            {
+                return false;
+            }
+            size = static_cast< uint64_t >( info.st_size );
+            modificationTime = static_cast< int64_t >( info.st_mtime );
+            return true;
+        }
+
+        std::string getTemporaryFilename( const std::string& filename )
+        {
+            // Unique per thread and point in time. Two writers of the same target do not collide.
+            return filename + ".tmp-" + std::to_string( std::hash< std::thread::id >()( std::this_thread::get_id() ) ) + "-" +
+                   std::to_string( std::chrono::steady_clock::now().time_since_epoch().count() );
+        }
+
         static std::string g_runtimePath = "";
 
         std::string getRuntimePath()
@@ -25,6 +25,7 @@
 #ifndef DI_FILESYSTEM_H
 #define DI_FILESYSTEM_H
 
+#include <cstdint>
 #include <string>
 
 // This file implements some utils we all love from boost::filesystem
@@ -42,6 +43,15 @@ namespace di
          */
         std::string getFileExtension( const std::string& filename );
 
+        /**
+         * Get the directory part of a filename.
+         *
+         * \param filename the filename
+         *
+         * \return the directory including the trailing separator. Empty if the filename contains no directory.
+         */
+        std::string getFileDirectory( const std::string& filename );
+
         /**
          * Read a whole text file in to a string.
          *
@@ -53,6 +63,27 @@ namespace di
          */
         std::string readTextFile( const std::string& filename );
 
+        /**
+         * Query size and modification time of a file. Useful to check whether cached data derived from the file is still valid.
+         *
+         * \param filename the file
+         * \param size the size in bytes
+         * \param modificationTime the time of the last modification in seconds since epoch
+         *
+         * \return false if the file does not exist.
+         */
+        bool getFileInfo( const std::string& filename, uint64_t& size, int64_t& modificationTime );
+
+        /**
+         * Get a unique name for a temporary file next to the given file. Write to it and rename it to the target afterwards. This way, readers
+         * never see a partially written file and existing mappings of the target stay valid.
+         *
+         * \param filename the target file
+         *
+         * \return the temporary filename. In the same directory as the target.
+         */
+        std::string getTemporaryFilename( const std::string& filename );
+
         /**
          * The runtime path of the program. Guaranteed to end with a directory separator.
          *
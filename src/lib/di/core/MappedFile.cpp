@@ -0,0 +1,210 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <fstream>
+#include <ios>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+#include <di/core/Logger.h>
+#define LogTag "core/MappedFile"
+
+namespace di
+{
+    namespace core
+    {
+        MappedFile::MappedFile( const std::string& filename ):
+            m_filename( filename )
+        {
+#ifndef _WIN32
+            int fd = open( filename.c_str(), O_RDONLY );
+            if( fd < 0 )
+            {
+                throw std::ios_base::failure( "Could not open \"" + filename + "\"." );
+            }
+
+            struct stat info;
+            if( fstat( fd, &info ) != 0 )
+            {
+                close( fd );
+                throw std::ios_base::failure( "Could not query size of \"" + filename + "\"." );
+            }
+            m_size = static_cast< size_t >( info.st_size );
+
+            // mmap does not like zero-sized mappings
+            if( m_size != 0 )
+            {
+                // Private + writable: the pages are copy-on-write and never go back to the file.
+                void* mapped = mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+                if( mapped == MAP_FAILED )
+                {
+                    close( fd );
+                    throw std::ios_base::failure( "Could not map \"" + filename + "\"." );
+                }
+                m_data = reinterpret_cast< char* >( mapped );
+
+                // We will mostly stream through the file
+                madvise( mapped, m_size, MADV_SEQUENTIAL );
+            }
+
+            // The mapping stays valid without the descriptor
+            close( fd );
+#else
+            std::ifstream in( filename, std::ios::binary | std::ios::ate );
+            if( !in.good() )
+            {
+                throw std::ios_base::failure( "Could not open \"" + filename + "\"." );
+            }
+            m_size = static_cast< size_t >( in.tellg() );
+            m_buffer.resize( m_size );
+            in.seekg( 0, std::ios::beg );
+            if( !in.read( m_buffer.data(), m_size ) )
+            {
+                throw std::ios_base::failure( "Could not read \"" + filename + "\"." );
+            }
+            m_data = m_buffer.data();
+#endif
+            LogD << "Mapped \"" << filename << "\" (" << m_size << " bytes)." << LogEnd;
+        }
+
+        MappedFile::MappedFile( size_t size, const std::string& directory ):
+            m_filename( directory + "di-swap-XXXXXX" ),
+            m_size( size )
+        {
+#ifndef _WIN32
+            std::vector< char > name( m_filename.begin(), m_filename.end() );
+            name.push_back( '\0' );
+            int fd = mkstemp( name.data() );
+            if( fd < 0 )
+            {
+                throw std::ios_base::failure( "Could not create swap file in \"" + directory + "\"." );
+            }
+            m_filename = name.data();
+
+            // Nobody else needs the file. It vanishes as soon as the mapping is gone.
+            unlink( m_filename.c_str() );
+
+            if( ftruncate( fd, static_cast< off_t >( m_size ) ) != 0 )
+            {
+                close( fd );
+                throw std::ios_base::failure( "Could not resize swap file \"" + m_filename + "\"." );
+            }
+
+            if( m_size != 0 )
+            {
+                void* mapped = mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+                if( mapped == MAP_FAILED )
+                {
+                    close( fd );
+                    throw std::ios_base::failure( "Could not map swap file \"" + m_filename + "\"." );
+                }
+                m_data = reinterpret_cast< char* >( mapped );
+            }
+            close( fd );
+#else
+            m_buffer.resize( m_size );
+            m_data = m_buffer.data();
+#endif
+            LogD << "Created swap file \"" << m_filename << "\" (" << m_size << " bytes)." << LogEnd;
+        }
+
+        MappedFile::MappedFile( const std::string& filename, std::vector< char >&& data ):
+            m_filename( filename ),
+            m_size( data.size() ),
+            m_buffer( std::move( data ) )
+        {
+            m_data = m_buffer.empty() ? nullptr : m_buffer.data();
+        }
+
+        MappedFile::~MappedFile()
+        {
+#ifndef _WIN32
+            // Decompressed files live in m_buffer. Only unmap real mappings.
+            if( isMapped() )
+            {
+                munmap( m_data, m_size );
+            }
+#endif
+        }
+
+        char* MappedFile::getData()
+        {
+            return m_data;
+        }
+
+        const char* MappedFile::getData() const
+        {
+            return m_data;
+        }
+
+        size_t MappedFile::getSize() const
+        {
+            return m_size;
+        }
+
+        const std::string& MappedFile::getFilename() const
+        {
+            return m_filename;
+        }
+
+        bool MappedFile::isMapped() const
+        {
+            return m_buffer.empty() && ( m_data != nullptr );
+        }
+
+        void MappedFile::release( size_t offset, size_t length ) const
+        {
+#ifndef _WIN32
+            if( !isMapped() || ( offset >= m_size ) )
+            {
+                return;
+            }
+            length = std::min( length, m_size - offset );
+
+            // madvise wants page boundaries. Shrink the range to whole pages.
+            size_t pageSize = static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+            size_t begin = ( ( offset + pageSize - 1 ) / pageSize ) * pageSize;
+            size_t end = ( ( offset + length ) / pageSize ) * pageSize;
+            if( begin < end )
+            {
+                madvise( m_data + begin, end - begin, MADV_DONTNEED );
+            }
+#else
+            ( void )offset;
+            ( void )length;
+#endif
+        }
+    }
+}
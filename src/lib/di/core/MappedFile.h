@@ -0,0 +1,163 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_MAPPEDFILE_H
+#define DI_MAPPEDFILE_H
+
+#include <string>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A file mapped into memory. The mapping is private: pages are loaded lazily by the OS and writing to them does not modify the file
+         * (copy-on-write). This allows to wrap the file contents directly as data without copying it first. The mapping lives as long as the
+         * instance. Keep a shared pointer to it as long as you use its memory.
+         *
+         * Alternatively, a temporary swap file can be created and mapped. This mapping is shared: changes are written to the file and the OS is
+         * free to page them out. This allows to handle data larger than the physical memory.
+         *
+         * On platforms without mmap support, the file is read into memory completely and swap files are plain memory.
+         */
+        class MappedFile
+        {
+        public:
+            /**
+             * Map the given file.
+             *
+             * \param filename the file to map.
+             *
+             * \throw std::ios_base::failure if the file cannot be opened or mapped.
+             */
+            explicit MappedFile( const std::string& filename );
+
+            /**
+             * Create a temporary swap file of the given size and map it writable. The file is zero-initialized and removed automatically.
+             *
+             * \param size the size in bytes
+             * \param directory the directory where to create the file. Should end with a directory separator.
+             *
+             * \throw std::ios_base::failure if the file cannot be created or mapped.
+             */
+            MappedFile( size_t size, const std::string& directory );
+
+            /**
+             * Wrap data that is already in memory, like the decompressed contents of a file. Nothing is mapped in this case.
+             *
+             * \param filename the file the data belongs to
+             * \param data the data. Moved into the instance.
+             */
+            MappedFile( const std::string& filename, std::vector< char >&& data );
+
+            /**
+             * Destructor. Unmaps the file.
+             */
+            virtual ~MappedFile();
+
+            /**
+             * Get the mapped memory.
+             *
+             * \return the pointer to the first byte. Can be nullptr for empty files.
+             */
+            char* getData();
+
+            /**
+             * Get the mapped memory.
+             *
+             * \return the pointer to the first byte. Can be nullptr for empty files.
+             */
+            const char* getData() const;
+
+            /**
+             * Size of the file in bytes.
+             *
+             * \return the size
+             */
+            size_t getSize() const;
+
+            /**
+             * The file that was mapped.
+             *
+             * \return the filename
+             */
+            const std::string& getFilename() const;
+
+            /**
+             * Check whether the memory is really mapped or a copy of the file.
+             *
+             * \return true if mapped.
+             */
+            bool isMapped() const;
+
+            /**
+             * Hint the OS that the given range is not needed in the near future. The pages are dropped from memory and loaded again from the file
+             * on the next access. Only pages completely inside the range are affected. Never use this on privately mapped pages you modified, as
+             * the changes are lost.
+             *
+             * \param offset the first byte
+             * \param length the number of bytes
+             */
+            void release( size_t offset, size_t length ) const;
+
+        protected:
+        private:
+            /**
+             * Forbid copy.
+             */
+            MappedFile( const MappedFile& ) = delete;
+
+            /**
+             * Forbid copy.
+             *
+             * \return nothing
+             */
+            MappedFile& operator=( const MappedFile& ) = delete;
+
+            /**
+             * The filename.
+             */
+            std::string m_filename;
+
+            /**
+             * The mapped memory.
+             */
+            char* m_data = nullptr;
+
+            /**
+             * The size in bytes.
+             */
+            size_t m_size = 0;
+
+            /**
+             * Used if the file could not be mapped. Contains the whole file.
+             */
+            std::vector< char > m_buffer;
+        };
+    }
+}
+
+#endif  // DI_MAPPEDFILE_H
+
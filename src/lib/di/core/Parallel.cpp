@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+
+#ifndef _WIN32
+    #include <time.h>
+#endif
+
+#include "Parallel.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * The CPU time account of the current thread. See \ref CPUTimeAccount.
+         */
+        static thread_local std::atomic< int64_t >* g_cpuTimeAccount = nullptr;
+
+        size_t getNumberOfThreads()
+        {
+            // NOTE: hardware_concurrency may return 0 if the value is not computable.
+            return std::max( static_cast< size_t >( std::thread::hardware_concurrency() ), static_cast< size_t >( 1 ) );
+        }
+
+        double getThreadCPUTime()
+        {
+#ifndef _WIN32
+            struct timespec time;
+            if( clock_gettime( CLOCK_THREAD_CPUTIME_ID, &time ) == 0 )
+            {
+                return 1000.0 * static_cast< double >( time.tv_sec ) + static_cast< double >( time.tv_nsec ) / 1000000.0;
+            }
+#endif
+            return 1000.0 * static_cast< double >( std::clock() ) / CLOCKS_PER_SEC;
+        }
+
+        CPUTimeAccount::CPUTimeAccount():
+            m_helperTime( 0 ),
+            m_start( getThreadCPUTime() ),
+            m_previous( getCurrent() )
+        {
+            setCurrent( &m_helperTime );
+        }
+
+        CPUTimeAccount::~CPUTimeAccount()
+        {
+            setCurrent( m_previous );
+        }
+
+        double CPUTimeAccount::getCPUTime() const
+        {
+            return ( getThreadCPUTime() - m_start ) + static_cast< double >( m_helperTime.load() ) / 1000000.0;
+        }
+
+        void CPUTimeAccount::add( std::atomic< int64_t >* account, double cpuTime )
+        {
+            if( account )
+            {
+                *account += static_cast< int64_t >( cpuTime * 1000000.0 );
+            }
+        }
+
+        std::atomic< int64_t >* CPUTimeAccount::getCurrent()
+        {
+            return g_cpuTimeAccount;
+        }
+
+        void CPUTimeAccount::setCurrent( std::atomic< int64_t >* account )
+        {
+            g_cpuTimeAccount = account;
+        }
+    }
+}
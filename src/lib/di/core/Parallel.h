@@ -0,0 +1,229 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#ifndef DI_PARALLEL_H
+#define DI_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Query the number of threads to use for data-parallel work. This is the number of hardware threads, at least 1.
+         *
+         * \return the number of threads.
+         */
+        size_t getNumberOfThreads();
+
+        /**
+         * Get the CPU time used by the calling thread so far. Where there is no per-thread clock, the CPU time of the whole process is used.
+         *
+         * \return the CPU time in ms
+         */
+        double getThreadCPUTime();
+
+        /**
+         * Collects the CPU time of a thread and of the helper threads it starts with \ref startHelperThread, which includes the threads of
+         * \ref parallelFor and \ref processSlabs. The account installs itself for the constructing thread and restores the previous account on
+         * destruction. Construct and destroy it on the same thread. Helper threads inherit the account of the thread starting them, so nested
+         * parallel loops are counted too.
+         */
+        class CPUTimeAccount
+        {
+        public:
+            /**
+             * Start counting for the calling thread.
+             */
+            CPUTimeAccount();
+
+            /**
+             * Stop counting and re-install the previous account of the calling thread.
+             */
+            ~CPUTimeAccount();
+
+            /**
+             * The CPU time since construction. This is the time of the constructing thread plus the time of all finished helper threads.
+             *
+             * \return the CPU time in ms
+             */
+            double getCPUTime() const;
+
+            /**
+             * Add the CPU time of a helper thread to the account of the calling thread. Does nothing if there is no account.
+             *
+             * \param account the account to add to. Can be nullptr.
+             * \param cpuTime the CPU time in ms
+             */
+            static void add( std::atomic< int64_t >* account, double cpuTime );
+
+            /**
+             * Get the account of the calling thread.
+             *
+             * \return the account or nullptr if there is none.
+             */
+            static std::atomic< int64_t >* getCurrent();
+
+            /**
+             * Set the account of the calling thread.
+             *
+             * \param account the account. Can be nullptr.
+             */
+            static void setCurrent( std::atomic< int64_t >* account );
+
+        private:
+            /**
+             * The CPU time of the helper threads in ns.
+             */
+            std::atomic< int64_t > m_helperTime;
+
+            /**
+             * The CPU time of the constructing thread at construction.
+             */
+            double m_start;
+
+            /**
+             * The account that was installed before.
+             */
+            std::atomic< int64_t >* m_previous;
+        };
+
+        /**
+         * Start a thread whose CPU time is added to the \ref CPUTimeAccount of the calling thread when it finishes. The new thread inherits the
+         * account. The functor must not throw.
+         *
+         * \tparam FunctionType something callable as func()
+         * \param func the functor
+         *
+         * \return the thread
+         */
+        template< typename FunctionType >
+        std::thread startHelperThread( FunctionType func )
+        {
+            auto account = CPUTimeAccount::getCurrent();
+            return std::thread( [ account, func ]()
+            {
+                CPUTimeAccount::setCurrent( account );
+                double start = getThreadCPUTime();
+                func();
+                CPUTimeAccount::add( account, getThreadCPUTime() - start );
+            } );
+        }
+
+        /**
+         * Split the range [begin, end) into contiguous chunks and process them in parallel. The functor is called once per chunk with the chunk
+         * range and the chunk index. Chunks are numbered in ascending range order. Exceptions thrown by the functor are forwarded to the caller
+         * after all chunks have finished. The first exception (in chunk order) wins. The CPU time of the helper threads is added to the
+         * \ref CPUTimeAccount of the calling thread.
+         *
+         * \tparam FunctionType something callable as func( size_t chunkBegin, size_t chunkEnd, size_t chunkIndex ).
+         * \param begin the first index
+         * \param end the index after the last one
+         * \param func the functor
+         * \param numChunks the number of chunks. If 0, \ref getNumberOfThreads is used. Never creates more chunks than indices.
+         */
+        template< typename FunctionType >
+        void parallelFor( size_t begin, size_t end, FunctionType func, size_t numChunks = 0 )
+        {
+            if( end <= begin )
+            {
+                return;
+            }
+
+            size_t count = end - begin;
+            numChunks = ( numChunks == 0 ) ? getNumberOfThreads() : numChunks;
+            numChunks = std::min( numChunks, count );
+
+            // Nothing to gain. Avoid the thread overhead.
+            if( numChunks == 1 )
+            {
+                func( begin, end, 0 );
+                return;
+            }
+
+            std::vector< std::exception_ptr > errors( numChunks );
+            std::vector< std::thread > threads;
+            threads.reserve( numChunks - 1 );
+
+            // Distribute the remainder among the first chunks
+            size_t chunkSize = count / numChunks;
+            size_t remainder = count % numChunks;
+
+            auto runChunk = [ &func, &errors ]( size_t chunkBegin, size_t chunkEnd, size_t chunkIndex )
+            {
+                try
+                {
+                    func( chunkBegin, chunkEnd, chunkIndex );
+                }
+                catch( ... )
+                {
+                    errors[ chunkIndex ] = std::current_exception();
+                }
+            };
+
+            size_t chunkBegin = begin;
+            for( size_t chunk = 0; chunk < numChunks; ++chunk )
+            {
+                size_t chunkEnd = chunkBegin + chunkSize + ( ( chunk < remainder ) ? 1 : 0 );
+
+                // The calling thread handles the last chunk itself
+                if( chunk + 1 == numChunks )
+                {
+                    runChunk( chunkBegin, chunkEnd, chunk );
+                }
+                else
+                {
+                    threads.push_back( startHelperThread( [ &runChunk, chunkBegin, chunkEnd, chunk ]()
+                    {
+                        runChunk( chunkBegin, chunkEnd, chunk );
+                    } ) );
+                }
+                chunkBegin = chunkEnd;
+            }
+
+            for( auto& thread : threads )
+            {
+                thread.join();
+            }
+
+            for( auto error : errors )
+            {
+                if( error )
+                {
+                    std::rethrow_exception( error );
+                }
+            }
+        }
+    }
+}
+
+#endif  // DI_PARALLEL_H
+
@@ -22,19 +22,30 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <algorithm>
 #include <utility>
 #include <map>
+#include <set>
 #include <string>
 
 #include <di/core/Reader.h>
+#include <di/core/Writer.h>
+#include <di/core/DataflowScheduler.h>
 #include <di/core/ObserverCallback.h>
+#include <di/core/Trace.h>
 
 #include <di/commands/ReadFile.h>
 #include <di/commands/Callback.h>
+#include <di/commands/WriteFile.h>
 
 #include <di/algorithms/DataInject.h>
 
 #include <di/io/PlyReader.h>
+#include <di/io/NrrdReader.h>
+#include <di/io/MeshCacheReader.h>
+#include <di/io/FreeSurferSurfaceReader.h>
+#include <di/io/FreeSurferAnnotationReader.h>
+#include <di/io/GiftiReader.h>
 
 #include "ProcessingNetwork.h"
 
@@ -48,14 +59,26 @@ namespace di
         ProcessingNetwork::ProcessingNetwork():
             CommandQueue()
         {
+            registerDefaultCommandHandlers();
         }
 
         ProcessingNetwork::~ProcessingNetwork()
         {
+            // The I/O workers use this instance. Stop them before anything gets destroyed.
+            stop( false );
         }
 
         void ProcessingNetwork::onDirtyNetwork()
         {
+            // A change might make the current run outdated. Cancel it early. The run restarts with the latest state.
+            {
+                std::lock_guard< std::mutex > runLock( m_currentRunMutex );
+                if( m_currentRun )
+                {
+                    m_currentRun->cancelIfStale();
+                }
+            }
+
             std::unique_lock< std::mutex > lock( m_onDirtyObserversMutex );
             for( auto observer : m_onDirtyObservers )
             {
@@ -90,25 +113,101 @@ namespace di
 
             // Fill the list of readers. IMPORTANT: in the future, readers will be added dynamically (loaded from DLLs/SOs/DyLibs)
             m_reader.push_back( SPtr< di::io::PlyReader >( new di::io::PlyReader() ) );
+            m_reader.push_back( SPtr< di::io::NrrdReader >( new di::io::NrrdReader() ) );
+            m_reader.push_back( SPtr< di::io::MeshCacheReader >( new di::io::MeshCacheReader() ) );
+            m_reader.push_back( SPtr< di::io::FreeSurferSurfaceReader >( new di::io::FreeSurferSurfaceReader() ) );
+            m_reader.push_back( SPtr< di::io::FreeSurferAnnotationReader >( new di::io::FreeSurferAnnotationReader() ) );
+            m_reader.push_back( SPtr< di::io::GiftiReader >( new di::io::GiftiReader() ) );
+
+            m_ioPool = SPtr< WorkerPool >( new WorkerPool( m_numIOThreads, "I/O" ) );
+            m_ioPool->start();
+
+            m_algorithmPool = SPtr< WorkerPool >( new WorkerPool( 0, "Algorithm" ) );
+            m_algorithmPool->start();
 
             CommandQueue::start();
         }
 
         void ProcessingNetwork::stop( bool graceful )
         {
+            // Finish running reads first. They re-enter the command queue, so it needs to run.
+            if( m_ioPool )
+            {
+                m_ioPool->stop();
+            }
+
             CommandQueue::stop( graceful );
+
+            // The algorithms are run by the processing thread. It is done now.
+            if( m_algorithmPool )
+            {
+                m_algorithmPool->stop();
+            }
+
+            // Whatever still waits cannot be finished anymore.
+            for( auto pending : m_pendingReads )
+            {
+                pending.first->abort();
+            }
+            m_pendingReads.clear();
+            for( auto command : m_waitingCommands )
+            {
+                command->abort();
+            }
+            m_waitingCommands.clear();
         }
 
-        SPtr< di::commands::QueryState > ProcessingNetwork::queryState( SPtr< CommandObserver > observer )
+        SPtr< di::commands::QueryState > ProcessingNetwork::queryState( SPtr< CommandObserver > observer, bool includeStatistics )
         {
             // Use the command
             return commit(
                 SPtr< di::commands::QueryState >(
-                    new di::commands::QueryState( observer )
+                    new di::commands::QueryState( observer, includeStatistics )
                 )
             );
         }
 
+        di::core::State ProcessingNetwork::getStatistics() const
+        {
+            std::lock_guard< std::mutex > lockAlgo( m_algorithmsMutex );
+
+            State s;
+            for( auto algo : m_algorithms )
+            {
+                s.set( algo->getRuntimeName(), algo->getStatistics().toState() );
+            }
+            return s;
+        }
+
+        void ProcessingNetwork::observeAlgorithms( SPtr< AlgorithmObserver > observer )
+        {
+            std::lock_guard< std::mutex > lockAlgo( m_algorithmsMutex );
+
+            // if already inside ... nothing happens.
+            if( std::find( m_algorithmObservers.begin(), m_algorithmObservers.end(), observer ) != m_algorithmObservers.end() )
+            {
+                return;
+            }
+
+            m_algorithmObservers.push_back( observer );
+            for( auto algo : m_algorithms )
+            {
+                algo->observeRuns( observer );
+            }
+        }
+
+        void ProcessingNetwork::removeAlgorithmObserver( SPtr< AlgorithmObserver > observer )
+        {
+            std::lock_guard< std::mutex > lockAlgo( m_algorithmsMutex );
+            m_algorithmObservers.erase( std::remove( m_algorithmObservers.begin(),
+                                                     m_algorithmObservers.end(),
+                                                     observer ), m_algorithmObservers.end() );
+            for( auto algo : m_algorithms )
+            {
+                algo->removeRunObserver( observer );
+            }
+        }
+
         di::core::State ProcessingNetwork::getState() const
         {
             // Avoid concurrent access:
@@ -208,8 +307,15 @@ namespace di
 
             // Register own observer
             algorithm->observe( m_onDirtyObserver );
+            for( auto observer : m_algorithmObservers )
+            {
+                algorithm->observeRuns( observer );
+            }
 
             m_algorithms.push_back( algorithm );
+            m_outgoingConnections[ algorithm ];
+            m_incomingConnectionCount[ algorithm ] = 0;
+            m_runOrderValid = false;
 
             // find a proper instance name
             if( algorithm->getRuntimeName().empty() )
@@ -242,17 +348,56 @@ namespace di
             }
 
             // also ensure that the given target connector is not yet connected somehow:
-            for( auto c : m_connections )
+            if( m_connectedInputs.count( connection->getTarget() ) )
             {
-                auto theConnection = c.first;
-                if( theConnection->getTarget() == connection->getTarget() )
-                {
-                    throw std::logic_error( "Connecting an input multiple times is not allowed." );
-                }
+                throw std::logic_error( "Connecting an input multiple times is not allowed." );
+            }
+
+            // The network needs to stay acyclic. Otherwise, no algorithm of the cycle could ever run.
+            auto source = partners.first.front();
+            auto target = partners.second.front();
+            if( wouldCreateCycle( source, target ) )
+            {
+                throw std::logic_error( "Connection from \"" + source->getRuntimeName() + "\" to \"" + target->getRuntimeName() +
+                                        "\" would create a cycle." );
             }
 
             // store
-            m_connections[ connection ] = std::make_pair( partners.first.front(), partners.second.front() );
+            m_connections[ connection ] = std::make_pair( source, target );
+            m_connectedInputs.insert( connection->getTarget() );
+            m_outgoingConnections[ source ].push_back( std::make_pair( connection, target ) );
+            m_incomingConnectionCount[ target ]++;
+            m_runOrderValid = false;
+        }
+
+        bool ProcessingNetwork::wouldCreateCycle( SPtr< Algorithm > source, SPtr< Algorithm > target ) const
+        {
+            // Depth-first search for the source, starting at the target.
+            std::set< SPtr< Algorithm > > visited;
+            std::vector< SPtr< Algorithm > > stack( 1, target );
+            while( !stack.empty() )
+            {
+                auto algo = stack.back();
+                stack.pop_back();
+                if( algo == source )
+                {
+                    return true;
+                }
+                if( !visited.insert( algo ).second )
+                {
+                    continue;
+                }
+
+                auto outgoing = m_outgoingConnections.find( algo );
+                if( outgoing != m_outgoingConnections.end() )
+                {
+                    for( const auto& edge : outgoing->second )
+                    {
+                        stack.push_back( edge.second );
+                    }
+                }
+            }
+            return false;
         }
 
         SPtr< di::commands::ReadFile > ProcessingNetwork::loadFile( const std::string& fileName, SPtr< CommandObserver > observer )
@@ -277,6 +422,28 @@ namespace di
             );
         }
 
+        SPtr< di::commands::WriteFile > ProcessingNetwork::writeFile( SPtr< Writer > writer, ConstSPtr< Algorithm > algorithm,
+                                                                      const std::string& connectorName, const std::string& fileName,
+                                                                      SPtr< CommandObserver > observer )
+        {
+            return commit(
+                SPtr< di::commands::WriteFile >(
+                    new di::commands::WriteFile( writer, algorithm, connectorName, fileName, observer )
+                )
+            );
+        }
+
+        SPtr< di::commands::InjectData > ProcessingNetwork::injectData( SPtr< di::algorithms::DataInject > inject,
+                                                                        ConstSPtr< ConnectorTransferable > data,
+                                                                        SPtr< CommandObserver > observer )
+        {
+            return commit(
+                SPtr< di::commands::InjectData >(
+                    new di::commands::InjectData( inject, data, observer )
+                )
+            );
+        }
+
         SPtr< di::commands::AddAlgorithm > ProcessingNetwork::addAlgorithm( SPtr< Algorithm > algorithm, SPtr< CommandObserver > observer )
         {
             return commit(
@@ -331,12 +498,9 @@ namespace di
                 return 0;
             }
 
-            size_t result = 0;
-            for( auto c : m_connections )
-            {
-                result += ( c.second.second == algorithm ) ? 1 : 0; // never directly add a bool.
-            }
-            return result;
+            // NOTE: the map uses non-const pointers as keys.
+            auto count = m_incomingConnectionCount.find( std::const_pointer_cast< Algorithm >( algorithm ) );
+            return ( count == m_incomingConnectionCount.end() ) ? 0 : count->second;
         }
 
         SPtr< di::commands::Connect > ProcessingNetwork::connectAlgorithms( ConstSPtr< di::core::Algorithm > from,
@@ -392,229 +556,424 @@ namespace di
             );
         }
 
-        void ProcessingNetwork::process( SPtr< Command > command )
+        void ProcessingNetwork::registerDefaultCommandHandlers()
         {
-            // IMPORTANT: in the future, it is planned to make this dynamic... for now, it is sufficient to do it the hard-coded way as we need to get
-            // started with the visualization itself.
-
-            // NOTE: also keep in mind that a class CommandInterpreter would be useful to move those implementations to somewhere else as this grow
-            // big fast.
-
-            // Is a ReadFile command?
-            SPtr< di::commands::ReadFile > readFileCmd = std::dynamic_pointer_cast< di::commands::ReadFile >( command );
-            if( readFileCmd )
-            {
-                std::string fn = readFileCmd->getFilename();
-                LogD << "Try loading: \"" << fn << "\"" << LogEnd;
-
-                // iterate all known readers to find the best or use the given one
-                auto reader = readFileCmd->getReader();
-                if( !reader )
+            registerCommandHandler< di::commands::ReadFile >(
+                [ this ]( SPtr< di::commands::ReadFile > command ) { processReadFile( command ); } );
+            registerCommandHandler< di::commands::WriteFile >(
+                [ this ]( SPtr< di::commands::WriteFile > command ) { processWriteFile( command ); }, nullptr, WaitPolicy::PendingReads );
+            registerCommandHandler< di::commands::InjectData >(
+                [ this ]( SPtr< di::commands::InjectData > command ) { processInjectData( command ); } );
+            registerCommandHandler< di::commands::AddAlgorithm >(
+                [ this ]( SPtr< di::commands::AddAlgorithm > command ) { processAddAlgorithm( command ); } );
+            registerCommandHandler< di::commands::Connect >(
+                [ this ]( SPtr< di::commands::Connect > command ) { processConnect( command ); } );
+            registerCommandHandler< di::commands::RunNetwork >(
+                [ this ]( SPtr< di::commands::RunNetwork > /* command */ ) { runNetworkImpl(); }, nullptr, WaitPolicy::PendingReads );
+            registerCommandHandler< di::commands::Callback >(
+                []( SPtr< di::commands::Callback > command ) { command->call(); }, nullptr, WaitPolicy::Ordered );
+            registerCommandHandler< di::commands::QueryState >(
+                [ this ]( SPtr< di::commands::QueryState > command )
                 {
-                    for( auto aReader : m_reader )
+                    State state = getState();
+                    if( command->getIncludeStatistics() )
                     {
-                        if( aReader->canLoad( fn ) )
-                        {
-                            reader = aReader;
-                            break;
-                        }
+                        state.set( "Statistics", getStatistics() );
                     }
-                }
-                else if( !reader->canLoad( fn ) )   // also ensure the provided reader can actually read this file
-                {
-                    reader = nullptr;
-                }
+                    command->setState( state );
+                } );
+        }
 
-                if( reader )
+        const ProcessingNetwork::CommandHandler* ProcessingNetwork::findCommandHandler( SPtr< Command > command, std::string& reason )
+        {
+            // Registered class or already resolved subclass?
+            std::type_index type( typeid( *command ) );
+            auto handler = m_commandHandlers.find( type );
+            if( handler != m_commandHandlers.end() )
+            {
+                return &handler->second;
+            }
+            handler = m_subclassCommandHandlers.find( type );
+            if( handler != m_subclassCommandHandlers.end() )
+            {
+                return &handler->second;
+            }
+
+            // Subclass of a registered class? It has to be unique, as there is no way to tell which base is the more derived one.
+            const CommandHandler* base = nullptr;
+            for( const auto& registered : m_commandHandlers )
+            {
+                if( !registered.second.accepts( *command ) )
                 {
-                    // NOTE: exceptions get handled in CommandQueue
-                    readFileCmd->setResult( reader->load( fn ) );
+                    continue;
                 }
-                else
+                if( base )
                 {
-                    readFileCmd->fail( "No suitable reader found for \"" + fn  + "\"."  );
+                    reason = "Ambiguous handlers for command \"" + command->getName() + "\". Register a handler for its class.";
+                    return nullptr;
                 }
+                base = &registered.second;
+            }
 
-                auto injector = readFileCmd->getDataInject();
-                if( injector )
-                {
-                    injector->inject( readFileCmd->getResult() );
-                }
+            if( !base )
+            {
+                reason = "No handler for command \"" + command->getName() + "\".";
+                return nullptr;
+            }
+            return &( m_subclassCommandHandlers[ type ] = *base );
+        }
+
+        void ProcessingNetwork::process( SPtr< Command > command )
+        {
+            // Find the handler by the type of the command.
+            std::string reason;
+            const CommandHandler* handler = findCommandHandler( command, reason );
+            if( !handler )
+            {
+                command->fail( reason );
+                return;
             }
 
-            // Add a new algorithm?
-            SPtr< di::commands::AddAlgorithm > addAlgorithmCmd = std::dynamic_pointer_cast< di::commands::AddAlgorithm >( command );
-            if( addAlgorithmCmd )
+            // Do we need to wait for some data to arrive?
+            if( needsToWait( handler->waitPolicy ) )
             {
-                // is a null?
-                if( !addAlgorithmCmd->getAlgorithm() )
-                {
-                    addAlgorithmCmd->fail( "Null algorithms are not allowed." );
-                }
+                LogD << "Command \"" << command->getName() << "\" waits for pending reads." << LogEnd;
+                command->defer();
+                m_waitingCommands.push_back( command );
+                return;
+            }
 
-                // add and done
-                addNetworkNode( addAlgorithmCmd->getAlgorithm() );
+            // Run in the processing thread?
+            auto handle = handler->handle;
+            if( !handler->executor )
+            {
+                handle( command );
+                return;
             }
 
-            // Connect a algorithm?
-            SPtr< di::commands::Connect > connectCmd = std::dynamic_pointer_cast< di::commands::Connect >( command );
-            if( connectCmd )
+            // Run in the executor. The command is finished there. Until the executor gets to it, the command is deferred. Tell the observers
+            // when it really is busy.
+            command->defer();
+            bool submitted = handler->executor->submit( [ handle, command ]()
             {
-                // is a null?
-                if( !connectCmd->getFromConnector() )
+                command->deferredBusy();
+                try
+                {
+                    handle( command );
+                }
+                catch( const std::exception& e )
                 {
-                    connectCmd->fail( "Need a source connector. Null pointer given." );
+                    command->fail( e );
                 }
-                if( !connectCmd->getToConnector() )
+                catch( ... )
                 {
-                    connectCmd->fail( "Need a target connector. Null pointer given." );
+                    command->fail( "Unknown exception occurred." );
                 }
+                command->success();
+            } );
 
-                // add and done
-                addNetworkNodeEdge( std::make_shared< Connection >( connectCmd->getFromConnector(), connectCmd->getToConnector() ) );
+            // Executor not running? Do it here.
+            if( !submitted )
+            {
+                command->busy();
+                handle( command );
             }
+        }
 
-            // Run the network again?
-            SPtr< di::commands::RunNetwork > runCmd = std::dynamic_pointer_cast< di::commands::RunNetwork >( command );
-            if( runCmd )
+        void ProcessingNetwork::processInjectData( SPtr< di::commands::InjectData > command )
+        {
+            if( !command->getDataInject() )
             {
-                // Call the proper function. Keep in mind that this is a temporary solution. The will be done by a scheduler in the future.
-                runNetworkImpl();
+                command->fail( "Need a data inject algorithm. Null pointer given." );
+                return;
             }
 
-            // Trigger callback?
-            SPtr< di::commands::Callback > callbackCmd = std::dynamic_pointer_cast< di::commands::Callback >( command );
-            if( callbackCmd )
+            command->getDataInject()->inject( command->getData() );
+            runNetworkImpl();
+        }
+
+        void ProcessingNetwork::processAddAlgorithm( SPtr< di::commands::AddAlgorithm > command )
+        {
+            // is a null?
+            if( !command->getAlgorithm() )
             {
-                callbackCmd->call();
+                command->fail( "Null algorithms are not allowed." );
+                return;
             }
 
-            // Query State?
-            SPtr< di::commands::QueryState > queryStateCmd = std::dynamic_pointer_cast< di::commands::QueryState >( command );
-            if( queryStateCmd )
+            // add and done
+            addNetworkNode( command->getAlgorithm() );
+        }
+
+        void ProcessingNetwork::processConnect( SPtr< di::commands::Connect > command )
+        {
+            // is a null?
+            if( !command->getFromConnector() )
+            {
+                command->fail( "Need a source connector. Null pointer given." );
+                return;
+            }
+            if( !command->getToConnector() )
             {
-                queryStateCmd->setState( getState() );
+                command->fail( "Need a target connector. Null pointer given." );
+                return;
             }
+
+            // add and done
+            addNetworkNodeEdge( std::make_shared< Connection >( command->getFromConnector(), command->getToConnector() ) );
         }
 
-        std::vector<
-            std::pair<
-                std::vector< SPtr< Algorithm > >,
-                std::vector< SPtr< Connection > >
-            >
-        > ProcessingNetwork::buildRunOrder()
+        void ProcessingNetwork::processReadFile( SPtr< di::commands::ReadFile > command )
         {
-            typedef std::vector< SPtr< Algorithm > > AlgoVec;
+            std::string fn = command->getFilename();
 
-            // Associate each algorithm with a layer
-            std::map< SPtr< Algorithm >, int > algoLayer;
-            // Associate each algorithm with its incoming connected algorithms
-            std::map< SPtr< Algorithm >, AlgoVec > incomingAlgos;
-
-            // Find sources ( algorithms without input connectors ) and non-connected algorithms.
-            for( auto algo : m_algorithms )
+            // Is this the completion of a read running in the I/O pool?
+            auto pending = m_pendingReads.find( command );
+            if( pending != m_pendingReads.end() )
             {
-                // use this iteration to init the algorithm - layer map:
-                algoLayer[ algo ] = -1;
+                std::string error = *pending->second;
+                m_pendingReads.erase( pending );
 
-                // get all incoming connections
-                for( auto c : m_connections )
+                if( error.empty() )
                 {
-                    // is the target algorithm of this connection our current algorithm?
-                    if( c.second.second == algo )
+                    LogD << "Loaded: \"" << fn << "\"" << LogEnd;
+                    auto injector = command->getDataInject();
+                    if( injector )
                     {
-                        incomingAlgos[ algo ].push_back( c.second.first );
+                        injector->inject( command->getResult() );
                     }
                 }
-
-                // source or not connected? Always first layer.
-                if( countInputConnections( algo ) == 0 )
+                else
                 {
-                    algoLayer[ algo ] = 0;
+                    command->fail( error );
                 }
+
+                resumeWaitingCommands();
+                return;
             }
 
-            // Do nice stuff to assign each algorithm
-            bool stop = false;
-            int globalMaxLayer = 0;
-            while( !stop )
+            LogD << "Try loading: \"" << fn << "\"" << LogEnd;
+
+            // Use the given reader. If there is none or it cannot load the file, iterate all known readers to find the best.
+            auto reader = command->getReader();
+            if( !reader || !reader->canLoad( fn ) )
             {
-                bool allAssigned = true;
-                for( auto algo : m_algorithms )
+                reader = nullptr;
+                for( auto aReader : m_reader )
                 {
-                    // Skip algorithms that have been assigned earlier.
-                    if( algoLayer[ algo ] >= 0 )
+                    if( aReader->canLoad( fn ) )
                     {
-                        continue;
+                        reader = aReader;
+                        break;
                     }
+                }
+            }
+
+            if( !reader )
+            {
+                command->fail( "No suitable reader found for \"" + fn  + "\"."  );
 
-                    // get all incoming connections
-                    int maxLayer = -1;
-                    bool valid = true;
-                    for( auto source : incomingAlgos[ algo ] )
+                auto injector = command->getDataInject();
+                if( injector )
+                {
+                    injector->inject( command->getResult() );
+                }
+                return;
+            }
+
+            // Previews are only useful if they can be injected.
+            auto injector = command->getDataInject();
+            Reader::PreviewCallback preview;
+            if( injector )
+            {
+                preview = [ this, injector ]( SPtr< DataSetBase > data )
+                {
+                    injectData( injector, data );
+                };
+            }
+
+            // Load in the I/O pool. The worker re-commits the command when done. We finish the command then.
+            auto error = std::make_shared< std::string >();
+            m_pendingReads[ command ] = error;
+            bool submitted = m_ioPool && m_ioPool->submit(
+                [ this, command, reader, fn, error, preview ]()
+                {
+                    try
                     {
-                        // The max layer is valid until we find a source that was not yet assigned.
-                        valid = valid && ( algoLayer[ source ] >= 0 );
-                        maxLayer = std::max( maxLayer, algoLayer[ source ] );
+                        TraceSpan span( "io", "Read", fn );
+                        command->setResult( reader->loadProgressive( fn, preview ) );
                     }
-
-                    // All sources assigned?
-                    if( valid )
+                    catch( const std::exception& e )
                     {
-                        // Yes. We can 	unambiguously assign this algo too:
-                        algoLayer[ algo ] = maxLayer + 1;
-                        // the largest ever layer:
-                        globalMaxLayer = std::max( globalMaxLayer, maxLayer + 1 );
+                        *error = e.what();
                     }
-                    else
+                    catch( ... )
                     {
-                        allAssigned = false;
                     }
+
+                    // An empty message denotes success. Keep the failure, even if the exception had no message.
+                    if( !command->getResult() && error->empty() )
+                    {
+                        *error = "Unknown exception occurred.";
+                    }
+
+                    commit( command );
                 }
-                stop = allAssigned;
+            );
+            if( submitted )
+            {
+                // NOTE: the worker cannot finish the command before we return. The re-committed command is processed by this thread.
+                command->defer();
+                return;
             }
 
-            // The caller asked for the inverse list -> layer to algorithm
-            std::vector<
-                std::pair<
-                    std::vector< SPtr< Algorithm > >,
-                    std::vector< SPtr< Connection > >
-                >
-            > result( globalMaxLayer + 1 );
+            // The pool is not running (anymore). Load right here.
+            m_pendingReads.erase( command );
 
-            // Fill
-            for( auto elem : algoLayer )
+            // NOTE: exceptions get handled in CommandQueue
             {
-                auto algo = elem.first;
+                TraceSpan span( "io", "Read", fn );
+                command->setResult( reader->load( fn ) );
+            }
+            if( injector )
+            {
+                injector->inject( command->getResult() );
+            }
+        }
 
-                // Store the algorithms
-                result[ elem.second ].first.push_back( algo );
-                // And all outgoing connections starting at this layer
-                for( auto con : m_connections )
+        void ProcessingNetwork::processWriteFile( SPtr< di::commands::WriteFile > command )
+        {
+            const std::string& fn = command->getFilename();
+            if( !command->getWriter() || !command->getAlgorithm() )
+            {
+                command->fail( "Need a writer and an algorithm. Null pointer given." );
+                return;
+            }
+
+            auto connector = command->getAlgorithm()->getOutput( command->getConnectorName() );
+            auto data = connector ? std::dynamic_pointer_cast< const DataSetBase >( connector->getTransferable() ) : nullptr;
+            if( !data )
+            {
+                command->fail( "Output \"" + command->getConnectorName() + "\" has no data to write to \"" + fn + "\"." );
+                return;
+            }
+            if( !command->getWriter()->canWrite( fn, data ) )
+            {
+                command->fail( "The writer cannot write \"" + data->getName() + "\" to \"" + fn + "\"." );
+                return;
+            }
+
+            try
+            {
+                TraceSpan span( "io", "Write", fn );
+                command->getWriter()->write( fn, data );
+                LogD << "Written: \"" << fn << "\"" << LogEnd;
+            }
+            catch( const std::exception& e )
+            {
+                command->fail( e );
+            }
+        }
+
+        bool ProcessingNetwork::needsToWait( WaitPolicy waitPolicy ) const
+        {
+            switch( waitPolicy )
+            {
+                case WaitPolicy::PendingReads:
+                    return !m_pendingReads.empty() || !m_waitingCommands.empty();
+                case WaitPolicy::Ordered:
+                    return !m_waitingCommands.empty();
+                default:
+                    return false;
+            }
+        }
+
+        void ProcessingNetwork::resumeWaitingCommands()
+        {
+            if( !m_pendingReads.empty() )
+            {
+                return;
+            }
+
+            // Process them in order. They cannot be deferred again as there are no pending reads.
+            std::list< SPtr< Command > > waiting;
+            waiting.swap( m_waitingCommands );
+            for( auto command : waiting )
+            {
+                processCommand( command );
+            }
+        }
+
+        const ProcessingNetwork::RunOrder& ProcessingNetwork::buildRunOrder()
+        {
+            if( m_runOrderValid )
+            {
+                return m_runOrder;
+            }
+
+            // Kahn's algorithm. Each algorithm is placed one layer below the deepest of its sources. Cycles are prevented when connecting.
+            std::map< SPtr< Algorithm >, size_t > remainingInputs;
+            std::map< SPtr< Algorithm >, size_t > algoLayer;
+            std::vector< SPtr< Algorithm > > ready;
+            for( auto algo : m_algorithms )
+            {
+                remainingInputs[ algo ] = countInputConnections( algo );
+                algoLayer[ algo ] = 0;
+                if( remainingInputs[ algo ] == 0 )
                 {
-                    // If the connection source is the current algo
-                    if( con.second.first == algo )
+                    ready.push_back( algo );
+                }
+            }
+
+            RunOrder result;
+            auto graph = std::make_shared< DataflowScheduler >( nullptr );
+            for( size_t next = 0; next < ready.size(); ++next )
+            {
+                auto algo = ready[ next ];
+                auto layer = algoLayer[ algo ];
+                if( result.size() <= layer )
+                {
+                    result.resize( layer + 1 );
+                }
+
+                // Store the algorithm and all outgoing connections starting at this layer
+                result[ layer ].first.push_back( algo );
+                graph->addAlgorithm( algo );
+                for( const auto& edge : m_outgoingConnections[ algo ] )
+                {
+                    result[ layer ].second.push_back( edge.first );
+                    graph->addConnection( edge.first, algo, edge.second );
+
+                    auto target = edge.second;
+                    algoLayer[ target ] = std::max( algoLayer[ target ], layer + 1 );
+                    remainingInputs[ target ]--;
+                    if( remainingInputs[ target ] == 0 )
                     {
-                        result[ elem.second ].second.push_back( con.first );
+                        ready.push_back( target );
                     }
                 }
             }
 
-            return result;
+            m_runOrder.swap( result );
+            m_runGraph = graph;
+            m_runOrderValid = true;
+            return m_runOrder;
         }
 
         void ProcessingNetwork::runNetworkImpl()
         {
+            TraceSpan span( "network", "Run network" );
+
             // Avoid concurrent access:
             std::lock_guard< std::mutex > lockAlgo( m_algorithmsMutex );
             std::lock_guard< std::mutex > lockCon( m_connectionsMutex );
 
-            // Get the execution order:
-            auto executionLayers = buildRunOrder();
+            // Get the layers and the dataflow graph. The layers are only used for some nice output. Scheduling is done by the dataflow.
+            const auto& executionLayers = buildRunOrder();
 
             // Some nice output
             size_t l = 0;
-            for( auto layer : executionLayers )
+            for( const auto& layer : executionLayers )
             {
                 LogD << "Layer " << l << LogEnd;
                 for( auto algo : layer.first )
@@ -627,40 +986,45 @@ namespace di
 
             LogD << "Running processing network. Propagating changes." << LogEnd;
 
-            // Iterate each layer:
-            std::map< SPtr< Algorithm >, bool > dataPropagated;
-            for( auto layer : executionLayers )
+            // Each algorithm runs as soon as all its inputs are propagated. Independent branches do not wait for each other. If the run gets
+            // outdated by a change, it is cancelled and restarted. Data that was propagated but not yet processed is carried over to the restart.
+            std::set< SPtr< Algorithm > > unfinishedData;
+            while( true )
             {
-                // NOTE: as all algorithms in one layer are not dependent on each other, it is possible to use std::async and similar facilities here
-                // to parallelize execution. Not yet done.
-                for( auto algo : layer.first )
+                auto scheduler = std::make_shared< DataflowScheduler >( m_algorithmPool, *m_runGraph );
+                for( auto algo : unfinishedData )
                 {
-                    if( algo->isActive() && ( algo->isUpdateRequested() || dataPropagated[ algo ] ) )
-                    {
-                        LogI << "Running algorithm"
-                             << " - " << *algo << " { Dirty: " << algo->isUpdateRequested() << ", Active: " << algo->isActive()
-                             << ", Data: " << dataPropagated[ algo ] << " }"
-                             << LogEnd;
-                        algo->run();
-                    }
-                    else
-                    {
-                        LogI << "Ignoring algorithm"
-                             << " - " << *algo << " { Dirty: " << algo->isUpdateRequested() << ", Active: " << algo->isActive()
-                             << ", Data: " << dataPropagated[ algo ] << " }"
-                             << LogEnd;
-                    }
+                    scheduler->setDataPropagated( algo );
                 }
 
-                for( auto con : layer.second )
+                setCurrentRun( scheduler );
+                bool finished = false;
+                try
+                {
+                    finished = scheduler->run();
+                }
+                catch( ... )
                 {
-                    bool result = con->propagate();
-                    LogD << "Propagation: " << *m_connections[ con ].first << ":" << *con << ":" << *m_connections[ con ].second <<
-                                               " - Result: " << result << LogEnd;
+                    setCurrentRun( nullptr );
+                    throw;
+                }
+                setCurrentRun( nullptr );
 
-                    dataPropagated[ m_connections[ con ].second ] = dataPropagated[ m_connections[ con ].second ] || result;
+                if( finished )
+                {
+                    return;
                 }
+
+                LogI << "Run cancelled as it got outdated. Restarting with the latest state." << LogEnd;
+                Trace::instant( "network", "Run cancelled" );
+                unfinishedData = scheduler->getUnfinishedData();
             }
         }
+
+        void ProcessingNetwork::setCurrentRun( SPtr< DataflowScheduler > run )
+        {
+            std::lock_guard< std::mutex > lock( m_currentRunMutex );
+            m_currentRun = run;
+        }
     }
 }
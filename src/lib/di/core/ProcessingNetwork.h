@@ -25,23 +25,34 @@
 #ifndef DI_PROCESSINGNETWORK_H
 #define DI_PROCESSINGNETWORK_H
 
+#include <functional>
+#include <list>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 #include <map>
+#include <set>
+#include <stdexcept>
 #include <utility>
 
 #include <di/Types.h>
 
 #include <di/core/Reader.h>
+#include <di/core/Writer.h>
 #include <di/core/Command.h>
 #include <di/core/CommandObserver.h>
 #include <di/core/CommandQueue.h>
 #include <di/core/Algorithm.h>
+#include <di/core/AlgorithmObserver.h>
 #include <di/core/Visualization.h>
 #include <di/core/Connection.h>
 #include <di/core/State.h>
+#include <di/core/WorkerPool.h>
+#include <di/core/DataflowScheduler.h>
 
 // All commands provided as convenience wrapper.
 #include <di/commands/ReadFile.h>
@@ -50,6 +61,8 @@
 #include <di/commands/RunNetwork.h>
 #include <di/commands/Callback.h>
 #include <di/commands/QueryState.h>
+#include <di/commands/InjectData.h>
+#include <di/commands/WriteFile.h>
 
 namespace di
 {
@@ -72,6 +85,16 @@ namespace di
         class ProcessingNetwork: public CommandQueue
         {
         public:
+            /**
+             * How a command waits for the commands committed before it. See \ref registerCommandHandler.
+             */
+            enum class WaitPolicy
+            {
+                None = 0,       //!< never waits.
+                Ordered,        //!< waits while earlier commands are waiting. This keeps the order with them.
+                PendingReads    //!< like Ordered, but also waits for all pending reads, as it relies on the loaded data.
+            };
+
             /**
              * Create an empty processing network container.
              */
@@ -154,7 +177,8 @@ namespace di
             /**
              * \copydoc loadFile
              *
-             * \param reader the reader instance to use. Can be nullptr to use known readers automatically.
+             * \param reader the reader instance to use. Can be nullptr to use known readers automatically. Known readers are also used if the
+             * given reader cannot load the file.
              */
             virtual SPtr< di::commands::ReadFile > loadFile( SPtr< Reader > reader, const std::string& fileName,
                                                              SPtr< CommandObserver > observer = nullptr );
@@ -168,6 +192,40 @@ namespace di
                                                              SPtr< di::algorithms::DataInject > inject = nullptr,
                                                              SPtr< CommandObserver > observer = nullptr );
 
+            /**
+             * Write the data of an algorithm output to the specified file. Like \ref runNetwork, this waits for pending reads. Commit it after
+             * \ref runNetwork to write the results of that run. This operation is non-blocking and runs in this container's thread.
+             *
+             * \note equals to committing a di::commands::WriteFile( writer, algorithm, connectorName, fileName, observer );
+             *
+             * \param writer the writer to use
+             * \param algorithm the algorithm providing the data
+             * \param connectorName the name of the output connector
+             * \param fileName the file to write
+             * \param observer the observer that gets informed about changes. Can be omitted.
+             *
+             * \return the command instance. Not needed to keep this.
+             */
+            virtual SPtr< di::commands::WriteFile > writeFile( SPtr< Writer > writer, ConstSPtr< Algorithm > algorithm,
+                                                               const std::string& connectorName, const std::string& fileName,
+                                                               SPtr< CommandObserver > observer = nullptr );
+
+            /**
+             * Inject data into the network and propagate it right away. Unlike \ref runNetwork, this does not wait for pending reads. This
+             * operation is asynchronous. If you need to get informed about success, specify a observer.
+             *
+             * \note equals to committing a di::commands::InjectData( inject, data );
+             *
+             * \param inject the algorithm to inject the data to
+             * \param data the data
+             * \param observer the observer that gets informed about the changes. Can be omitted.
+             *
+             * \return the command instance. Not needed to keep this.
+             */
+            virtual SPtr< di::commands::InjectData > injectData( SPtr< di::algorithms::DataInject > inject,
+                                                                 ConstSPtr< ConnectorTransferable > data,
+                                                                 SPtr< CommandObserver > observer = nullptr );
+
             /**
              * Add an algorithm to the network. This operation is asynchronous. If you need to get informed about success, specify a observer.
              *
@@ -273,12 +331,29 @@ namespace di
              */
             void removeObserverOnDirty( SPtr< Observer > observer );
 
+            /**
+             * Get notified about the runs and the progress of all algorithms in the network, including those added later.
+             *
+             * \param observer the observer
+             */
+            void observeAlgorithms( SPtr< AlgorithmObserver > observer );
+
+            /**
+             * De-register the observer from all algorithms.
+             *
+             * \param observer the observer to remove.
+             */
+            void removeAlgorithmObserver( SPtr< AlgorithmObserver > observer );
+
             /**
              * Get the state object representing this object at the moment of the call.
              *
+             * \param observer an object that gets notified upon changes in this command's state.
+             * \param includeStatistics if true, the state also contains the run statistics of the algorithms. See \ref getStatistics.
+             *
              * \return  the state
              */
-            virtual SPtr< di::commands::QueryState > queryState( SPtr< CommandObserver > observer = nullptr );
+            virtual SPtr< di::commands::QueryState > queryState( SPtr< CommandObserver > observer = nullptr, bool includeStatistics = false );
 
             /**
              * Apply the state to this instance.
@@ -296,6 +371,36 @@ namespace di
              */
             di::core::State getState() const;
 
+            /**
+             * Get the run statistics of all algorithms. The state contains a state per algorithm, named by the runtime name of the algorithm. See
+             * \ref AlgorithmStatistics::toState.
+             *
+             * \return the statistics
+             */
+            di::core::State getStatistics() const;
+
+            /**
+             * Register the handler for a command class. An existing handler for the class is replaced. Register before \ref start, from the
+             * thread that starts the network. The handler tables are read by the processing thread without locking.
+             *
+             * Commits are dispatched by their exact type. A command of an unregistered subclass is handled by the handler of its registered base
+             * class. If several registered classes are bases of it, the command fails as the handler is ambiguous. Register the subclass itself
+             * then. The lookup of a subclass is done once per class.
+             *
+             * If an executor is given, the command gets deferred and the handler is run in the executor. The command succeeds when the handler
+             * returns without failing it. Later commands do not wait for it. Without an executor, the handler runs in the processing thread.
+             *
+             * \tparam CommandType the command class
+             * \param handler the handler. Call \ref Command::fail on failure or throw.
+             * \param executor the pool to run the handler in. If null or not running, the processing thread is used.
+             * \param waitPolicy whether the command waits for earlier ones before the handler is called.
+             *
+             * \throw std::logic_error if the network was started already.
+             */
+            template< typename CommandType >
+            void registerCommandHandler( std::function< void( SPtr< CommandType > ) > handler, SPtr< WorkerPool > executor = nullptr,
+                                         WaitPolicy waitPolicy = WaitPolicy::None );
+
         protected:
             /**
              * Process the specified command. Use Command::handle to mark the command as being handled.
@@ -304,6 +409,78 @@ namespace di
              */
             virtual void process( SPtr< Command > command );
 
+            /**
+             * Register the handlers of the built-in commands.
+             */
+            void registerDefaultCommandHandlers();
+
+            /**
+             * Handle an InjectData command. Injects the data and runs the network.
+             *
+             * \note call only from within the processing thread of this queue.
+             *
+             * \param command the command to handle
+             */
+            virtual void processInjectData( SPtr< di::commands::InjectData > command );
+
+            /**
+             * Handle an AddAlgorithm command.
+             *
+             * \note call only from within the processing thread of this queue.
+             *
+             * \param command the command to handle
+             */
+            virtual void processAddAlgorithm( SPtr< di::commands::AddAlgorithm > command );
+
+            /**
+             * Handle a Connect command.
+             *
+             * \note call only from within the processing thread of this queue.
+             *
+             * \param command the command to handle
+             */
+            virtual void processConnect( SPtr< di::commands::Connect > command );
+
+            /**
+             * Handle a ReadFile command. The first time, the file is loaded in the I/O worker pool and the command gets deferred. When loading is
+             * done, the worker re-commits the command and this method injects the result. If the pool is not running, the file is loaded
+             * immediately. If the command has a DataInject, previews provided by the reader are injected using \ref injectData while loading.
+             *
+             * \note call only from within the processing thread of this queue.
+             *
+             * \param command the command to handle
+             */
+            virtual void processReadFile( SPtr< di::commands::ReadFile > command );
+
+            /**
+             * Handle a WriteFile command. The data of the output connector is written in the processing thread.
+             *
+             * \note call only from within the processing thread of this queue.
+             *
+             * \param command the command to handle
+             */
+            virtual void processWriteFile( SPtr< di::commands::WriteFile > command );
+
+            /**
+             * Check whether a command with the given policy has to wait. By default, RunNetwork and WriteFile commands wait for all pending
+             * reads as they usually rely on the loaded data. They and Callback commands also wait if any earlier one is waiting. This keeps their
+             * order.
+             *
+             * \note call only from within the processing thread of this queue.
+             *
+             * \param waitPolicy the policy registered with the handler of the command
+             *
+             * \return true if the command needs to wait.
+             */
+            virtual bool needsToWait( WaitPolicy waitPolicy ) const;
+
+            /**
+             * Process all commands that waited for pending reads. Does nothing if there are pending reads.
+             *
+             * \note call only from within the processing thread of this queue.
+             */
+            virtual void resumeWaitingCommands();
+
             /**
              * Add the given visualization to the vis-queue. If it already is inside, it is ignored.
              *
@@ -385,18 +562,42 @@ namespace di
             virtual void onDirtyNetwork();
 
             /**
-             * Order algorithms to solve dependencies during execution. REQUIRES that the caller already obtained the m_algorithmsMutex and the
-             * m_connectionsMutex.
+             * Set the current run. Thread-safe.
              *
-             * \return a map between a layer and the algorithms on it. All algorithms of one layer only depend on algorithms of one of the above
-             * layers.
+             * \param run the run. Null if the run is over.
+             */
+            void setCurrentRun( SPtr< DataflowScheduler > run );
+
+            /**
+             * Layers of algorithms, each with the outgoing connections of its algorithms.
              */
-            std::vector<
+            typedef std::vector<
                 std::pair<
                     std::vector< SPtr< Algorithm > >,
                     std::vector< SPtr< Connection > >
                 >
-            > buildRunOrder();
+            > RunOrder;
+
+            /**
+             * Order algorithms to solve dependencies during execution. The order is cached until the topology changes. Along with the order, the
+             * dataflow graph for the runs is built, see \ref m_runGraph. REQUIRES that the caller already obtained the m_algorithmsMutex and the
+             * m_connectionsMutex.
+             *
+             * \return a map between a layer and the algorithms on it. All algorithms of one layer only depend on algorithms of one of the above
+             * layers.
+             */
+            const RunOrder& buildRunOrder();
+
+            /**
+             * Check whether the target algorithm can reach the source algorithm via connections. REQUIRES that the caller already obtained the
+             * m_algorithmsMutex.
+             *
+             * \param source the source of a new connection
+             * \param target the target of a new connection
+             *
+             * \return true if connecting source to target would create a cycle.
+             */
+            bool wouldCreateCycle( SPtr< Algorithm > source, SPtr< Algorithm > target ) const;
 
         private:
             /**
@@ -438,6 +639,38 @@ namespace di
                                  >
                     > m_connections;
 
+            /**
+             * The outgoing connections of each algorithm along with the target algorithm. This is the adjacency list of \ref m_connections,
+             * maintained when adding nodes and edges. Secured by m_algorithmsMutex.
+             */
+            std::map< SPtr< Algorithm >, std::vector< std::pair< SPtr< Connection >, SPtr< Algorithm > > > > m_outgoingConnections;
+
+            /**
+             * The number of incoming connections of each algorithm. Secured by m_algorithmsMutex.
+             */
+            std::map< SPtr< Algorithm >, size_t > m_incomingConnectionCount;
+
+            /**
+             * The input connectors that are connected already. Secured by m_connectionsMutex.
+             */
+            std::set< SPtr< ConnectorBase > > m_connectedInputs;
+
+            /**
+             * The cached result of \ref buildRunOrder. Secured by m_algorithmsMutex.
+             */
+            RunOrder m_runOrder;
+
+            /**
+             * The dataflow graph matching m_runOrder. Never run itself. Each run copies it instead of rebuilding the graph from the connections.
+             * Secured by m_algorithmsMutex.
+             */
+            SPtr< DataflowScheduler > m_runGraph = nullptr;
+
+            /**
+             * True if m_runOrder matches the current topology.
+             */
+            bool m_runOrderValid = false;
+
             /**
              * Observe the dirty state of algorithms.
              */
@@ -452,8 +685,127 @@ namespace di
              * The list of callbacks to call on dirty events.
              */
             std::vector< SPtr< Observer > > m_onDirtyObservers;
+
+            /**
+             * The number of threads used for loading files. Loaders are parallelized themselves. This only allows independent files to load at
+             * the same time.
+             */
+            static const size_t m_numIOThreads = 2;
+
+            /**
+             * The threads loading files.
+             */
+            SPtr< WorkerPool > m_ioPool = nullptr;
+
+            /**
+             * The threads running the algorithms. One per hardware thread.
+             */
+            SPtr< WorkerPool > m_algorithmPool = nullptr;
+
+            /**
+             * The currently running network run. Null if there is none. Cancelled if it gets outdated.
+             */
+            SPtr< DataflowScheduler > m_currentRun = nullptr;
+
+            /**
+             * Secures m_currentRun.
+             */
+            std::mutex m_currentRunMutex;
+
+            /**
+             * Reads running in the I/O pool. Each is associated with the error message of the load. The message is written by the worker
+             * before re-committing the command. Only accessed by the processing thread.
+             */
+            std::map< SPtr< di::commands::ReadFile >, SPtr< std::string > > m_pendingReads;
+
+            /**
+             * Deferred commands waiting for the pending reads, in commit order. Only accessed by the processing thread.
+             */
+            std::list< SPtr< Command > > m_waitingCommands;
+
+            /**
+             * A handler of a command class and where to run it.
+             */
+            struct CommandHandler
+            {
+                /**
+                 * The handler. Gets the command casted to its class.
+                 */
+                std::function< void( SPtr< Command > ) > handle;
+
+                /**
+                 * Check whether a command is of the handled class or derived from it. Used to find the handler of subclasses.
+                 */
+                std::function< bool( const Command& ) > accepts;
+
+                /**
+                 * The pool to run the handler in. Can be null.
+                 */
+                SPtr< WorkerPool > executor;
+
+                /**
+                 * Whether the command waits for earlier ones.
+                 */
+                WaitPolicy waitPolicy = WaitPolicy::None;
+            };
+
+            /**
+             * Find the handler of the given command. Subclasses of registered commands get the handler of their base, which is then cached.
+             *
+             * \note call only from within the processing thread of this queue.
+             *
+             * \param command the command
+             * \param reason set to the reason if no unique handler exists
+             *
+             * \return the handler or null.
+             */
+            const CommandHandler* findCommandHandler( SPtr< Command > command, std::string& reason );
+
+            /**
+             * The observers of all algorithm runs. Secured by m_algorithmsMutex.
+             */
+            std::vector< SPtr< AlgorithmObserver > > m_algorithmObservers;
+
+            /**
+             * The command handlers by command class.
+             */
+            std::unordered_map< std::type_index, CommandHandler > m_commandHandlers;
+
+            /**
+             * The handlers of unregistered subclasses, found via \ref findCommandHandler. Only accessed by the processing thread, after
+             * registration.
+             */
+            std::unordered_map< std::type_index, CommandHandler > m_subclassCommandHandlers;
         };
 
+        template< typename CommandType >
+        void ProcessingNetwork::registerCommandHandler( std::function< void( SPtr< CommandType > ) > handler, SPtr< WorkerPool > executor,
+                                                        WaitPolicy waitPolicy )
+        {
+            if( isStarted() )
+            {
+                throw std::logic_error( "Command handlers need to be registered before starting the network." );
+            }
+
+            CommandHandler commandHandler;
+
+            // Only commands of this class or its subclasses get here. A static cast is fine.
+            commandHandler.handle = [ handler ]( SPtr< Command > command )
+            {
+                handler( std::static_pointer_cast< CommandType >( command ) );
+            };
+            commandHandler.accepts = []( const Command& command )
+            {
+                return dynamic_cast< const CommandType* >( &command ) != nullptr;
+            };
+            commandHandler.executor = executor;
+            commandHandler.waitPolicy = waitPolicy;
+            m_commandHandlers[ std::type_index( typeid( CommandType ) ) ] = commandHandler;
+
+            // The subclasses might resolve differently now.
+            m_subclassCommandHandlers.clear();
+        }
+
         template< typename VisitorType >
         void ProcessingNetwork::visitAlgorithmsNoLock( VisitorType visitor )
         {
@@ -22,6 +22,8 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <string>
+
 #include "Reader.h"
 
 namespace di
@@ -35,5 +37,10 @@ namespace di
         Reader::~Reader()
         {
         }
+
+        SPtr< DataSetBase > Reader::loadProgressive( const std::string& filename, PreviewCallback /* preview */ ) const
+        {
+            return load( filename );
+        }
     }
 }
@@ -25,6 +25,7 @@
 #ifndef DI_READER_H
 #define DI_READER_H
 
+#include <functional>
 #include <string>
 
 #include <di/core/data/DataSetBase.h>
@@ -61,6 +62,23 @@ namespace di
              */
             virtual SPtr< DataSetBase > load( const std::string& filename ) const = 0;
 
+            /**
+             * Called with intermediate results during progressive loading.
+             */
+            typedef std::function< void( SPtr< DataSetBase > ) > PreviewCallback;
+
+            /**
+             * Load the specified file and publish intermediate snapshots while loading. Each snapshot is marked as preview (see
+             * \ref DataSetBase::isPreview). The callback is called from within the loading thread. The default implementation does not provide
+             * any previews and simply calls \ref load.
+             *
+             * \param filename the file to load
+             * \param preview called for each snapshot. Can be an empty function.
+             *
+             * \return the complete data
+             */
+            virtual SPtr< DataSetBase > loadProgressive( const std::string& filename, PreviewCallback preview ) const;
+
         protected:
             /**
              * Constructor.
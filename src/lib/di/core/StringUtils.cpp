@@ -25,6 +25,8 @@
 #include <string> // std::string
 #include <algorithm> // std::transform
 #include <cctype>
+#include <cstdint>
+#include <locale>
 #include <sstream>
 
 #include "StringUtils.h"
@@ -67,5 +69,169 @@ namespace di
             }
             return theString.substr( first, ( last - first + 1 ) );
         }
+
+        const char* parseNumber( const char* str, const char* end, double& value )
+        {
+            // All powers of ten that are exactly representable as double
+            static const double powersOfTen[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+            const int maxPower = 22;
+            const int maxDigits = 19;
+
+            const char* pos = str;
+            while( ( pos < end ) && ( ( *pos == ' ' ) || ( *pos == '\t' ) || ( *pos == '\r' ) ) )
+            {
+                ++pos;
+            }
+            const char* start = pos;
+
+            bool negative = false;
+            if( ( pos < end ) && ( ( *pos == '-' ) || ( *pos == '+' ) ) )
+            {
+                negative = ( *pos == '-' );
+                ++pos;
+            }
+
+            // Collect up to 19 significant digits in an integer. If there are more, the exact conversion is not possible.
+            uint64_t mantissa = 0;
+            int digits = 0;
+            int exponent = 0;
+            bool anyDigits = false;
+            bool exact = true;
+            while( ( pos < end ) && std::isdigit( static_cast< unsigned char >( *pos ) ) )
+            {
+                anyDigits = true;
+                if( digits < maxDigits )
+                {
+                    mantissa = mantissa * 10 + static_cast< uint64_t >( *pos - '0' );
+                    digits += ( mantissa != 0 ) ? 1 : 0;
+                }
+                else
+                {
+                    exact = false;
+                }
+                ++pos;
+            }
+            if( ( pos < end ) && ( *pos == '.' ) )
+            {
+                ++pos;
+                while( ( pos < end ) && std::isdigit( static_cast< unsigned char >( *pos ) ) )
+                {
+                    anyDigits = true;
+                    if( digits < maxDigits )
+                    {
+                        mantissa = mantissa * 10 + static_cast< uint64_t >( *pos - '0' );
+                        digits += ( mantissa != 0 ) ? 1 : 0;
+                        --exponent;
+                    }
+                    else
+                    {
+                        exact = false;
+                    }
+                    ++pos;
+                }
+            }
+            if( !anyDigits )
+            {
+                return nullptr;
+            }
+
+            // The exponent is optional. Like strtod, an "e" without digits is not part of the number.
+            if( ( pos < end ) && ( ( *pos == 'e' ) || ( *pos == 'E' ) ) )
+            {
+                const char* exponentPos = pos + 1;
+                bool negativeExponent = false;
+                if( ( exponentPos < end ) && ( ( *exponentPos == '-' ) || ( *exponentPos == '+' ) ) )
+                {
+                    negativeExponent = ( *exponentPos == '-' );
+                    ++exponentPos;
+                }
+                if( ( exponentPos < end ) && std::isdigit( static_cast< unsigned char >( *exponentPos ) ) )
+                {
+                    int explicitExponent = 0;
+                    while( ( exponentPos < end ) && std::isdigit( static_cast< unsigned char >( *exponentPos ) ) )
+                    {
+                        explicitExponent = std::min( explicitExponent * 10 + ( *exponentPos - '0' ), 100000 );
+                        ++exponentPos;
+                    }
+                    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+                    pos = exponentPos;
+                }
+            }
+
+            // If mantissa and power of ten are exact doubles, a single multiplication or division is correctly rounded.
+            if( exact && ( mantissa <= ( static_cast< uint64_t >( 1 ) << 53 ) ) && ( exponent >= -maxPower ) && ( exponent <= maxPower ) )
+            {
+                double result = static_cast< double >( mantissa );
+                result = ( exponent < 0 ) ? ( result / powersOfTen[ -exponent ] ) : ( result * powersOfTen[ exponent ] );
+                value = negative ? -result : result;
+                return pos;
+            }
+            if( exact && ( mantissa == 0 ) )
+            {
+                value = negative ? -0.0 : 0.0;
+                return pos;
+            }
+
+            // Rare. Let the standard library handle it.
+            std::istringstream stream( std::string( start, pos ) );
+            stream.imbue( std::locale::classic() );
+            stream >> value;
+            if( stream.fail() )
+            {
+                return nullptr;
+            }
+            return pos;
+        }
+
+        bool decodeBase64( const char* str, const char* end, std::vector< uint8_t >& data )
+        {
+            // Maps each character to its 6 bit value. 64: whitespace, 65: padding, 255: invalid.
+            static const struct DecodingTable
+            {
+                uint8_t values[ 256 ];
+                DecodingTable()
+                {
+                    std::fill( values, values + 256, 255 );
+                    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                    for( uint8_t i = 0; i < 64; ++i )
+                    {
+                        values[ static_cast< uint8_t >( alphabet[ i ] ) ] = i;
+                    }
+                    values[ static_cast< uint8_t >( ' ' ) ] = values[ static_cast< uint8_t >( '\t' ) ] = 64;
+                    values[ static_cast< uint8_t >( '\n' ) ] = values[ static_cast< uint8_t >( '\r' ) ] = 64;
+                    values[ static_cast< uint8_t >( '=' ) ] = 65;
+                }
+            } table;
+
+            data.reserve( data.size() + ( end - str ) / 4 * 3 );
+            uint32_t bits = 0;
+            int numBits = 0;
+            for( ; str < end; ++str )
+            {
+                uint8_t value = table.values[ static_cast< uint8_t >( *str ) ];
+                if( value == 64 )
+                {
+                    continue;
+                }
+                if( value == 65 )
+                {
+                    break;
+                }
+                if( value == 255 )
+                {
+                    return false;
+                }
+
+                bits = ( bits << 6 ) | value;
+                numBits += 6;
+                if( numBits >= 8 )
+                {
+                    numBits -= 8;
+                    data.push_back( static_cast< uint8_t >( bits >> numBits ) );
+                }
+            }
+            return true;
+        }
     }
 }
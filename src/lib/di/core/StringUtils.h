@@ -25,6 +25,7 @@
 #ifndef DI_STRINGUTILS_H
 #define DI_STRINGUTILS_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -61,6 +62,30 @@ namespace di
          * \return the trimmed string
          */
         std::string trim( const std::string& theString );
+
+        /**
+         * Parse a floating point or integer number. Unlike strtod, this always uses "." as decimal point, independent of the current locale.
+         * Leading spaces, tabs and carriage returns are skipped. Numbers that can be represented exactly are converted directly, all others
+         * use the classic C++ locale. The result is the same as strtod in the "C" locale. NaN and infinity are not supported.
+         *
+         * \param str the first character to parse
+         * \param end the character after the last one that may be parsed
+         * \param value the parsed value
+         *
+         * \return pointer to the first character after the number or nullptr if there was no valid number.
+         */
+        const char* parseNumber( const char* str, const char* end, double& value );
+
+        /**
+         * Decode base64 encoded data. Whitespace is ignored. Decoding stops at the first padding character.
+         *
+         * \param str the first character to decode
+         * \param end the character after the last one
+         * \param data the decoded bytes are appended here.
+         *
+         * \return false if there was an invalid character.
+         */
+        bool decodeBase64( const char* str, const char* end, std::vector< uint8_t >& data );
     }
 }
 
@@ -0,0 +1,418 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Trace.h"
+
+#include <di/core/Logger.h>
+#define LogTag "core/Trace"
+
+namespace di
+{
+    namespace core
+    {
+        struct Trace::Event
+        {
+            /**
+             * The name. Null-terminated.
+             */
+            char name[ 64 ];
+
+            /**
+             * The detail. Null-terminated.
+             */
+            char detail[ 128 ];
+
+            /**
+             * The category. A string literal.
+             */
+            const char* category;
+
+            /**
+             * Start in nanoseconds.
+             */
+            int64_t start;
+
+            /**
+             * Duration in nanoseconds. Negative for instant events.
+             */
+            int64_t duration;
+        };
+
+        struct Trace::Block
+        {
+            /**
+             * Number of events per block.
+             */
+            static const size_t Size = 1024;
+
+            /**
+             * The events. Only the first \ref count are valid.
+             */
+            std::array< Event, Size > events;
+
+            /**
+             * Number of valid events. Written by the owning thread after the event was filled in. Others only read the events below this count.
+             */
+            std::atomic< size_t > count;
+
+            /**
+             * The next block. Set by the owning thread once this block is full.
+             */
+            std::atomic< Block* > next;
+
+            /**
+             * Create an empty block.
+             */
+            Block():
+                count( 0 ),
+                next( nullptr )
+            {
+            }
+        };
+
+        struct Trace::ThreadBuffer
+        {
+            /**
+             * Limit the memory used by a single thread. About 56MB.
+             */
+            static const size_t MaxBlocks = 256;
+
+            /**
+             * The thread id in the trace.
+             */
+            size_t id = 0;
+
+            /**
+             * The name of the thread. Guarded by the registry mutex.
+             */
+            std::string name;
+
+            /**
+             * The first block. Allocated by the first event, so naming a thread does not cost the memory of a block. Never changes afterwards.
+             */
+            std::atomic< Block* > first;
+
+            /**
+             * The block to record to. Only used by the owning thread.
+             */
+            Block* last = nullptr;
+
+            /**
+             * Number of blocks. Only used by the owning thread.
+             */
+            size_t numBlocks = 0;
+
+            /**
+             * Number of events dropped as the buffer was full.
+             */
+            std::atomic< size_t > dropped;
+
+            /**
+             * Create a buffer without blocks.
+             */
+            ThreadBuffer():
+                first( nullptr ),
+                dropped( 0 )
+            {
+            }
+
+            /**
+             * Free the blocks.
+             */
+            ~ThreadBuffer()
+            {
+                for( Block* block = first; block; )
+                {
+                    Block* next = block->next;
+                    delete block;
+                    block = next;
+                }
+            }
+        };
+
+        struct Trace::Registry
+        {
+            /**
+             * Guards the list and the thread names.
+             */
+            std::mutex mutex;
+
+            /**
+             * All buffers. In the order of creation. The buffers outlive their threads so that their events can still be written.
+             */
+            std::vector< std::unique_ptr< ThreadBuffer > > buffers;
+        };
+
+        std::atomic< bool > Trace::m_enabled( false );
+
+        void Trace::setEnabled( bool enabled )
+        {
+            // Start the clock before the first event.
+            now();
+            m_enabled = enabled;
+        }
+
+        bool Trace::isEnabled()
+        {
+            return m_enabled.load( std::memory_order_relaxed );
+        }
+
+        void Trace::setThreadName( const std::string& name )
+        {
+            auto& buffer = getThreadBuffer();
+            std::lock_guard< std::mutex > lock( getRegistry().mutex );
+            buffer.name = name;
+        }
+
+        void Trace::instant( const char* category, const std::string& name, const std::string& detail )
+        {
+            if( isEnabled() )
+            {
+                record( category, name, detail, now(), -1 );
+            }
+        }
+
+        void Trace::write( std::ostream& out )
+        {
+            auto& registry = getRegistry();
+            std::lock_guard< std::mutex > lock( registry.mutex );
+
+            // Timestamps are in microseconds.
+            out << std::fixed << std::setprecision( 3 );
+            out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+
+            bool first = true;
+            size_t dropped = 0;
+            for( const auto& buffer : registry.buffers )
+            {
+                // Threads that never recorded would only show up as empty tracks.
+                const Block* firstBlock = buffer->first.load( std::memory_order_acquire );
+                if( !buffer->name.empty() && firstBlock )
+                {
+                    out << ( first ? "" : ",\n" ) << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+                        << ",\"args\":{\"name\":";
+                    writeJSONString( out, buffer->name.c_str() );
+                    out << "}}";
+                    first = false;
+                }
+
+                for( const Block* block = firstBlock; block; block = block->next.load( std::memory_order_acquire ) )
+                {
+                    size_t count = block->count.load( std::memory_order_acquire );
+                    for( size_t i = 0; i < count; ++i )
+                    {
+                        const Event& event = block->events[ i ];
+                        out << ( first ? "" : ",\n" ) << "{\"name\":";
+                        writeJSONString( out, event.name );
+                        out << ",\"cat\":";
+                        writeJSONString( out, event.category );
+                        if( event.duration < 0 )
+                        {
+                            out << ",\"ph\":\"i\",\"s\":\"t\"";
+                        }
+                        else
+                        {
+                            out << ",\"ph\":\"X\",\"dur\":" << static_cast< double >( event.duration ) / 1000.0;
+                        }
+                        out << ",\"ts\":" << static_cast< double >( event.start ) / 1000.0 << ",\"pid\":1,\"tid\":" << buffer->id;
+                        if( event.detail[ 0 ] != '\0' )
+                        {
+                            out << ",\"args\":{\"detail\":";
+                            writeJSONString( out, event.detail );
+                            out << "}";
+                        }
+                        out << "}";
+                        first = false;
+                    }
+                }
+                dropped += buffer->dropped;
+            }
+            out << std::endl << "]}" << std::endl;
+
+            if( dropped > 0 )
+            {
+                LogW << "The trace is incomplete. " << dropped << " events were dropped as the buffers were full." << LogEnd;
+            }
+        }
+
+        void Trace::write( const std::string& filename )
+        {
+            std::ofstream file;
+            file.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+            file.open( filename.c_str() );
+            write( file );
+            LogI << "Trace written to \"" << filename << "\"." << LogEnd;
+        }
+
+        int64_t Trace::now()
+        {
+            static const auto epoch = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - epoch ).count();
+        }
+
+        void Trace::record( const char* category, const std::string& name, const std::string& detail, int64_t start, int64_t duration )
+        {
+            auto& buffer = getThreadBuffer();
+
+            // The first event of the thread.
+            if( !buffer.last )
+            {
+                buffer.last = new Block();
+                buffer.numBlocks = 1;
+                buffer.first.store( buffer.last, std::memory_order_release );
+            }
+
+            // Nobody else writes to this thread's blocks. Fill the slot first, then publish it by increasing the count.
+            Block* block = buffer.last;
+            size_t index = block->count.load( std::memory_order_relaxed );
+            if( index == Block::Size )
+            {
+                if( buffer.numBlocks == ThreadBuffer::MaxBlocks )
+                {
+                    buffer.dropped++;
+                    return;
+                }
+
+                Block* next = new Block();
+                block->next.store( next, std::memory_order_release );
+                buffer.last = next;
+                buffer.numBlocks++;
+                block = next;
+                index = 0;
+            }
+
+            Event& event = block->events[ index ];
+            copyTruncated( event.name, name );
+            copyTruncated( event.detail, detail );
+            event.category = category;
+            event.start = start;
+            event.duration = duration;
+            block->count.store( index + 1, std::memory_order_release );
+        }
+
+        Trace::ThreadBuffer& Trace::getThreadBuffer()
+        {
+            static thread_local ThreadBuffer* threadBuffer = nullptr;
+            if( !threadBuffer )
+            {
+                auto& registry = getRegistry();
+                std::lock_guard< std::mutex > lock( registry.mutex );
+                registry.buffers.emplace_back( new ThreadBuffer() );
+                threadBuffer = registry.buffers.back().get();
+                threadBuffer->id = registry.buffers.size();
+            }
+            return *threadBuffer;
+        }
+
+        Trace::Registry& Trace::getRegistry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        template< size_t Size >
+        void Trace::copyTruncated( char ( &target )[ Size ], const std::string& source )
+        {
+            size_t length = source.size();
+            if( length >= Size )
+            {
+                length = Size - 1;
+                // Do not cut in the middle of a multi-byte character. Continuation bytes look like 10xxxxxx.
+                while( ( length > 0 ) && ( ( static_cast< unsigned char >( source[ length ] ) & 0xC0 ) == 0x80 ) )
+                {
+                    length--;
+                }
+            }
+            source.copy( target, length );
+            target[ length ] = '\0';
+        }
+
+        void Trace::writeJSONString( std::ostream& out, const char* value )
+        {
+            out << '"';
+            for( const char* c = value; *c; ++c )
+            {
+                switch( *c )
+                {
+                    case '"':
+                        out << "\\\"";
+                        break;
+                    case '\\':
+                        out << "\\\\";
+                        break;
+                    case '\n':
+                        out << "\\n";
+                        break;
+                    case '\t':
+                        out << "\\t";
+                        break;
+                    default:
+                        if( static_cast< unsigned char >( *c ) < 0x20 )
+                        {
+                            char escaped[ 8 ];
+                            std::snprintf( escaped, sizeof( escaped ), "\\u%04x", static_cast< unsigned int >( *c ) );
+                            out << escaped;
+                        }
+                        else
+                        {
+                            out << *c;
+                        }
+                }
+            }
+            out << '"';
+        }
+
+        TraceSpan::TraceSpan( const char* category, const std::string& name, const std::string& detail ):
+            m_active( Trace::isEnabled() ),
+            m_category( category )
+        {
+            if( m_active )
+            {
+                m_name = name;
+                m_detail = detail;
+                m_start = Trace::now();
+            }
+        }
+
+        TraceSpan::~TraceSpan()
+        {
+            if( m_active )
+            {
+                Trace::record( m_category, m_name, m_detail, m_start, Trace::now() - m_start );
+            }
+        }
+    }
+}
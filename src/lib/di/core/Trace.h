@@ -0,0 +1,243 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_TRACE_H
+#define DI_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Records a timeline of what the threads of the application did. Use \ref TraceSpan to mark a piece of work. The recorded timeline can
+         * be written in the Chrome trace event format at any time. Load it in chrome://tracing or https://ui.perfetto.dev.
+         *
+         * Tracing is disabled by default. Then, a span costs a single atomic load. When enabled, each thread records into its own buffer
+         * without locking. Only naming a thread, the first event of an unnamed thread and writing the trace take a lock. The event memory of a
+         * thread is allocated by its first event.
+         */
+        class Trace
+        {
+            friend class TraceSpan;
+        public:
+            /**
+             * Enable or disable tracing. Events recorded so far are kept.
+             *
+             * \param enabled true to record events
+             */
+            static void setEnabled( bool enabled );
+
+            /**
+             * Check whether tracing is enabled.
+             *
+             * \return true if events get recorded.
+             */
+            static bool isEnabled();
+
+            /**
+             * Name the calling thread in the trace. Recorded even if tracing is disabled. This does not allocate memory for events.
+             *
+             * \param name the name
+             */
+            static void setThreadName( const std::string& name );
+
+            /**
+             * Record an event without duration. Use this to mark points in time, like the cancellation of a run.
+             *
+             * \param category the category. Needs to be a string literal as only the pointer is stored.
+             * \param name the name of the event
+             * \param detail additional information shown along with the event. Can be empty.
+             */
+            static void instant( const char* category, const std::string& name, const std::string& detail = "" );
+
+            /**
+             * Write all events recorded so far as JSON in the Chrome trace event format. Threads can record while writing. Their new events might
+             * or might not be included.
+             *
+             * \param out the stream to write to
+             */
+            static void write( std::ostream& out );
+
+            /**
+             * Write all events recorded so far to the given file. See \ref write( std::ostream& ).
+             *
+             * \param filename the file to write. Overwritten if existing.
+             *
+             * \throw std::ios_base::failure if the file cannot be written.
+             */
+            static void write( const std::string& filename );
+
+        protected:
+        private:
+            /**
+             * A recorded event.
+             */
+            struct Event;
+
+            /**
+             * A fixed-size part of the events of a thread.
+             */
+            struct Block;
+
+            /**
+             * The events of a thread.
+             */
+            struct ThreadBuffer;
+
+            /**
+             * All thread buffers.
+             */
+            struct Registry;
+
+            /**
+             * Only static functions.
+             */
+            Trace() = delete;
+
+            /**
+             * The current time in nanoseconds since the first use of the trace.
+             *
+             * \return the time
+             */
+            static int64_t now();
+
+            /**
+             * Record an event to the buffer of the calling thread. Does not check whether tracing is enabled.
+             *
+             * \param category the category. Needs to be a string literal.
+             * \param name the name. Truncated if too long.
+             * \param detail additional info. Truncated if too long.
+             * \param start the start as returned by \ref now()
+             * \param duration the duration in nanoseconds. Negative for instant events.
+             */
+            static void record( const char* category, const std::string& name, const std::string& detail, int64_t start, int64_t duration );
+
+            /**
+             * Get the buffer of the calling thread. Creates and registers it on the first use. Its blocks are created by \ref record.
+             *
+             * \return the buffer
+             */
+            static ThreadBuffer& getThreadBuffer();
+
+            /**
+             * Get the registry of all thread buffers. Created on first use to avoid issues with the order of static initialization.
+             *
+             * \return the registry
+             */
+            static Registry& getRegistry();
+
+            /**
+             * Copy a string to a fixed-size buffer. Cuts at a UTF-8 character boundary if it is too long.
+             *
+             * \tparam Size the buffer size
+             * \param target the buffer
+             * \param source the string
+             */
+            template< size_t Size >
+            static void copyTruncated( char ( &target )[ Size ], const std::string& source );
+
+            /**
+             * Write a string as quoted JSON string.
+             *
+             * \param out the stream
+             * \param value the null-terminated string
+             */
+            static void writeJSONString( std::ostream& out, const char* value );
+
+            /**
+             * Tracing on or off.
+             */
+            static std::atomic< bool > m_enabled;
+        };
+
+        /**
+         * Marks a piece of work in the trace. The span starts with its construction and ends with its destruction. Simply put it at the beginning
+         * of the scope to measure. If tracing is disabled while constructing, nothing gets recorded.
+         */
+        class TraceSpan
+        {
+        public:
+            /**
+             * Start the span.
+             *
+             * \param category the category. Needs to be a string literal as only the pointer is stored.
+             * \param name the name of the work done
+             * \param detail additional information shown along with the span, like a filename. Can be empty.
+             */
+            TraceSpan( const char* category, const std::string& name, const std::string& detail = "" );
+
+            /**
+             * End the span and record it.
+             */
+            virtual ~TraceSpan();
+
+        protected:
+        private:
+            /**
+             * Forbid copy.
+             */
+            TraceSpan( const TraceSpan& ) = delete;
+
+            /**
+             * Forbid assignment.
+             *
+             * \return nothing
+             */
+            TraceSpan& operator=( const TraceSpan& ) = delete;
+
+            /**
+             * True if tracing was enabled on construction.
+             */
+            bool m_active = false;
+
+            /**
+             * The category.
+             */
+            const char* m_category = nullptr;
+
+            /**
+             * The name. Only set if active.
+             */
+            std::string m_name;
+
+            /**
+             * The detail. Only set if active.
+             */
+            std::string m_detail;
+
+            /**
+             * The start time.
+             */
+            int64_t m_start = 0;
+        };
+    }
+}
+
+#endif  // DI_TRACE_H
+
@@ -0,0 +1,167 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_VOLUMECONNECTOR_H
+#define DI_VOLUMECONNECTOR_H
+
+#include <string>
+
+#include <di/core/Connector.h>
+#include <di/core/ConnectorTransferable.h>
+#include <di/core/data/DataSetTypes.h>
+#include <di/core/data/ValueConversion.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A connector for scalar volumes that accepts volumes of any supported value type (double, float, uint16_t, uint8_t). Volumes of other
+         * value types are converted when they are set. Use this as input to allow connecting volume algorithms with different value types.
+         *
+         * \tparam ValueT the value type the owning algorithm works with.
+         */
+        template< typename ValueT >
+        class VolumeConnector: public Connector< DataSetScalarRegular3< ValueT > >
+        {
+        public:
+            /**
+             * The type of the data handled by this connector.
+             */
+            typedef DataSetScalarRegular3< ValueT > DataType;
+
+            /**
+             * Create a new volume connector.
+             *
+             * \param name the name of the connector
+             * \param description a useful description
+             */
+            VolumeConnector( const std::string& name, const std::string& description ):
+                Connector< DataType >( name, description )
+            {
+            }
+
+            /**
+             * Destructor.
+             */
+            virtual ~VolumeConnector()
+            {
+            }
+
+            /**
+             * Check whether the given data is a scalar volume of any supported type.
+             *
+             * \param checkAgainst the data to check
+             *
+             * \return true if it can be set.
+             */
+            virtual bool isTransferable( ConstSPtr< ConnectorTransferable > checkAgainst ) const
+            {
+                return ( std::dynamic_pointer_cast< const DataSetScalarRegular3< double > >( checkAgainst ) != nullptr ) ||
+                       ( std::dynamic_pointer_cast< const DataSetScalarRegular3< float > >( checkAgainst ) != nullptr ) ||
+                       ( std::dynamic_pointer_cast< const DataSetScalarRegular3< uint16_t > >( checkAgainst ) != nullptr ) ||
+                       ( std::dynamic_pointer_cast< const DataSetScalarRegular3< uint8_t > >( checkAgainst ) != nullptr );
+            }
+
+            /**
+             * Set the data. Converts the values if needed.
+             *
+             * \param data the data
+             *
+             * \return true if the data was a scalar volume. If not, the connector data is reset.
+             */
+            virtual bool setTransferable( ConstSPtr< ConnectorTransferable > data )
+            {
+                // Converted this data already?
+                if( data && ( data == getSourceTransferable() ) )
+                {
+                    return true;
+                }
+
+                // Same type? No need to convert.
+                ConstSPtr< DataType > result = std::dynamic_pointer_cast< const DataType >( data );
+                result = result ? result : convertFrom< double >( data );
+                result = result ? result : convertFrom< float >( data );
+                result = result ? result : convertFrom< uint16_t >( data );
+                result = result ? result : convertFrom< uint8_t >( data );
+
+                this->setData( result );
+                m_source = data;
+                m_converted = result;
+                return ( result != nullptr );
+            }
+
+            /**
+             * Get the volume as it was set, before conversion.
+             *
+             * \return the unconverted volume. If the data was set without \ref setTransferable, this is the data itself.
+             */
+            virtual ConstSPtr< ConnectorTransferable > getSourceTransferable() const
+            {
+                if( this->getData() && ( this->getData() == m_converted ) )
+                {
+                    return m_source;
+                }
+                return this->getTransferable();
+            }
+
+        protected:
+        private:
+            /**
+             * The data last given to \ref setTransferable.
+             */
+            ConstSPtr< ConnectorTransferable > m_source;
+
+            /**
+             * The result of converting \ref m_source.
+             */
+            ConstSPtr< DataType > m_converted;
+
+            /**
+             * Convert the data if it is a scalar volume of the given value type.
+             *
+             * \tparam SourceT the value type of the source volume
+             * \param data the data
+             *
+             * \return the converted volume or nullptr if the data is of another type.
+             */
+            template< typename SourceT >
+            static ConstSPtr< DataType > convertFrom( ConstSPtr< ConnectorTransferable > data )
+            {
+                auto source = std::dynamic_pointer_cast< const DataSetScalarRegular3< SourceT > >( data );
+                if( !source )
+                {
+                    return nullptr;
+                }
+                return std::make_shared< DataType >( source->getName(), source->getGrid(),
+                                                     convertValues< ValueT >( *source->template getAttributes< 0 >() ) );
+            }
+        };
+    }
+}
+
+#endif  // DI_VOLUMECONNECTOR_H
+
@@ -0,0 +1,147 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <exception>
+#include <string>
+#include <utility>
+
+#include <di/core/Parallel.h>
+#include <di/core/Trace.h>
+
+#include "WorkerPool.h"
+
+#include <di/core/Logger.h>
+#define LogTag "core/WorkerPool"
+
+namespace di
+{
+    namespace core
+    {
+        WorkerPool::WorkerPool( size_t numThreads, const std::string& name ):
+            m_numThreads( ( numThreads == 0 ) ? di::core::getNumberOfThreads() : numThreads ),
+            m_name( name )
+        {
+        }
+
+        WorkerPool::~WorkerPool()
+        {
+            stop();
+        }
+
+        void WorkerPool::start()
+        {
+            std::lock_guard< std::mutex > lock( m_tasksMutex );
+            if( m_running || !m_threads.empty() )
+            {
+                return;
+            }
+
+            m_running = true;
+            for( size_t i = 0; i < m_numThreads; ++i )
+            {
+                m_threads.push_back( std::thread( &WorkerPool::run, this ) );
+            }
+        }
+
+        void WorkerPool::stop()
+        {
+            std::unique_lock< std::mutex > lock( m_tasksMutex );
+            m_running = false;
+            lock.unlock();
+            m_tasksCond.notify_all();
+
+            for( auto& thread : m_threads )
+            {
+                thread.join();
+            }
+            m_threads.clear();
+        }
+
+        bool WorkerPool::submit( Task task )
+        {
+            std::unique_lock< std::mutex > lock( m_tasksMutex );
+            if( !m_running )
+            {
+                return false;
+            }
+            m_tasks.push_back( std::move( task ) );
+            lock.unlock();
+
+            m_tasksCond.notify_one();
+            return true;
+        }
+
+        bool WorkerPool::isRunning() const
+        {
+            std::lock_guard< std::mutex > lock( m_tasksMutex );
+            return m_running;
+        }
+
+        size_t WorkerPool::getNumberOfThreads() const
+        {
+            return m_numThreads;
+        }
+
+        void WorkerPool::run()
+        {
+            Trace::setThreadName( m_name );
+
+            std::unique_lock< std::mutex > lock( m_tasksMutex );
+            while( true )
+            {
+                m_tasksCond.wait( lock,
+                                  [ this ]
+                                  {
+                                      return !m_running || !m_tasks.empty();
+                                  }
+                                );
+
+                // Only stop if there is nothing left to do.
+                if( m_tasks.empty() )
+                {
+                    return;
+                }
+
+                Task task = std::move( m_tasks.front() );
+                m_tasks.pop_front();
+
+                // Do not block other workers while processing.
+                lock.unlock();
+                try
+                {
+                    task();
+                }
+                catch( const std::exception& e )
+                {
+                    LogE << "Task failed with exception: " << e.what() << LogEnd;
+                }
+                catch( ... )
+                {
+                    LogE << "Task failed with unknown exception." << LogEnd;
+                }
+                lock.lock();
+            }
+        }
+    }
+}
@@ -0,0 +1,144 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_WORKERPOOL_H
+#define DI_WORKERPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A fixed set of threads processing submitted tasks in FIFO order. In contrast to \ref parallelFor, the tasks are independent of each
+         * other and the caller does not wait for them. Use this for long-running, blocking work like file I/O.
+         */
+        class WorkerPool
+        {
+        public:
+            /**
+             * Task type.
+             */
+            typedef std::function< void() > Task;
+
+            /**
+             * Create a pool. This does not start any thread. Use \ref start().
+             *
+             * \param numThreads the number of threads. If 0, \ref getNumberOfThreads is used.
+             * \param name the name of the threads. Shown in the trace.
+             */
+            explicit WorkerPool( size_t numThreads = 0, const std::string& name = "Worker" );
+
+            /**
+             * Clean up. Stops the pool and waits for all queued tasks.
+             */
+            virtual ~WorkerPool();
+
+            /**
+             * Start the threads. Ignored if running already.
+             */
+            void start();
+
+            /**
+             * Stop the pool. All tasks submitted before are finished. The function blocks until all threads have stopped. New tasks are refused.
+             */
+            void stop();
+
+            /**
+             * Queue a task. Tasks must not throw. Exceptions escaping a task are logged and ignored.
+             *
+             * \param task the task
+             *
+             * \return false if the pool is not running. The task was not queued then.
+             */
+            bool submit( Task task );
+
+            /**
+             * Check whether the pool accepts tasks.
+             *
+             * \return true if running.
+             */
+            bool isRunning() const;
+
+            /**
+             * The number of threads.
+             *
+             * \return the thread count
+             */
+            size_t getNumberOfThreads() const;
+
+        protected:
+        private:
+            /**
+             * Thread method. Processes tasks until the pool stops and the queue is empty.
+             */
+            void run();
+
+            /**
+             * The number of threads to use.
+             */
+            size_t m_numThreads;
+
+            /**
+             * The name of the threads.
+             */
+            std::string m_name;
+
+            /**
+             * The threads.
+             */
+            std::vector< std::thread > m_threads;
+
+            /**
+             * The queued tasks.
+             */
+            std::deque< Task > m_tasks;
+
+            /**
+             * Protects m_tasks and m_running.
+             */
+            mutable std::mutex m_tasksMutex;
+
+            /**
+             * Notifies the threads about new tasks or stopping.
+             */
+            std::condition_variable m_tasksCond;
+
+            /**
+             * True while tasks are accepted.
+             */
+            bool m_running = false;
+        };
+    }
+}
+
+#endif  // DI_WORKERPOOL_H
+
@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_WRITER_H
+#define DI_WRITER_H
+
+#include <string>
+
+#include <di/core/data/DataSetBase.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Interface to all file writer implementations. This is the counterpart to \ref Reader. Like readers, writers are const and have no
+         * side-effects besides the file they write.
+         */
+        class Writer
+        {
+        public:
+            /**
+             * Check whether the specified data can be written to the given file.
+             *
+             * \param filename the file to write
+             * \param data the data to write
+             *
+             * \return true if this implementation is able to write the data.
+             */
+            virtual bool canWrite( const std::string& filename, ConstSPtr< DataSetBase > data ) const = 0;
+
+            /**
+             * Write the data to the specified file. This throws an exception if something went wrong.
+             *
+             * \param filename the file to write
+             * \param data the data to write
+             */
+            virtual void write( const std::string& filename, ConstSPtr< DataSetBase > data ) const = 0;
+
+        protected:
+            /**
+             * Constructor.
+             */
+            Writer();
+
+            /**
+             * Destructor.
+             */
+            virtual ~Writer();
+        private:
+        };
+    }
+}
+
+#endif  // DI_WRITER_H
+
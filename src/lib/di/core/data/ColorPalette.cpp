@@ -0,0 +1,113 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <di/core/Parallel.h>
+
+#include "ColorPalette.h"
+
+namespace di
+{
+    namespace core
+    {
+        uint32_t packColor( const glm::vec4& color )
+        {
+            auto c = glm::round( glm::clamp( color, 0.0f, 1.0f ) * 255.0f );
+            return static_cast< uint32_t >( c.r ) |
+                   ( static_cast< uint32_t >( c.g ) << 8 ) |
+                   ( static_cast< uint32_t >( c.b ) << 16 ) |
+                   ( static_cast< uint32_t >( c.a ) << 24 );
+        }
+
+        ColorPalette extractColorPalette( const RGBAArray& colors, bool createLabels )
+        {
+            // Each chunk collects its distinct colors, together with the index of their first occurrence inside the chunk.
+            size_t numChunks = getNumberOfThreads();
+            std::vector< std::unordered_map< uint32_t, size_t > > chunkColors( numChunks );
+            parallelFor( 0, colors.size(),
+                [ & ]( size_t begin, size_t end, size_t chunk )
+                {
+                    auto& distinct = chunkColors[ chunk ];
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        // NOTE: emplace would allocate a node even if the color is known already.
+                        uint32_t color = packColor( colors[ i ] );
+                        if( distinct.find( color ) == distinct.end() )
+                        {
+                            distinct.emplace( color, i );
+                        }
+                    }
+                },
+                numChunks
+            );
+
+            // Merge. Chunks are in ascending order, so the first chunk containing a color knows its first occurrence.
+            std::unordered_map< uint32_t, size_t > distinctColors;
+            for( const auto& distinct : chunkColors )
+            {
+                for( const auto& entry : distinct )
+                {
+                    distinctColors.emplace( entry );
+                }
+            }
+
+            std::vector< size_t > firstOccurrences;
+            firstOccurrences.reserve( distinctColors.size() );
+            for( const auto& entry : distinctColors )
+            {
+                firstOccurrences.push_back( entry.second );
+            }
+            std::sort( firstOccurrences.begin(), firstOccurrences.end() );
+
+            // From now on, map to the palette index.
+            ColorPalette palette;
+            palette.colors.reserve( firstOccurrences.size() );
+            for( auto index : firstOccurrences )
+            {
+                distinctColors[ packColor( colors[ index ] ) ] = palette.colors.size();
+                palette.colors.push_back( colors[ index ] );
+            }
+
+            if( createLabels )
+            {
+                palette.labels.resize( colors.size() );
+                parallelFor( 0, colors.size(),
+                    [ & ]( size_t begin, size_t end, size_t )
+                    {
+                        for( size_t i = begin; i < end; ++i )
+                        {
+                            palette.labels[ i ] = distinctColors.find( packColor( colors[ i ] ) )->second;
+                        }
+                    }
+                );
+            }
+
+            return palette;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#ifndef DI_COLORPALETTE_H
+#define DI_COLORPALETTE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <di/GfxTypes.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Pack a color into 8 bit per channel. Channels are clamped to [0, 1] and rounded.
+         *
+         * \param color the color
+         *
+         * \return the packed color. Red is stored in the least significant byte.
+         */
+        uint32_t packColor( const glm::vec4& color );
+
+        /**
+         * The distinct colors of a color array, together with the palette entry of each color. This is what is needed to use colors as labels.
+         * Colors are compared with 8 bit per channel. This is the precision of usual color sources like PLY files.
+         */
+        struct ColorPalette
+        {
+            /**
+             * The distinct colors in order of their first occurrence.
+             */
+            RGBAArray colors;
+
+            /**
+             * For each input color, the index of its entry in \ref colors. Empty if not requested.
+             */
+            std::vector< size_t > labels;
+        };
+
+        /**
+         * Find the distinct colors of an array. This uses hash sets of packed colors, built in parallel. The result does not depend on the
+         * number of threads.
+         *
+         * \param colors the colors
+         * \param createLabels if true, \ref ColorPalette::labels is filled. If you only need the number of distinct colors, leave it false.
+         *
+         * \return the palette
+         */
+        ColorPalette extractColorPalette( const RGBAArray& colors, bool createLabels = false );
+    }
+}
+
+#endif  // DI_COLORPALETTE_H
+
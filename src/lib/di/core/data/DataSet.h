@@ -27,6 +27,8 @@
 
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include <di/core/data/DataSetBase.h>
 
@@ -90,8 +92,68 @@ namespace di
                 return std::get< Index >( m_attributes );
             }
 
+            /**
+             * The memory used by the grid and the attributes.
+             *
+             * \return the size in bytes
+             */
+            virtual size_t getMemorySize() const override;
+
         protected:
         private:
+            /**
+             * The memory used by the values of an attribute container.
+             *
+             * \tparam ContainerT a container with size() and value_type, like std::vector or ValueArray.
+             * \param values the container
+             *
+             * \return the size in bytes
+             */
+            template< typename ContainerT >
+            static size_t getMemorySize( const ContainerT& values )
+            {
+                return values.size() * sizeof( typename ContainerT::value_type );
+            }
+
+            /**
+             * The memory used by a bit vector.
+             *
+             * \param values the container
+             *
+             * \return the size in bytes
+             */
+            static size_t getMemorySize( const std::vector< bool >& values )
+            {
+                return ( values.size() + 7 ) / 8;
+            }
+
+            /**
+             * Sum up the memory of the attributes, starting at the given index. End of recursion.
+             *
+             * \tparam Index the attribute index
+             *
+             * \return 0
+             */
+            template< size_t Index >
+            typename std::enable_if< ( Index == sizeof...( AttributeT ) ), size_t >::type getAttributesMemorySize() const
+            {
+                return 0;
+            }
+
+            /**
+             * Sum up the memory of the attributes, starting at the given index.
+             *
+             * \tparam Index the attribute index
+             *
+             * \return the size in bytes
+             */
+            template< size_t Index >
+            typename std::enable_if< ( Index < sizeof...( AttributeT ) ), size_t >::type getAttributesMemorySize() const
+            {
+                auto attribute = std::get< Index >( m_attributes );
+                return ( attribute ? getMemorySize( *attribute ) : 0 ) + getAttributesMemorySize< Index + 1 >();
+            }
+
             /**
              * The grid of the dataset.
              */
@@ -124,6 +186,12 @@ namespace di
         {
             return m_grid;
         }
+
+        template< typename GridT, typename... AttributeT >
+        size_t DataSet< GridT, AttributeT... >::getMemorySize() const
+        {
+            return ( m_grid ? m_grid->getMemorySize() : 0 ) + getAttributesMemorySize< 0 >();
+        }
     }
 }
 
@@ -44,5 +44,15 @@ namespace di
         {
             return m_name;
         }
+
+        bool DataSetBase::isPreview() const
+        {
+            return m_preview;
+        }
+
+        void DataSetBase::setPreview( bool preview )
+        {
+            m_preview = preview;
+        }
     }
 }
@@ -59,12 +59,32 @@ namespace di
              * \return the dataset name
              */
             const std::string& getName() const;
+
+            /**
+             * Check whether this dataset is an incomplete snapshot of data that is still being loaded. Previews are good enough for rendering, but
+             * algorithms doing expensive or final processing should ignore them and wait for the complete data.
+             *
+             * \return true if this is a preview.
+             */
+            bool isPreview() const;
+
+            /**
+             * Mark this dataset as preview. Only use this before handing the dataset to others.
+             *
+             * \param preview true if this dataset is incomplete.
+             */
+            void setPreview( bool preview = true );
         protected:
         private:
             /**
              * The name
              */
             std::string m_name = "";
+
+            /**
+             * True if the data is incomplete.
+             */
+            bool m_preview = false;
         };
     }
 }
@@ -25,12 +25,14 @@
 #ifndef DI_DATASETTYPES_H
 #define DI_DATASETTYPES_H
 
+#include <cstdint>
 #include <vector>
 
 #include <di/core/data/DataSet.h>
 #include <di/core/data/GridRegular.h>
 #include <di/core/data/GridTransformation.h>
 #include <di/core/data/GridBuilders.h>
+#include <di/core/data/ValueArray.h>
 
 #include <di/core/data/LineDataSet.h>
 #include <di/core/data/PointDataSet.h>
@@ -42,10 +44,33 @@ namespace di
 {
     namespace core
     {
+        /**
+         * Scalar dataset in a 3D regular grid.
+         *
+         * \tparam ValueT the type of the values. The volume algorithms support double, float, uint16_t and uint8_t.
+         */
+        template< typename ValueT >
+        using DataSetScalarRegular3 = DataSet< GridRegular3, ValueArray< ValueT > >;
+
         /**
          * Dataset in a 3D regular grid. The "d" in the name stands for "double".
          */
-        typedef DataSet< GridRegular3, std::vector< double > > DataSetScalarRegular3d;
+        typedef DataSetScalarRegular3< double > DataSetScalarRegular3d;
+
+        /**
+         * Dataset in a 3D regular grid. The "f" in the name stands for "float".
+         */
+        typedef DataSetScalarRegular3< float > DataSetScalarRegular3f;
+
+        /**
+         * Dataset in a 3D regular grid. The "u16" in the name stands for "uint16_t".
+         */
+        typedef DataSetScalarRegular3< uint16_t > DataSetScalarRegular3u16;
+
+        /**
+         * Dataset in a 3D regular grid. The "u8" in the name stands for "uint8_t". Useful for masks.
+         */
+        typedef DataSetScalarRegular3< uint8_t > DataSetScalarRegular3u8;
 
         /**
          * Dataset in a 3D regular grid. The "v3" in the name stands for "vector 3".
@@ -61,6 +86,11 @@ namespace di
          * A vector field given on a triangle mesh
          */
         typedef di::core::DataSet< TriangleMesh, di::Vec3Array > TriangleVectorField;
+
+        /**
+         * A vector field given on a triangle mesh, along with the vertex colors and region labels it was computed from. Useful to export results.
+         */
+        typedef di::core::DataSet< TriangleMesh, di::Vec3Array, di::RGBAArray, ValueArray< int32_t > > TriangleAnnotatedVectorField;
     }
 }
 
@@ -277,6 +277,16 @@ namespace di
                 return accumulateSizes( Dimensions );
             }
 
+            /**
+             * The memory used by the grid. The grid is implicit. Its size does not depend on the number of voxels.
+             *
+             * \return the size in bytes
+             */
+            size_t getMemorySize() const
+            {
+                return sizeof( *this );
+            }
+
             /**
              * Get the size of the grid along the given axis. If the queried dimension does not exist in this grid, 1 is returned as every 2D grid is
              * a cube with a depth of only 1 voxel and so on.
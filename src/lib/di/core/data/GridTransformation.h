@@ -86,7 +86,8 @@ namespace di
              * \param matrix the matrix.
              */
             explicit GridTransformation( const glm::mat4& matrix ):
-                m_matrix( matrix )
+                m_matrix( matrix ),
+                m_inverse( glm::inverse( m_matrix ) )
             {
             }
 
@@ -117,12 +118,40 @@ namespace di
                 return glm::vec3( result.x, result.y, result.z );
             }
 
+            /**
+             * Get the matrix transforming world-space coordinates to grid-space.
+             *
+             * \return the matrix
+             */
+            const glm::dmat4& getMatrix() const
+            {
+                return m_matrix;
+            }
+
+            /**
+             * Transform the specified grid-space vector back to world space. This is the inverse of operator*.
+             *
+             * \param v the vector in grid-space
+             *
+             * \return the transformed vector in world-space
+             */
+            glm::vec3 toWorld( const glm::vec3& v ) const
+            {
+                auto result = m_inverse * glm::dvec4( v, 1.0 );
+                return glm::vec3( result.x, result.y, result.z );
+            }
+
         protected:
         private:
             /**
              * The matrix representing the transformation. FROM world-space TO grid-space
              */
             glm::dmat4 m_matrix;
+
+            /**
+             * The inverse of m_matrix. FROM grid-space TO world-space.
+             */
+            glm::dmat4 m_inverse;
         };
     }
 }
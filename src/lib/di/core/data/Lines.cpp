@@ -114,6 +114,11 @@ namespace di
             return m_vertices.size();
         }
 
+        size_t Lines::getMemorySize() const
+        {
+            return m_vertices.size() * sizeof( Vec3Array::value_type ) + m_lines.size() * sizeof( IndexVec2Array::value_type );
+        }
+
         bool Lines::sanityCheck() const
         {
             bool enoughLines = ( getNumLines() >= 1 );
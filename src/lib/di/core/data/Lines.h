@@ -173,6 +173,13 @@ namespace di
              */
             size_t getNumVertices() const;
 
+            /**
+             * The memory used by the vertices and lines.
+             *
+             * \return the size in bytes
+             */
+            size_t getMemorySize() const;
+
             /**
              * Checks if the data is reasonable. Basically, this ensures that there is at least one line and that there are enough vertices.
              *
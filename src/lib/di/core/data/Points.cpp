@@ -67,6 +67,11 @@ namespace di
             return m_vertices.size();
         }
 
+        size_t Points::getMemorySize() const
+        {
+            return m_vertices.size() * sizeof( Vec3Array::value_type );
+        }
+
         const BoundingBox& Points::getBoundingBox() const
         {
             return m_boundingBox;
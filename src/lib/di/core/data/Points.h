@@ -123,6 +123,13 @@ namespace di
              */
             size_t getNumVertices() const;
 
+            /**
+             * The memory used by the vertices.
+             *
+             * \return the size in bytes
+             */
+            size_t getMemorySize() const;
+
             /**
              * Get the bounding volume of these points.
              *
@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+#include <di/core/Parallel.h>
+
+#include "SlabStreaming.h"
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * The memory budget in bytes.
+         */
+        static std::atomic< size_t > g_memoryBudget( size_t( 2 ) * 1024 * 1024 * 1024 );
+
+        /**
+         * The swap directory. Empty means default.
+         */
+        static std::string g_swapDirectory = "";
+
+        /**
+         * Protects g_swapDirectory.
+         */
+        static std::mutex g_swapDirectoryMutex;
+
+        void setMemoryBudget( size_t bytes )
+        {
+            g_memoryBudget = bytes;
+        }
+
+        size_t getMemoryBudget()
+        {
+            return g_memoryBudget;
+        }
+
+        void setSwapDirectory( const std::string& directory )
+        {
+            std::lock_guard< std::mutex > lock( g_swapDirectoryMutex );
+            if( directory.empty() || ( directory.back() == '/' ) || ( directory.back() == '\\' ) )
+            {
+                g_swapDirectory = directory;
+            }
+            else
+            {
+                g_swapDirectory = directory + "/";
+            }
+        }
+
+        std::string getSwapDirectory()
+        {
+            std::lock_guard< std::mutex > lock( g_swapDirectoryMutex );
+            if( !g_swapDirectory.empty() )
+            {
+                return g_swapDirectory;
+            }
+
+            const char* tmp = std::getenv( "TMPDIR" );
+            std::string directory = ( tmp && *tmp ) ? tmp : "/tmp";
+            return ( directory.back() == '/' ) ? directory : directory + "/";
+        }
+
+        size_t getSlabDepth( size_t sizeZ, size_t bytesPerLayer )
+        {
+            size_t threads = getNumberOfThreads();
+            size_t maxByBudget = ( getMemoryBudget() / 2 ) / std::max( threads * bytesPerLayer, size_t( 1 ) );
+
+            // Several slabs per thread balance the load
+            size_t maxByBalance = ( sizeZ + 4 * threads - 1 ) / ( 4 * threads );
+
+            return std::max( size_t( 1 ), std::min( maxByBudget, maxByBalance ) );
+        }
+    }
+}
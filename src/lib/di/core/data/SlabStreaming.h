@@ -0,0 +1,184 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_SLABSTREAMING_H
+#define DI_SLABSTREAMING_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <di/core/MappedFile.h>
+#include <di/core/Parallel.h>
+#include <di/core/data/ValueArray.h>
+
+#include <di/Types.h>
+
+// Volumes are processed in slabs of consecutive Z layers. Large volumes are kept in swap files instead of memory. Together, this allows to filter
+// volumes larger than the physical memory.
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Set the amount of memory volume algorithms should try to stay within. Volume arrays larger than a quarter of this budget are placed in
+         * swap files. The budget also limits the size of the slabs.
+         *
+         * \param bytes the budget in bytes.
+         */
+        void setMemoryBudget( size_t bytes );
+
+        /**
+         * Get the memory budget. The default is 2 GB.
+         *
+         * \return the budget in bytes.
+         */
+        size_t getMemoryBudget();
+
+        /**
+         * Set the directory used for swap files.
+         *
+         * \param directory the directory. Use absolute paths.
+         */
+        void setSwapDirectory( const std::string& directory );
+
+        /**
+         * Get the directory used for swap files. Defaults to $TMPDIR or /tmp. Guaranteed to end with a directory separator.
+         *
+         * \return the directory
+         */
+        std::string getSwapDirectory();
+
+        /**
+         * Create a zero-initialized value array for a volume. If the array exceeds a quarter of the memory budget, it is backed by a swap file.
+         *
+         * \tparam ValueT the value type
+         * \param size the number of values
+         *
+         * \return the array
+         */
+        template< typename ValueT >
+        SPtr< ValueArray< ValueT > > createVolumeArray( size_t size )
+        {
+            size_t bytes = size * sizeof( ValueT );
+            if( bytes > getMemoryBudget() / 4 )
+            {
+                auto file = std::make_shared< MappedFile >( bytes, getSwapDirectory() );
+                return std::make_shared< ValueArray< ValueT > >( file, 0, size );
+            }
+            return std::make_shared< ValueArray< ValueT > >( size );
+        }
+
+        /**
+         * Calculate the number of Z layers per slab. All threads together keep at most half of the memory budget in slabs. Slabs are kept small
+         * enough to give each thread several slabs to work on.
+         *
+         * \param sizeZ the number of Z layers to process
+         * \param bytesPerLayer the memory touched per processed layer. Sum up input and output.
+         *
+         * \return the number of layers per slab. At least 1.
+         */
+        size_t getSlabDepth( size_t sizeZ, size_t bytesPerLayer );
+
+        /**
+         * Process the Z range [zBegin, zEnd) in slabs. A fixed number of worker threads pulls slabs in ascending order, which keeps the set of
+         * slabs in flight (and thus the pages in memory) small and close together. The functor is called as func( slabBegin, slabEnd ). It is
+         * responsible for reading its halo from the input and for releasing the processed layers (see \ref ValueArray::release). Exceptions are
+         * forwarded to the caller once all workers stopped. Remaining slabs are skipped after an exception. The CPU time of the workers is added
+         * to the \ref CPUTimeAccount of the calling thread.
+         *
+         * \tparam FunctionType something callable as func( size_t slabBegin, size_t slabEnd )
+         * \param zBegin the first layer
+         * \param zEnd the layer after the last one
+         * \param slabDepth the number of layers per slab. See \ref getSlabDepth.
+         * \param func the functor
+         */
+        template< typename FunctionType >
+        void processSlabs( size_t zBegin, size_t zEnd, size_t slabDepth, FunctionType func )
+        {
+            if( zEnd <= zBegin )
+            {
+                return;
+            }
+
+            slabDepth = std::max( slabDepth, size_t( 1 ) );
+            size_t numSlabs = ( zEnd - zBegin + slabDepth - 1 ) / slabDepth;
+
+            std::atomic< size_t > nextSlab( 0 );
+            std::atomic< bool > failed( false );
+            std::exception_ptr error;
+            std::mutex errorMutex;
+
+            auto worker = [ & ]()
+            {
+                for( size_t slab = nextSlab++; ( slab < numSlabs ) && !failed; slab = nextSlab++ )
+                {
+                    size_t slabBegin = zBegin + slab * slabDepth;
+                    size_t slabEnd = std::min( slabBegin + slabDepth, zEnd );
+                    try
+                    {
+                        func( slabBegin, slabEnd );
+                    }
+                    catch( ... )
+                    {
+                        std::lock_guard< std::mutex > lock( errorMutex );
+                        if( !error )
+                        {
+                            error = std::current_exception();
+                        }
+                        failed = true;
+                    }
+                }
+            };
+
+            // The calling thread is one of the workers
+            std::vector< std::thread > threads;
+            size_t numThreads = std::min( getNumberOfThreads(), numSlabs );
+            for( size_t i = 1; i < numThreads; ++i )
+            {
+                threads.push_back( startHelperThread( worker ) );
+            }
+            worker();
+
+            for( auto& thread : threads )
+            {
+                thread.join();
+            }
+
+            if( error )
+            {
+                std::rethrow_exception( error );
+            }
+        }
+    }
+}
+
+#endif  // DI_SLABSTREAMING_H
+
@@ -23,8 +23,12 @@
 //---------------------------------------------------------------------------------------
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <vector>
-#include <map>
+#include <utility>
+
+#include <di/core/Parallel.h>
 
 #include "TriangleMesh.h"
 
@@ -108,6 +112,12 @@ namespace di
             return m_vertices.size();
         }
 
+        size_t TriangleMesh::getMemorySize() const
+        {
+            return m_vertices.size() * sizeof( Vec3Array::value_type ) + m_triangles.size() * sizeof( IndexVec3Array::value_type ) +
+                   m_normals.size() * sizeof( NormalArray::value_type );
+        }
+
         size_t TriangleMesh::getNumNormals() const
         {
             return m_normals.size();
@@ -116,7 +126,7 @@ namespace di
         bool TriangleMesh::sanityCheck() const
         {
             bool enoughTris = ( getNumTriangles() >= 1 );
-            bool enoughNormals = ( getNumNormals() == 0 ) || ( getNumNormals() == getNumTriangles() );  // either a normal for every vertex or none.
+            bool enoughNormals = ( getNumNormals() == 0 ) || ( getNumNormals() == getNumVertices() );  // either a normal for every vertex or none.
             return enoughTris && enoughNormals;
         }
 
@@ -150,9 +160,32 @@ namespace di
             m_triangles = triangles;
         }
 
+        void TriangleMesh::setTriangles( IndexVec3Array&& triangles )
+        {
+            m_triangles = std::move( triangles );
+        }
+
         void TriangleMesh::setVertices( const Vec3Array& vertices )
         {
-            m_vertices = vertices;
+            setVertices( Vec3Array( vertices ) );
+        }
+
+        void TriangleMesh::setVertices( Vec3Array&& vertices )
+        {
+            m_vertices = std::move( vertices );
+
+            // The bounding box needs to match the new vertices.
+            m_boundingBox = BoundingBox();
+            for( const auto& vertex : m_vertices )
+            {
+                m_boundingBox.include( vertex );
+            }
+        }
+
+        void TriangleMesh::setVertices( Vec3Array&& vertices, const BoundingBox& boundingBox )
+        {
+            m_vertices = std::move( vertices );
+            m_boundingBox = boundingBox;
         }
 
         void TriangleMesh::setNormals( const NormalArray& normals )
@@ -160,6 +193,11 @@ namespace di
             m_normals = normals;
         }
 
+        void TriangleMesh::setNormals( NormalArray&& normals )
+        {
+            m_normals = std::move( normals );
+        }
+
         glm::vec3 TriangleMesh::getNormal( size_t vertexID ) const
         {
             return m_normals[ vertexID ];
@@ -167,28 +205,83 @@ namespace di
 
         void TriangleMesh::calculateInverseIndex() const
         {
-            // Clean up and create empty vector with as much empty elements as vertices.
-            m_inverseIndex.clear();
-            m_inverseIndex.resize( getNumVertices() );
+            std::lock_guard< std::mutex > lock( m_inverseIndexMutex );
+            buildInverseIndex();
+        }
+
+        void TriangleMesh::ensureInverseIndex() const
+        {
+            if( m_hasInverseIndex.load( std::memory_order_acquire ) )
+            {
+                return;
+            }
+
+            // Someone else might have built it while we waited.
+            std::lock_guard< std::mutex > lock( m_inverseIndexMutex );
+            if( !m_hasInverseIndex.load( std::memory_order_relaxed ) )
+            {
+                buildInverseIndex();
+            }
+        }
+
+        void TriangleMesh::buildInverseIndex() const
+        {
+            // Count the triangles per vertex. Offset i + 1 counts the triangles of vertex i for now.
+            std::vector< size_t > offsets( getNumVertices() + 1, 0 );
+            for( const auto& vertexIDs : m_triangles )
+            {
+                ++offsets[ vertexIDs.x + 1 ];
+                ++offsets[ vertexIDs.y + 1 ];
+                ++offsets[ vertexIDs.z + 1 ];
+            }
+
+            // Prefix sum turns counts into offsets.
+            for( size_t vertID = 1; vertID < offsets.size(); ++vertID )
+            {
+                offsets[ vertID ] += offsets[ vertID - 1 ];
+            }
 
             // iterate all triangles and map between vertex and triangle
             // NOTE: as the triangle Index is increasing, the inverse index is sorted automatically.
+            std::vector< size_t > triangles( offsets.back() );
+            std::vector< size_t > fill( offsets.begin(), offsets.end() - 1 );
             for( size_t triID = 0; triID < m_triangles.size(); ++triID )
             {
                 // get verts of this triangle
                 auto vertexIDs = m_triangles[ triID ];
-                m_inverseIndex[ vertexIDs.x ].push_back( triID );
-                m_inverseIndex[ vertexIDs.y ].push_back( triID );
-                m_inverseIndex[ vertexIDs.z ].push_back( triID );
+                triangles[ fill[ vertexIDs.x ]++ ] = triID;
+                triangles[ fill[ vertexIDs.y ]++ ] = triID;
+                triangles[ fill[ vertexIDs.z ]++ ] = triID;
             }
+
+            m_inverseIndexOffsets = std::move( offsets );
+            m_inverseIndexTriangles = std::move( triangles );
+            m_hasInverseIndex.store( true, std::memory_order_release );
+        }
+
+        void TriangleMesh::setInverseIndex( std::vector< size_t >&& offsets, std::vector< size_t >&& triangles )
+        {
+            std::lock_guard< std::mutex > lock( m_inverseIndexMutex );
+            m_inverseIndexOffsets = std::move( offsets );
+            m_inverseIndexTriangles = std::move( triangles );
+            m_hasInverseIndex.store( true, std::memory_order_release );
+        }
+
+        const std::vector< size_t >& TriangleMesh::getInverseIndexOffsets() const
+        {
+            ensureInverseIndex();
+            return m_inverseIndexOffsets;
+        }
+
+        const std::vector< size_t >& TriangleMesh::getInverseIndexTriangles() const
+        {
+            ensureInverseIndex();
+            return m_inverseIndexTriangles;
         }
 
         std::vector< size_t > TriangleMesh::getNeighbours( size_t triID ) const
         {
-            if( m_inverseIndex.empty() )
-            {
-                calculateInverseIndex();
-            }
+            ensureInverseIndex();
 
             // Get triangles of each vertex
             auto tris1 = getTrianglesForVertex( m_triangles[ triID ].x );
@@ -210,10 +303,7 @@ namespace di
 
         std::vector< size_t > TriangleMesh::getNeighbourVertices( size_t vertexID ) const
         {
-            if( m_inverseIndex.empty() )
-            {
-                calculateInverseIndex();
-            }
+            ensureInverseIndex();
 
             std::vector< size_t > result;
 
@@ -237,64 +327,70 @@ namespace di
             return result;
         }
 
-        const std::vector< size_t >& TriangleMesh::getTrianglesForVertex( size_t vertexID ) const
+        std::vector< size_t > TriangleMesh::getTrianglesForVertex( size_t vertexID ) const
         {
-            if( m_inverseIndex.empty() )
-            {
-                calculateInverseIndex();
-            }
+            ensureInverseIndex();
 
             // we already have this information:
-            return m_inverseIndex[ vertexID ];
+            return std::vector< size_t >( m_inverseIndexTriangles.begin() + m_inverseIndexOffsets[ vertexID ],
+                                          m_inverseIndexTriangles.begin() + m_inverseIndexOffsets[ vertexID + 1 ] );
         }
 
         void TriangleMesh::calculateNormals()
         {
-            m_normals.clear();
+            // The inverse index tells us the triangles that share a vertex. Triangles are sorted by ID there.
+            calculateInverseIndex();
 
-            // we want to keep track of the triangles that share a vertex
-            std::map< IndexVec3Array::value_type::value_type, std::vector< size_t > > vertexTriMap;
-
-            // iterate all triangles and map between vertex and triangle
-            for( size_t triID = 0; triID < m_triangles.size(); ++triID )
-            {
-                auto tri = m_triangles[ triID ];
-
-                // temporarily store a map between the vertex id and the corresponding triangle index. A reverse index so to say.
-                vertexTriMap[ tri.x ].push_back( triID );
-                vertexTriMap[ tri.y ].push_back( triID );
-                vertexTriMap[ tri.z ].push_back( triID );
-            }
+            NormalArray normals( m_vertices.size() );
 
             // we can now go through each vertex and
-            for( size_t vertID = 0; vertID < m_vertices.size(); ++vertID )
-            {
-                // store all triangle normals of all triangles associated with this vertex in here:
-                std::vector< glm::vec3 > neighbourNormals;
-
-                // and iterate each triangle it belongs:
-                for( auto triID : vertexTriMap[ vertID ] )
+            parallelFor( 0, m_vertices.size(),
+                [ this, &normals ]( size_t begin, size_t end, size_t )
                 {
-                    Triangle vertices = getVertices( triID );
-
-                    // do the typical cross-product style normal calculation:
-                    auto v1 = std::get< 1 >( vertices ) - std::get< 0 >( vertices );
-                    auto v2 = std::get< 2 >( vertices ) - std::get< 1 >( vertices );
-
-                    // cross product
-                    neighbourNormals.push_back( glm::normalize( glm::cross( v1, v2 ) ) );
+                    for( size_t vertID = begin; vertID < end; ++vertID )
+                    {
+                        // Merge the normals of all triangles using this vertex to get a smooth vertex normal:
+                        glm::vec3 smoothNormal( 0.0, 0.0, 0.0 );
+                        for( size_t i = m_inverseIndexOffsets[ vertID ]; i < m_inverseIndexOffsets[ vertID + 1 ]; ++i )
+                        {
+                            Triangle vertices = getVertices( m_inverseIndexTriangles[ i ] );
+
+                            // do the typical cross-product style normal calculation:
+                            auto v1 = std::get< 1 >( vertices ) - std::get< 0 >( vertices );
+                            auto v2 = std::get< 2 >( vertices ) - std::get< 1 >( vertices );
+
+                            // cross product
+                            smoothNormal += glm::normalize( glm::cross( v1, v2 ) );
+                        }
+
+                        // store the smooth normal for this vertex:
+                        normals[ vertID ] = glm::normalize( smoothNormal );
+                    }
                 }
+            );
+
+            m_normals = std::move( normals );
+        }
 
-                // we now have all triangle normals of the triangles that use this vertex. Merge the normals to get a smooth vertex normal:
-                glm::vec3 smoothNormal( 0.0, 0.0, 0.0 );
-                for( auto normal : neighbourNormals )
+        bool checkTriangleIndices( const IndexVec3Array& triangles, size_t numVertices, size_t first, size_t last )
+        {
+            int maxIndex = static_cast< int >( numVertices );
+            std::atomic< bool > validIndices( true );
+            di::core::parallelFor( first, std::min( last, triangles.size() ),
+                [ & ]( size_t begin, size_t end, size_t )
                 {
-                    smoothNormal += normal;
+                    for( size_t i = begin; ( i < end ) && validIndices; ++i )
+                    {
+                        const auto& t = triangles[ i ];
+                        if( ( t.x < 0 ) || ( t.y < 0 ) || ( t.z < 0 ) || ( t.x >= maxIndex ) || ( t.y >= maxIndex ) || ( t.z >= maxIndex ) )
+                        {
+                            validIndices = false;
+                            return;
+                        }
+                    }
                 }
-
-                // store the smooth normal for this vertex:
-                m_normals.push_back( glm::normalize( smoothNormal ) );
-            }
+            );
+            return validIndices;
         }
     }
 }
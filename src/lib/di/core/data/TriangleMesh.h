@@ -25,6 +25,9 @@
 #ifndef DI_TRIANGLEMESH_H
 #define DI_TRIANGLEMESH_H
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 #include <tuple>
 
@@ -131,6 +134,23 @@ namespace di
              */
             void setVertices( const Vec3Array& vertices );
 
+            /**
+             * Set the vertex array by moving the given one into the mesh. Previously added vertices will be overwritten. Use this when bulk-loading
+             * or generating meshes to avoid a copy.
+             *
+             * \param vertices the vertex array.
+             */
+            void setVertices( Vec3Array&& vertices );
+
+            /**
+             * Set the vertex array by moving the given one into the mesh, together with its known bounding box. This avoids iterating all vertices
+             * to find the bounding box. There are no sanity checks.
+             *
+             * \param vertices the vertex array.
+             * \param boundingBox the bounding box of the vertices
+             */
+            void setVertices( Vec3Array&& vertices, const BoundingBox& boundingBox );
+
             /**
              * Abbreviation for 3 vertices of a triangle.
              */
@@ -175,7 +195,7 @@ namespace di
              *
              * \return the list of triangles sharing this vertex. Is sorted.
              */
-            const std::vector< size_t >& getTrianglesForVertex( size_t vertexID ) const;
+            std::vector< size_t > getTrianglesForVertex( size_t vertexID ) const;
 
             /**
              * Get the list of vertices that are directly connected to the specified vertex.
@@ -211,6 +231,13 @@ namespace di
              */
             void setNormals( const NormalArray& normals );
 
+            /**
+             * Set the given normals by moving them into the mesh. Overwrites previously defined normals
+             *
+             * \param normals the normals to set
+             */
+            void setNormals( NormalArray&& normals );
+
             /**
              * Get the amount of normals for this mesh. A valid mesh will contain either 0 or exactly 1 for each vertex.
              *
@@ -232,6 +259,13 @@ namespace di
              */
             void setTriangles( const IndexVec3Array& triangles );
 
+            /**
+             * Set the triangle index array by moving the given one into the mesh. Overwrites previously set triangles.
+             *
+             * \param triangles the index array.
+             */
+            void setTriangles( IndexVec3Array&& triangles );
+
             /**
              * The number of triangles currently defined.
              *
@@ -246,6 +280,13 @@ namespace di
              */
             size_t getNumVertices() const;
 
+            /**
+             * The memory used by the vertices, triangles and normals. The inverse index is not included.
+             *
+             * \return the size in bytes
+             */
+            size_t getMemorySize() const;
+
             /**
              * Checks if the data is reasonable. Basically, this ensures that there is at least one triangle and that there are enough vertices. It
              * also checks that there are either no normals defined or exactly one per vertex.
@@ -268,11 +309,49 @@ namespace di
             void calculateNormals();
 
             /**
-             * Create an inverse index to find triangles associated with a given vertex.
+             * Create an inverse index to find triangles associated with a given vertex. The index is stored in compressed sparse row (CSR) form:
+             * the triangles of vertex i are m_inverseIndexTriangles[ m_inverseIndexOffsets[ i ] ] up to (excluding)
+             * m_inverseIndexTriangles[ m_inverseIndexOffsets[ i + 1 ] ].
+             *
+             * This rebuilds an existing index. Call it while creating the mesh, not while others use it. The getters build a missing index on
+             * their own. This is thread-safe.
              */
             void calculateInverseIndex() const;
+
+            /**
+             * Set a pre-built inverse index in CSR form. Useful if the generator of the mesh already knows the adjacency. See
+             * \ref calculateInverseIndex for the layout. There are no sanity checks.
+             *
+             * \param offsets the per-vertex offsets into triangles. Needs getNumVertices() + 1 entries.
+             * \param triangles the triangle IDs of all vertices, sorted per vertex.
+             */
+            void setInverseIndex( std::vector< size_t >&& offsets, std::vector< size_t >&& triangles );
+
+            /**
+             * Get the per-vertex offsets of the inverse index. See \ref calculateInverseIndex for the layout. Creates the index if needed.
+             *
+             * \return the offsets. getNumVertices() + 1 entries.
+             */
+            const std::vector< size_t >& getInverseIndexOffsets() const;
+
+            /**
+             * Get the triangle IDs of the inverse index. See \ref calculateInverseIndex for the layout. Creates the index if needed.
+             *
+             * \return the triangle IDs of all vertices.
+             */
+            const std::vector< size_t >& getInverseIndexTriangles() const;
         protected:
         private:
+            /**
+             * Build the inverse index if it does not exist yet. Concurrent callers wait for the first one to build it.
+             */
+            void ensureInverseIndex() const;
+
+            /**
+             * Build the inverse index. Needs m_inverseIndexMutex to be locked.
+             */
+            void buildInverseIndex() const;
+
             /**
              * Vertex array.
              */
@@ -289,17 +368,43 @@ namespace di
             NormalArray m_normals = {};
 
             /**
-             * Associate a vertex index (outer vector) with a list of triangles that use this index (inner vector).
-             *
-             * \note mutables are bad. Replace by mutex protected const-cast.
+             * Associate a vertex index with a list of triangles that use this index. This is the CSR row offset array. It contains
+             * getNumVertices() + 1 entries if the index was built. Built on demand by const getters, guarded by m_inverseIndexMutex.
              */
-            mutable std::vector< std::vector< size_t > > m_inverseIndex = {};
+            mutable std::vector< size_t > m_inverseIndexOffsets = {};
+
+            /**
+             * The triangle IDs of the inverse index. Indexed by m_inverseIndexOffsets.
+             */
+            mutable std::vector< size_t > m_inverseIndexTriangles = {};
+
+            /**
+             * Guards building the inverse index.
+             */
+            mutable std::mutex m_inverseIndexMutex;
+
+            /**
+             * True once the inverse index was built or set. Allows the getters to skip locking afterwards.
+             */
+            mutable std::atomic< bool > m_hasInverseIndex{ false };
 
             /**
              * The bounding box.
              */
             BoundingBox m_boundingBox;
         };
+
+        /**
+         * Check that the triangles in [first, last) only reference vertices in [0, numVertices). Runs in parallel.
+         *
+         * \param triangles the triangles to check
+         * \param numVertices the number of vertices
+         * \param first the first triangle to check
+         * \param last the triangle after the last one to check. Clamped to the number of triangles.
+         *
+         * \return true if all indices are valid.
+         */
+        bool checkTriangleIndices( const IndexVec3Array& triangles, size_t numVertices, size_t first = 0, size_t last = SIZE_MAX );
     }
 }
 
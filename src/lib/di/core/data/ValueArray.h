@@ -0,0 +1,339 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_VALUEARRAY_H
+#define DI_VALUEARRAY_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <di/core/MappedFile.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * A contiguous array of values. The values are either owned by the array or they are a view into a memory mapped file. The latter allows to
+         * use huge files without copying them into memory first. In both cases, the interface behaves like a fixed-size std::vector.
+         *
+         * \tparam ValueT the value type. Needs to be trivially copyable to be mapped.
+         */
+        template< typename ValueT >
+        class ValueArray
+        {
+        public:
+            /**
+             * The type of a value.
+             */
+            typedef ValueT value_type;
+
+            /**
+             * Iterator type.
+             */
+            typedef ValueT* iterator;
+
+            /**
+             * Const iterator type.
+             */
+            typedef const ValueT* const_iterator;
+
+            /**
+             * Create an array owning its values.
+             *
+             * \param size the number of values
+             * \param value initial value
+             */
+            explicit ValueArray( size_t size = 0, const ValueT& value = ValueT() ):
+                m_values( size, value ),
+                m_data( m_values.data() ),
+                m_size( size )
+            {
+            }
+
+            /**
+             * Create an array owning the given values.
+             *
+             * \param values the values. Moved into the array.
+             */
+            explicit ValueArray( std::vector< ValueT >&& values ):
+                m_values( std::move( values ) ),
+                m_data( m_values.data() ),
+                m_size( m_values.size() )
+            {
+            }
+
+            /**
+             * Create an array as view into a mapped file. The file is kept alive by the array.
+             *
+             * \param file the mapped file
+             * \param offset the offset of the first value in bytes.
+             * \param size the number of values
+             *
+             * \throw std::out_of_range if the file is too small
+             * \throw std::invalid_argument if the offset is not properly aligned for the value type
+             */
+            ValueArray( SPtr< MappedFile > file, size_t offset, size_t size ):
+                m_file( file ),
+                m_offset( offset ),
+                m_size( size )
+            {
+                if( ( offset > file->getSize() ) || ( ( file->getSize() - offset ) / sizeof( ValueT ) < size ) )
+                {
+                    throw std::out_of_range( "File \"" + file->getFilename() + "\" is too small for the requested values." );
+                }
+                if( offset % alignof( ValueT ) != 0 )
+                {
+                    throw std::invalid_argument( "Values in \"" + file->getFilename() + "\" are not aligned." );
+                }
+                m_data = reinterpret_cast< ValueT* >( file->getData() + offset );
+            }
+
+            /**
+             * Copy constructor. The copy always owns its values.
+             *
+             * \param other the array to copy
+             */
+            ValueArray( const ValueArray& other ):
+                m_values( other.begin(), other.end() ),
+                m_data( m_values.data() ),
+                m_size( other.m_size )
+            {
+            }
+
+            /**
+             * Move constructor.
+             *
+             * \param other the array to move from. Empty afterwards.
+             */
+            ValueArray( ValueArray&& other ):
+                m_values( std::move( other.m_values ) ),
+                m_file( std::move( other.m_file ) ),
+                m_offset( other.m_offset ),
+                m_data( other.m_data ),
+                m_size( other.m_size )
+            {
+                other.m_values.clear();
+                other.m_data = nullptr;
+                other.m_size = 0;
+            }
+
+            /**
+             * Destructor.
+             */
+            virtual ~ValueArray()
+            {
+            }
+
+            /**
+             * The number of values.
+             *
+             * \return the size
+             */
+            size_t size() const
+            {
+                return m_size;
+            }
+
+            /**
+             * Check for emptiness.
+             *
+             * \return true if there are no values.
+             */
+            bool empty() const
+            {
+                return m_size == 0;
+            }
+
+            /**
+             * Raw access to the values.
+             *
+             * \return the pointer to the first value
+             */
+            ValueT* data()
+            {
+                return m_data;
+            }
+
+            /**
+             * Raw access to the values.
+             *
+             * \return the pointer to the first value
+             */
+            const ValueT* data() const
+            {
+                return m_data;
+            }
+
+            /**
+             * Access a value. No range check.
+             *
+             * \param index the index
+             *
+             * \return the value
+             */
+            ValueT& operator[]( size_t index )
+            {
+                return m_data[ index ];
+            }
+
+            /**
+             * Access a value. No range check.
+             *
+             * \param index the index
+             *
+             * \return the value
+             */
+            const ValueT& operator[]( size_t index ) const
+            {
+                return m_data[ index ];
+            }
+
+            /**
+             * Access a value with range check.
+             *
+             * \param index the index
+             *
+             * \throw std::out_of_range if the index is invalid.
+             *
+             * \return the value
+             */
+            const ValueT& at( size_t index ) const
+            {
+                if( index >= m_size )
+                {
+                    throw std::out_of_range( "Index out of range." );
+                }
+                return m_data[ index ];
+            }
+
+            /**
+             * Iterator to the first value.
+             *
+             * \return the iterator
+             */
+            iterator begin()
+            {
+                return m_data;
+            }
+
+            /**
+             * Iterator behind the last value.
+             *
+             * \return the iterator
+             */
+            iterator end()
+            {
+                return m_data + m_size;
+            }
+
+            /**
+             * Iterator to the first value.
+             *
+             * \return the iterator
+             */
+            const_iterator begin() const
+            {
+                return m_data;
+            }
+
+            /**
+             * Iterator behind the last value.
+             *
+             * \return the iterator
+             */
+            const_iterator end() const
+            {
+                return m_data + m_size;
+            }
+
+            /**
+             * Check whether the values are a view into a mapped file.
+             *
+             * \return true if mapped.
+             */
+            bool isMapped() const
+            {
+                return m_file != nullptr;
+            }
+
+            /**
+             * Hint that the given range of values is not needed in the near future. For mapped arrays, the memory is given back to the OS and
+             * re-loaded from the file on the next access. For owned values, this is a no-op. See \ref MappedFile::release.
+             *
+             * \param first the first value
+             * \param count the number of values
+             */
+            void release( size_t first, size_t count ) const
+            {
+                if( m_file )
+                {
+                    m_file->release( m_offset + first * sizeof( ValueT ), count * sizeof( ValueT ) );
+                }
+            }
+
+        protected:
+        private:
+            /**
+             * Forbid assignment. Use the copy constructor.
+             *
+             * \return nothing
+             */
+            ValueArray& operator=( const ValueArray& ) = delete;
+
+            /**
+             * The values if owned.
+             */
+            std::vector< ValueT > m_values;
+
+            /**
+             * The mapped file if not owned.
+             */
+            SPtr< MappedFile > m_file;
+
+            /**
+             * The offset of the values in the mapped file in bytes.
+             */
+            size_t m_offset = 0;
+
+            /**
+             * Pointer to the first value. Either in m_values or in m_file.
+             */
+            ValueT* m_data = nullptr;
+
+            /**
+             * Number of values.
+             */
+            size_t m_size = 0;
+        };
+    }
+}
+
+#endif  // DI_VALUEARRAY_H
+
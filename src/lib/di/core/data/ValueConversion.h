@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_VALUECONVERSION_H
+#define DI_VALUECONVERSION_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <di/core/Parallel.h>
+#include <di/core/data/SlabStreaming.h>
+#include <di/core/data/ValueArray.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace core
+    {
+        /**
+         * Convert a single value to another value type. Conversion to integral types rounds to the nearest integer and clamps to the range of the
+         * target type.
+         *
+         * \tparam TargetT the target type
+         * \tparam SourceT the source type
+         * \param value the value to convert
+         *
+         * \return the converted value
+         */
+        template< typename TargetT, typename SourceT >
+        TargetT convertValue( SourceT value )
+        {
+            if( std::is_integral< TargetT >::value )
+            {
+                double converted = static_cast< double >( value );
+                converted = std::is_integral< SourceT >::value ? converted : std::round( converted );
+                converted = std::max( converted, static_cast< double >( std::numeric_limits< TargetT >::lowest() ) );
+                converted = std::min( converted, static_cast< double >( std::numeric_limits< TargetT >::max() ) );
+                return static_cast< TargetT >( converted );
+            }
+            return static_cast< TargetT >( value );
+        }
+
+        /**
+         * Convert an array of values to another value type. The conversion runs in parallel. See \ref convertValue.
+         *
+         * \tparam TargetT the target type
+         * \tparam SourceT the source type
+         * \param values the values to convert
+         *
+         * \return the converted values. Backed by a swap file if they exceed the memory budget, see \ref createVolumeArray.
+         */
+        template< typename TargetT, typename SourceT >
+        SPtr< ValueArray< TargetT > > convertValues( const ValueArray< SourceT >& values )
+        {
+            auto result = createVolumeArray< TargetT >( values.size() );
+            TargetT* target = result->data();
+            const SourceT* source = values.data();
+            parallelFor( 0, values.size(),
+                [ target, source ]( size_t begin, size_t end, size_t )
+                {
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        target[ i ] = convertValue< TargetT >( source[ i ] );
+                    }
+                }
+            );
+            return result;
+        }
+    }
+}
+
+#endif  // DI_VALUECONVERSION_H
+
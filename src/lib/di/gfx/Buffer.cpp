@@ -80,8 +80,16 @@ namespace di
         void Buffer::data( size_t size, const void* ptr )
         {
             // feed the buffer, and let OpenGL know that we don't plan to
-            // change it (STATIC) and that it will be used for drawing (DRAW)
-            glBufferData( toGLType( m_bufferType ), size, ptr, GL_STATIC_DRAW );
+            // change it (STATIC) and that it will be used for drawing (DRAW). Pixel pack buffers are re-filled by OpenGL for each read-back (STREAM)
+            // and mapped by us (READ).
+            GLenum usage = ( m_bufferType == BufferType::PixelPack ) ? GL_STREAM_READ : GL_STATIC_DRAW;
+            glBufferData( toGLType( m_bufferType ), size, ptr, usage );
+            logGLError();
+        }
+
+        void Buffer::unbind( BufferType bufferType )
+        {
+            glBindBuffer( toGLType( bufferType ), 0 );
             logGLError();
         }
 
@@ -93,6 +101,8 @@ namespace di
                     return GL_ARRAY_BUFFER;
                 case BufferType::ElementArray:
                     return GL_ELEMENT_ARRAY_BUFFER;
+                case BufferType::PixelPack:
+                    return GL_PIXEL_PACK_BUFFER;
                 default:
                     return -1;
             }
@@ -44,12 +44,13 @@ namespace di
         public:
             /**
              * Support several buffer types. Find a complete list here:  https://www.opengl.org/sdk/docs/man/html/glBindBuffer.xhtml
-             * For now, only array buffers are implemented.
+             * For now, array and pixel pack buffers are implemented.
              */
             enum class BufferType
             {
-                Array,       // OpenGL: GL_ARRAY_BUFFER
-                ElementArray // OpenGL: GL_ELEMENT_ARRAY_BUFFER
+                Array,        // OpenGL: GL_ARRAY_BUFFER
+                ElementArray, // OpenGL: GL_ELEMENT_ARRAY_BUFFER
+                PixelPack     // OpenGL: GL_PIXEL_PACK_BUFFER. Target of asynchronous read-backs.
             };
 
             /**
@@ -121,12 +122,20 @@ namespace di
             }
 
             /**
-             * Commit data to this buffer.
+             * Commit data to this buffer. Pixel pack buffers are meant to be read back by the application and can be allocated without data.
              *
              * \param size the size of the buffer
-             * \param ptr the data pointer.
+             * \param ptr the data pointer. Can be nullptr to allocate uninitialized memory.
              */
             virtual void data( size_t size, const void* ptr );
+
+            /**
+             * Unbind any buffer of the given type. Needed for pixel pack buffers, as long as they are bound, OpenGL interprets pointers of read
+             * operations as offsets in the buffer.
+             *
+             * \param bufferType the type
+             */
+            static void unbind( BufferType bufferType );
         protected:
             /**
              * Convert the given internal type to a GL enum.
@@ -135,7 +144,7 @@ namespace di
              *
              * \return the GL enum
              */
-            GLenum toGLType( const BufferType& type );
+            static GLenum toGLType( const BufferType& type );
 
         private:
             /**
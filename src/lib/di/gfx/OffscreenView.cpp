@@ -22,8 +22,10 @@
 //
 //---------------------------------------------------------------------------------------
 
+#include <cstring>
 #include <utility>
 
+#include <di/gfx/Buffer.h>
 #include <di/gfx/GL.h>
 #include <di/gfx/GLError.h>
 #include <di/gfx/PixelData.h>
@@ -37,6 +39,16 @@ namespace di
 {
     namespace core
     {
+        /**
+         * Number of pixel buffers used for asynchronous read-backs. Two allow reading the previous image while rendering the next.
+         */
+        const size_t readBufferCount = 2;
+
+        /**
+         * Timeout when waiting for a read-back in nanoseconds. Waiting is repeated on timeout. This only limits each single wait call.
+         */
+        const GLuint64 readTimeout = 1000000000;
+
         OffscreenView::OffscreenView( glm::vec2 size, int samples ):
             View(),
             m_size( size ),
@@ -64,34 +76,51 @@ namespace di
             m_camera = camera;
         }
 
-        SPtr< RGBA8Image > OffscreenView::read() const
+        SPtr< RGBA8Image > OffscreenView::read()
         {
             LogD << "FBO read-back." << LogEnd;
-            auto pixels = std::make_shared< RGBA8Image >( getViewportSize().x, getViewportSize().y );
 
-            bool multisample = m_samples > 1;
-            if( multisample )
+            // Drop everything pending. The caller is only interested in the current image.
+            while( !m_pendingReads.empty() )
             {
-                LogD << "Blending multi-sample FBO." << LogEnd;
+                fetchRead();
+            }
 
-                // Now, blend all samples together
+            readAsync();
+            return fetchRead();
+        }
 
-                // Create target FBO for sampling
-                GLuint resultFBO = 0;
-                glGenFramebuffers( 1, &resultFBO );
+        bool OffscreenView::readAsync()
+        {
+            if( m_pendingReads.size() == readBufferCount )
+            {
+                LogE << "All read buffers in use. Fetch pending reads first." << LogEnd;
+                return false;
+            }
 
-                // Bind target fbo and source fbo
-                glBindFramebuffer( GL_DRAW_FRAMEBUFFER, resultFBO );
-                glBindFramebuffer( GL_READ_FRAMEBUFFER, m_fbo ); // read from the multi-sample buffer
+            size_t imageSize = static_cast< size_t >( getViewportSize().x ) * static_cast< size_t >( getViewportSize().y ) * 4;
+            if( m_readBuffers.empty() )
+            {
+                LogD << "Creating " << readBufferCount << " read buffers." << LogEnd;
+                for( size_t i = 0; i < readBufferCount; ++i )
+                {
+                    auto buffer = std::make_shared< core::Buffer >( core::Buffer::BufferType::PixelPack );
+                    buffer->realize();
+                    buffer->bind();
+                    buffer->data( imageSize, nullptr );
+                    m_readBuffers.push_back( buffer );
+                }
+            }
 
-                // Color output
-                auto resultTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
-                resultTex->realize();
-                resultTex->bind();
-                resultTex->data( getViewportSize().x, getViewportSize().y, 1, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
-                resultTex->setTextureFilter( core::Texture::TextureFilter::Linear, core::Texture::TextureFilter::Linear );
-                logGLError();
-                glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resultTex->getObjectID(), 0 );
+            // The texture to read from
+            auto sourceTex = m_outputTex;
+
+            bool multisample = m_samples > 1;
+            if( multisample )
+            {
+                // Blend all samples together. The resolve FBO was created along with the multi-sample FBO.
+                glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_resolveFBO );
+                glBindFramebuffer( GL_READ_FRAMEBUFFER, m_fbo ); // read from the multi-sample buffer
 
                 // Set this attachment as result
                 GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
@@ -101,20 +130,76 @@ namespace di
                 // Copy operation (blit).
                 glBlitFramebuffer( 0, 0, getViewportSize().x, getViewportSize().y,
                                    0, 0, getViewportSize().x, getViewportSize().y, GL_COLOR_BUFFER_BIT, GL_NEAREST );
+                logGLError();
+                sourceTex = m_resolveTex;
+            }
+
+            // Read into the buffer. With a bound pixel pack buffer, this only queues the transfer and returns immediately.
+            size_t bufferIndex = m_nextReadBuffer;
+            m_nextReadBuffer = ( m_nextReadBuffer + 1 ) % readBufferCount;
+
+            m_readBuffers[ bufferIndex ]->bind();
+            sourceTex->bind();
+            sourceTex->read( nullptr, GL_RGBA, GL_UNSIGNED_BYTE );
+            core::Buffer::unbind( core::Buffer::BufferType::PixelPack );
 
-                // read back
-                resultTex->bind();
-                resultTex->read( *pixels, GL_RGBA, GL_UNSIGNED_BYTE );
+            // Get notified when the transfer is done.
+            GLsync fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+            logGLError();
+            m_pendingReads.push_back( std::make_pair( bufferIndex, fence ) );
+            return true;
+        }
+
+        SPtr< RGBA8Image > OffscreenView::fetchRead()
+        {
+            if( m_pendingReads.empty() )
+            {
+                return nullptr;
+            }
+
+            auto pending = m_pendingReads.front();
+            m_pendingReads.pop_front();
+
+            // Wait for the transfer. Flush on the first attempt to ensure the fence gets issued at all.
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            GLenum status = GL_TIMEOUT_EXPIRED;
+            while( status == GL_TIMEOUT_EXPIRED )
+            {
+                status = glClientWaitSync( pending.second, flags, readTimeout );
+                flags = 0;
+            }
+            glDeleteSync( pending.second );
+            if( status == GL_WAIT_FAILED )
+            {
+                LogE << "Waiting for read-back failed." << LogEnd;
+                logGLError();
+            }
+
+            auto pixels = std::make_shared< RGBA8Image >( getViewportSize().x, getViewportSize().y );
+            size_t imageSize = pixels->getWidth() * pixels->getHeight() * 4;
+
+            m_readBuffers[ pending.first ]->bind();
+            auto mapped = glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, imageSize, GL_MAP_READ_BIT );
+            logGLError();
+            if( mapped )
+            {
+                std::memcpy( pixels->data(), mapped, imageSize );
+                glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
             }
             else
             {
-                m_outputTex->bind();
-                m_outputTex->read( *pixels, GL_RGBA, GL_UNSIGNED_BYTE );
+                LogE << "Cannot map read buffer." << LogEnd;
             }
+            core::Buffer::unbind( core::Buffer::BufferType::PixelPack );
 
             return pixels;
         }
 
+        size_t OffscreenView::getPendingReads() const
+        {
+            return m_pendingReads.size();
+        }
+
         void OffscreenView::bind() const
         {
             // Bind it to be able to modify and configure:
@@ -200,6 +285,27 @@ namespace di
             {
                 LogE << "glCheckFramebufferStatus failed." << LogEnd;
             }
+
+            // Multi-sampled images need to be resolved before reading. Create the target once and re-use it for every read.
+            if( multisample )
+            {
+                glGenFramebuffers( 1, &m_resolveFBO );
+                glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_resolveFBO );
+
+                m_resolveTex = std::make_shared< core::Texture >( core::Texture::TextureType::Tex2D );
+                m_resolveTex->realize();
+                m_resolveTex->bind();
+                m_resolveTex->data( getViewportSize().x, getViewportSize().y, 1, 1, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE );
+                m_resolveTex->setTextureFilter( core::Texture::TextureFilter::Linear, core::Texture::TextureFilter::Linear );
+                logGLError();
+                glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_resolveTex->getObjectID(), 0 );
+                logGLError();
+
+                if( glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+                {
+                    LogE << "glCheckFramebufferStatus failed for the resolve FBO." << LogEnd;
+                }
+            }
         }
 
         void OffscreenView::finalize()
@@ -210,11 +316,30 @@ namespace di
                 glDisable( GL_MULTISAMPLE );
             }
 
+            if( !m_pendingReads.empty() )
+            {
+                LogW << "Dropping " << m_pendingReads.size() << " unfetched read-backs." << LogEnd;
+            }
+            for( auto pending : m_pendingReads )
+            {
+                glDeleteSync( pending.second );
+            }
+            m_pendingReads.clear();
+            m_readBuffers.clear();
+            m_nextReadBuffer = 0;
+
             LogD << "Deleting FBO" << LogEnd;
             glDeleteFramebuffers( 1, &m_fbo );
+            m_fbo = 0;
+            if( m_resolveFBO )
+            {
+                glDeleteFramebuffers( 1, &m_resolveFBO );
+                m_resolveFBO = 0;
+            }
             logGLError();
             m_outputTex = nullptr;
             m_outputDepth = nullptr;
+            m_resolveTex = nullptr;
         }
 
         di::core::State OffscreenView::getState() const
@@ -25,8 +25,11 @@
 #ifndef DI_OFFSCREENVIEW_H
 #define DI_OFFSCREENVIEW_H
 
+#include <deque>
 #include <utility>
+#include <vector>
 
+#include <di/gfx/Buffer.h>
 #include <di/gfx/PixelData.h>
 #include <di/gfx/View.h>
 #include <di/GfxTypes.h>
@@ -36,7 +39,9 @@ namespace di
     namespace core
     {
         /**
-         * Class represents the offscreen rendering view with a fixed size.
+         * Class represents the offscreen rendering view with a fixed size. The view can be rendered and read back multiple times, for example
+         * with different cameras. Read-backs can be done asynchronously using \ref readAsync and \ref fetchRead. The pixels are transferred into
+         * a ring of pixel buffer objects while the next image is rendered.
          */
         class OffscreenView: public View
         {
@@ -99,11 +104,34 @@ namespace di
             void finalize();
 
             /**
-             * Read back the texture. Width and height are the viewport size.
+             * Read back the texture. Width and height are the viewport size. This blocks until the image is available. Pending asynchronous
+             * read-backs are dropped.
              *
              * \return the image
              */
-            SPtr< RGBA8Image > read() const;
+            SPtr< RGBA8Image > read();
+
+            /**
+             * Start reading back the current contents. The function does not wait for the rendering to finish. Fetch the result using
+             * \ref fetchRead. Multi-sampled contents are resolved first.
+             *
+             * \return false if all read buffers are in use. Fetch a pending read first.
+             */
+            bool readAsync();
+
+            /**
+             * Fetch the oldest pending read-back started by \ref readAsync. Blocks until the transfer is finished.
+             *
+             * \return the image. Width and height are the viewport size. nullptr if no read is pending.
+             */
+            SPtr< RGBA8Image > fetchRead();
+
+            /**
+             * The number of read-backs started by \ref readAsync but not yet fetched.
+             *
+             * \return the number of pending reads
+             */
+            size_t getPendingReads() const;
 
             /**
              * Get the state object representing this object at the moment of the call.
@@ -152,6 +180,31 @@ namespace di
              * Depth texture output
              */
             SPtr< di::core::Texture > m_outputDepth = nullptr;
+
+            /**
+             * The FBO to resolve multi-sampled images into. Only used with multi-sampling.
+             */
+            GLuint m_resolveFBO = 0;
+
+            /**
+             * Target texture of the resolve step.
+             */
+            SPtr< di::core::Texture > m_resolveTex = nullptr;
+
+            /**
+             * The ring of pixel buffers to read into. Created on first use.
+             */
+            std::vector< SPtr< di::core::Buffer > > m_readBuffers;
+
+            /**
+             * The index of the next buffer in m_readBuffers to use.
+             */
+            size_t m_nextReadBuffer = 0;
+
+            /**
+             * Pending reads. The buffer index and the fence that signals the end of the transfer. Oldest first.
+             */
+            std::deque< std::pair< size_t, GLsync > > m_pendingReads;
         };
     }
 }
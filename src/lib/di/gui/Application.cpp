@@ -24,6 +24,7 @@
 
 #include <clocale>
 
+#include <exception>
 #include <string>
 
 #include <QApplication>
@@ -39,11 +40,15 @@
 #include <di/core/Connection.h>
 #include <di/core/Filesystem.h>
 #include <di/core/ObserverCallback.h>
+#include <di/core/Trace.h>
 
 #include <di/gui/events/CallbackEvent.h>
 
 #include "Application.h"
 
+#include <di/core/Logger.h>
+#define LogTag "gui/Application"
+
 namespace di
 {
     namespace gui
@@ -80,12 +85,26 @@ namespace di
 
         int Application::run()
         {
-            // Handle Parameters first
+            // Handle Parameters first. Tracing is handled here for all applications.
             std::vector< std::string > arguments;
             for( int i = 1; i < m_argc; ++i )
             {
-                arguments.push_back( std::string( m_argv[ i ] ) );
+                std::string argument( m_argv[ i ] );
+                if( argument.find( "--trace=" ) == 0 )
+                {
+                    m_traceFile = argument.substr( std::string( "--trace=" ).length() );
+                    continue;
+                }
+                arguments.push_back( argument );
+            }
+
+            if( !m_traceFile.empty() )
+            {
+                LogI << "Commandline: tracing activated. Writing trace to \"" << m_traceFile << "\" on exit." << LogEnd;
+                core::Trace::setEnabled( true );
+                core::Trace::setThreadName( "UI" );
             }
+
             auto result = handleCommandLine( arguments, m_argc, m_argv );
             if( !result )
             {
@@ -152,6 +171,19 @@ namespace di
             // Stop if not yet done already.
             m_processingNetwork->stop();
 
+            // All threads are done. The trace is complete.
+            if( !m_traceFile.empty() )
+            {
+                try
+                {
+                    core::Trace::write( m_traceFile );
+                }
+                catch( const std::exception& e )
+                {
+                    LogE << "Cannot write trace to \"" << m_traceFile << "\": " << e.what() << LogEnd;
+                }
+            }
+
             // Clean up and return.
             return retVal;
         }
@@ -190,6 +222,10 @@ namespace di
         {
         }
 
+        void Application::exportResults( const QString& /* filename */ )
+        {
+        }
+
         void Application::setUIEnabled( bool enable )
         {
             auto mw = getMainWindow();
@@ -148,6 +148,14 @@ namespace di
             virtual void saveProject( const QString& filename,
                                       bool all = true, bool viewOnly = false, bool paramsOnly = false, bool dataOnly = false );
 
+            /**
+             * Called when the user wants to export the results to a file. Does nothing by default. Implement this if your application has results
+             * worth exporting.
+             *
+             * \param filename the file to write
+             */
+            virtual void exportResults( const QString& filename );
+
             /**
              * Implement your specific UI code here. The network was not yet started. So only do GUI stuff here.
              */
@@ -183,7 +191,8 @@ namespace di
              * It is your choice to either use the argument vector or argc,argv. If you do not override this method, it will allow all parameters but
              * prints a warning that they are ignored.
              *
-             * \param arguments each space separated argument. It does NOT contain the program name (as argv[0] does).
+             * \param arguments each space separated argument. It does NOT contain the program name (as argv[0] does). It does not contain the
+             * "--trace=<file>" switch either. This is handled by the Application itself and writes a trace of the session to the given file.
              * \param argc the argument count in the char* array argv
              * \param argv the argument char* array
              *
@@ -226,6 +235,11 @@ namespace di
              * The processing container managed by this application instance.
              */
             SPtr< core::ProcessingNetwork > m_processingNetwork = nullptr;
+
+            /**
+             * Write a trace to this file on exit. Empty if tracing is disabled.
+             */
+            std::string m_traceFile;
         };
     }
 }
@@ -91,6 +91,9 @@ namespace di
             auto saveParamAction = projectMenu->addAction( "Save Parameters Only" );
             auto saveDataAction = projectMenu->addAction( "Save Data Only" );
 
+            projectMenu->addSeparator();
+            auto exportAction = projectMenu->addAction( "Export Results" );
+
             projectMenu->addSeparator();
             auto exitAction = projectMenu->addAction( "Quit" );
 
@@ -105,6 +108,8 @@ namespace di
             connect( saveDataAction, SIGNAL( triggered( bool ) ), this, SLOT( saveDataHandler() ) );
             connect( saveParamAction, SIGNAL( triggered( bool ) ), this, SLOT( saveParamHandler() ) );
 
+            connect( exportAction, SIGNAL( triggered( bool ) ), this, SLOT( exportResultsHandler() ) );
+
             connect( exitAction, SIGNAL( triggered( bool ) ), this, SLOT( close() ) );
         }
 
@@ -199,6 +204,37 @@ namespace di
             saveProjectHandler( false, true, false, false );
         }
 
+        void MainWindow::exportResultsHandler()
+        {
+            QString lastPath =
+                Application::getSettings()->value( "LastExportFilePath", Application::getSettings()->value( "LastFilePath", "" ) ).toString();
+            QString selected = QFileDialog::getSaveFileName( this, "Export Results", lastPath, QString( "Stanford Poly Format (*.ply)" ) );
+            if( selected == "" )
+            {
+                return;
+            }
+
+            QFileInfo fi( selected );
+            if( fi.suffix() != "ply" )
+            {
+                selected += ".ply";
+            }
+
+            Application::getSettings()->setValue( "LastExportFilePath", selected );
+
+            // Exporting runs in the processing network. Failures are reported there.
+            try
+            {
+                LogI << "Exporting results to " << selected.toStdString() << LogEnd;
+                Application::getInstance()->exportResults( selected );
+            }
+            catch( std::exception& e )
+            {
+                QMessageBox::critical( this, "Export failed.",
+                                       "Exporting the results has failed. Reason: \"" + QString::fromStdString( std::string( e.what() ) ) + "\"." );
+            }
+        }
+
         bool MainWindow::event( QEvent* event )
         {
             if( event->type() == QT_CALLBACK_EVENT )
@@ -126,6 +126,11 @@ namespace di
              * Save only camera information. Forwards call to \ref saveProjectHandler.
              */
             void saveCamHandler();
+
+            /**
+             * Handle the export menu. Asks for a filename and forwards it to \ref Application::exportResults.
+             */
+            void exportResultsHandler();
         private:
         };
     }
@@ -26,12 +26,16 @@
 #include <string>
 #include <cmath>
 #include <chrono>
+#include <deque>
+#include <utility>
 
 #include <QMouseEvent>
 
+#include <di/core/Algorithm.h>
 #include <di/core/Filesystem.h>
 #include <di/core/BoundingBox.h>
 #include <di/core/State.h>
+#include <di/core/Trace.h>
 #include <di/gfx/GL.h>
 #include <di/gfx/OffscreenView.h>
 #include <di/MathTypes.h>
@@ -189,6 +193,7 @@ namespace di
                 {
                     if( vis->isRenderingActive() )
                     {
+                        core::TraceSpan span( "gfx", "Update", getTraceName( vis ) );
                         view->bind();
                         vis->update( *view, m_forceReload );
                     }
@@ -257,6 +262,7 @@ namespace di
                 {
                     if( vis->isRenderingActive() )
                     {
+                        core::TraceSpan span( "gfx", "Render", getTraceName( vis ) );
                         view->bind();
                         vis->render( *view );
                     }
@@ -264,8 +270,21 @@ namespace di
             );
         }
 
+        std::string OGLWidget::getTraceName( SPtr< core::Visualization > vis )
+        {
+            if( !core::Trace::isEnabled() )
+            {
+                return "";
+            }
+
+            auto algorithm = std::dynamic_pointer_cast< core::Algorithm >( vis );
+            return algorithm ? algorithm->getRuntimeName() : "";
+        }
+
         void OGLWidget::paintGL()
         {
+            core::TraceSpan span( "gfx", "Frame" );
+
             auto now = std::chrono::system_clock::now();
             auto duration = std::chrono::duration_cast< std::chrono::milliseconds >( now - m_fpsLastTime );
             auto durationLastShow = std::chrono::duration_cast< std::chrono::milliseconds >( now - m_fpsLastShowTime );
@@ -307,10 +326,10 @@ namespace di
             // Define render target
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-            // A list of views to render to. Used for screenshots.
-            std::vector< SPtr< core::OffscreenView > > targetViews;
-            // Also keep a list of name hints for each view. Used for saving them to files.
-            std::map< SPtr< core::OffscreenView >, std::string > targetViewNameHints;
+            // The view to render screenshots to. All screenshots share the size and sampling. Only the camera differs.
+            SPtr< core::OffscreenView > screenshotView;
+            // The cameras to render with. Also keep a name hint for each camera. Used for saving them to files.
+            std::vector< std::pair< core::Camera, std::string > > screenshotCameras;
 
             // Screenshot?
             if( m_screenShotRequest && !m_screenShotWidget  )
@@ -333,16 +352,19 @@ namespace di
                 // Also add the user cam. NOTE: the bool is false, as the cam contains a whole view matrix already.
                 matrices.push_back( std::make_tuple( m_camera.getViewMatrix(), false, "User Camera" ) );
 
-                // Create views for each listed matrix
-                for( auto matrix : matrices )
-                {
-                    // Create the off-screen view
-                    auto screenshotView = std::make_shared< core::OffscreenView >(
-                        glm::vec2( m_screenShotWidget->getWidth(), m_screenShotWidget->getHeight() ), m_screenShotWidget->getSamples() );
+                // Create the off-screen view. It is re-used for all cameras.
+                screenshotView = std::make_shared< core::OffscreenView >(
+                    glm::vec2( m_screenShotWidget->getWidth(), m_screenShotWidget->getHeight() ), m_screenShotWidget->getSamples() );
 
-                    // Force high quality
-                    screenshotView->setHQMode( true );
+                // Force high quality
+                screenshotView->setHQMode( true );
 
+                // Init the FBO
+                screenshotView->prepare();
+
+                // Create a camera for each listed matrix
+                for( auto matrix : matrices )
+                {
                     // The screenshot view might have a different aspect:
                     core::Camera offCam( m_camera );
                     offCam.setProjectionMatrix( buildProjectionMatrix( near, far, screenshotView->getAspectRatio() ) );
@@ -355,14 +377,9 @@ namespace di
                         viewMatrix = buildViewMatrix( sceneBB, viewMatrix, 2.0, glm::vec2( 0.0 ) );
                     }
                     offCam.setViewMatrix( viewMatrix );
-                    screenshotView->setCamera( offCam );
-
-                    // Init the FBO
-                    screenshotView->prepare();
 
                     // Done. Add to list
-                    targetViews.push_back( screenshotView );
-                    targetViewNameHints[ screenshotView ] = std::get< 2 >( matrix );
+                    screenshotCameras.push_back( std::make_pair( offCam, std::get< 2 >( matrix ) ) );
                 }
 
 
@@ -422,23 +439,38 @@ namespace di
             // Render to render target(s)
             /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-            if( !targetViews.empty() )
+            if( screenshotView )
             {
-                for( auto view : targetViews )
+                // The name hints of the images currently being read back. Oldest first.
+                std::deque< std::string > pendingNameHints;
+                for( const auto& camera : screenshotCameras )
                 {
-                    renderToView( view.get() );
+                    core::TraceSpan span( "gfx", "Screenshot", camera.second );
+                    screenshotView->setCamera( camera.first );
+                    renderToView( screenshotView.get() );
 
-                    // if this is part of a screenshot -> submit
-                    if( m_screenShotRequest )
+                    // Start the read-back. It runs while the next camera is rendered.
+                    screenshotView->readAsync();
+                    pendingNameHints.push_back( camera.second );
+
+                    // Get the previous image and report back. Keeps the current one in flight.
+                    while( screenshotView->getPendingReads() > 1 )
                     {
-                        // get image and report back
-                        emit screenshotDone( view->read(), targetViewNameHints[ view ], m_screenShotPathOverride );
+                        emit screenshotDone( screenshotView->fetchRead(), pendingNameHints.front(), m_screenShotPathOverride );
+                        pendingNameHints.pop_front();
                     }
+                }
 
-                    // cleanup the FBO
-                    view->finalize();
+                // Get the remaining images
+                while( screenshotView->getPendingReads() > 0 )
+                {
+                    emit screenshotDone( screenshotView->fetchRead(), pendingNameHints.front(), m_screenShotPathOverride );
+                    pendingNameHints.pop_front();
                 }
 
+                // cleanup the FBO
+                screenshotView->finalize();
+
                 // thats it.
                 emit allScreenshotsDone();
                 m_screenShotRequest = false;
@@ -26,6 +26,7 @@
 #define DI_OGLWIDGET_H
 
 #include <chrono>
+#include <string>
 #include <tuple>
 
 #include <di/gfx/GL.h>
@@ -38,6 +39,7 @@
 
 #include <di/core/State.h>
 #include <di/core/BoundingBox.h>
+#include <di/core/Visualization.h>
 #include <di/gfx/PixelData.h>
 #include <di/GfxTypes.h>
 
@@ -470,6 +472,15 @@ namespace di
              * \param view the view.
              */
             void renderToView( core::View* view );
+
+            /**
+             * Get the name of the visualization to show in the trace. Only looked up if tracing is enabled.
+             *
+             * \param vis the visualization
+             *
+             * \return the runtime name of the algorithm behind the visualization. Empty if tracing is disabled.
+             */
+            static std::string getTraceName( SPtr< core::Visualization > vis );
         };
     }
 }
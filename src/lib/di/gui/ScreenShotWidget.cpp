@@ -25,7 +25,10 @@
 #include <algorithm>
 #include <string>
 #include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <exception>
+#include <fstream>
 #include <sstream>
 #include <iomanip>
 
@@ -37,11 +40,13 @@
 #include <QComboBox>
 #include <QCheckBox>
 
+#include <di/core/Trace.h>
+
 #include <di/gui/Application.h>
 #include <di/gui/ScaleLabel.h>
 #include <di/gui/ColorPicker.h>
 
-#include <di/ext/bitmap_image.hpp>
+#include <di/io/ImageWriter.h>
 
 #include "icons/folder.xpm"
 #include "ScreenShotWidget.h"
@@ -54,7 +59,8 @@ namespace di
     namespace gui
     {
         ScreenShotWidget::ScreenShotWidget( QWidget* parent ):
-            QWidget( parent )
+            QWidget( parent ),
+            m_encoder( 1, "Screenshot Encoder" )
         {
             // Common 4:3 resolutions
             m_resolutions.push_back( std::make_tuple( "4:3, XGA",     1024, 768 ) );
@@ -173,6 +179,14 @@ namespace di
 
             // As we want to store values, register for shutdown. The Mainwindow notifies everyone.
             connect( Application::getInstance()->getMainWindow(), SIGNAL( shutdown() ), this, SLOT( shutdown() ) );
+
+            m_encoder.start();
+        }
+
+        ScreenShotWidget::~ScreenShotWidget()
+        {
+            // Finish pending screenshots before the widget is gone. The tasks use this instance.
+            m_encoder.stop();
         }
 
         void ScreenShotWidget::queryImagePath()
@@ -248,60 +262,58 @@ namespace di
                << localTime->tm_year + 1900 << "-" << localTime->tm_mon + 1 << "-" << localTime->tm_mday << "_"
                << localTime->tm_hour << "-" << localTime->tm_min << "-" << localTime->tm_sec << "_" << nameHint << "_";
 
-            // find next available filename
-            uint16_t nb = 1;
-            while( true )
-            {
-                if( exists( fn.str() + std::to_string( nb ) + ".bmp" ) )
-                {
-                    nb++;
-                }
-                else
-                {
-                    break;
-                }
-            }
-            fn << nb << ".bmp";
-
-            LogD << "Saving screenshot to file \"" << fn.str() << "\"" << LogEnd;
-            // and store as image
-            bitmap_image image( pixels->getWidth(), pixels->getHeight() );
-
-            // set background to red. If we see a red pixel -> something was wrong
-            image.set_all_channels( 0, 0, 0 );
+            std::string extension = io::isPNGSupported() ? ".png" : ".bmp";
 
-            // Now write each pixel
-            for( size_t y = 0; y < pixels->getHeight(); ++y )
+            // Find next available filename and reserve it by creating the file. Images still being encoded exist already this way. This also
+            // ensures we can write the file at all and allows to report this right now.
+            uint16_t nb = 1;
+            while( exists( fn.str() + std::to_string( nb ) + extension ) )
             {
-                for( size_t x = 0; x < pixels->getWidth(); ++x )
-                {
-                    auto color = ( *pixels )( x, y );
-
-                    // Bitmap has its (0,0) in the upper left corner. Fix this:
-                    image.set_pixel( x, pixels->getHeight() - y - 1, color.x, color.y, color.z );
-                }
+                nb++;
             }
+            std::string filename = fn.str() + std::to_string( nb ) + extension;
 
-            // finally, save the file
-            // We ensure we can open the target file before we use save_image as this only returns without any info on success:
-            std::ofstream file( fn.str().c_str(), std::ios::binary );
+            std::ofstream file( filename.c_str(), std::ios::binary );
             auto status = file.good();
             file.close();
-            if( status )
+            if( !status )
             {
-                try
-                {
-                    image.save_image( fn.str() );
-                }
-                catch( ... )
+                LogE << "Cannot open file \"" + filename + "\" for writing." << LogEnd;
+                return false;
+            }
+
+            // Encode in the background. The pixels are kept alive by the task.
+            LogD << "Saving screenshot to file \"" << filename << "\"" << LogEnd;
+            auto queued = m_encoder.submit(
+                [ this, pixels, filename ]()
                 {
-                    LogE << "Cannot write file \"" + fn.str() + "\"." << LogEnd;
-                    return false;
+                    try
+                    {
+                        core::TraceSpan span( "io", "Encode screenshot", filename );
+
+                        // OpenGL has its (0,0) in the lower left corner. Image files start at the upper left corner. Flip.
+                        auto data = static_cast< const uint8_t* >( pixels->data() );
+                        if( io::isPNGSupported() )
+                        {
+                            io::writePNG( filename, data, pixels->getWidth(), pixels->getHeight(), true );
+                        }
+                        else
+                        {
+                            io::writeBMP( filename, data, pixels->getWidth(), pixels->getHeight(), true );
+                        }
+                        LogD << "Screenshot \"" << filename << "\" written." << LogEnd;
+                    }
+                    catch( const std::exception& e )
+                    {
+                        LogE << "Cannot write file \"" + filename + "\": " << e.what() << LogEnd;
+                        emit screenshotFailed( QString::fromStdString( filename ) );
+                    }
                 }
-            }
-            else
+            );
+
+            if( !queued )
             {
-                LogE << "Cannot open file \"" + fn.str() + "\" for writing." << LogEnd;
+                LogE << "Cannot write file \"" + filename + "\". Application is shutting down." << LogEnd;
                 return false;
             }
 
@@ -317,6 +329,9 @@ namespace di
             Application::getSettings()->setValue( "ScreenShotWidget_OverrideBG", m_bgColorOverride->isChecked() );
             Application::getSettings()->setValue( "ScreenShotWidget_BGColor", m_bgColor->getColor() );
             Application::getSettings()->setValue( "ScreenShotWidget_DefaultViews", m_allDefaultViews->isChecked() );
+
+            // Write pending screenshots before the application quits.
+            m_encoder.stop();
         }
     }
 }
@@ -35,6 +35,7 @@
 #include <QCheckBox>
 #include <QVBoxLayout>
 
+#include <di/core/WorkerPool.h>
 #include <di/gfx/PixelData.h>
 #include <di/GfxTypes.h>
 #include <di/Types.h>
@@ -61,9 +62,9 @@ namespace di
             explicit ScreenShotWidget( QWidget* parent = nullptr );
 
             /**
-             * Destroy and clean up.
+             * Destroy and clean up. Waits for pending screenshots to be written.
              */
-            virtual ~ScreenShotWidget() = default;
+            virtual ~ScreenShotWidget();
 
             /**
              * Get width of the screenshot
@@ -101,13 +102,14 @@ namespace di
             void setMaxResolution( int res );
 
             /**
-             * Save the pixel data as screenshot.
+             * Save the pixel data as screenshot. The file name is reserved immediately. Encoding and writing is done in the background. If this
+             * fails, \ref screenshotFailed is emitted. The image is saved as PNG if supported by the build, otherwise as BMP.
              *
              * \param pixels the image
              * \param nameHint hint how to name the file.
              * \param pathOverride the path where to store the image. Can be empty to use the user specified path.
              *
-             * \return false on error
+             * \return false if the file cannot be created.
              */
             bool saveScreenShot( SPtr< core::RGBA8Image > pixels, const std::string& nameHint, const std::string& pathOverride = "" );
 
@@ -131,6 +133,14 @@ namespace di
              * \return true if enabled.
              */
             bool getCaptureAll() const;
+        signals:
+            /**
+             * Emitted if writing a screenshot failed in the background. Emitted from the encoding thread.
+             *
+             * \param filename the file that could not be written
+             */
+            void screenshotFailed( const QString& filename );
+
         protected slots:
             /**
              * Handle shutdown. Emited by the main windows
@@ -196,6 +206,11 @@ namespace di
              * Checkbox to force screenshots of all default views.
              */
             QCheckBox* m_allDefaultViews = nullptr;
+
+            /**
+             * Encodes and writes the images. A single thread keeps the order of the files. The encoder itself runs in parallel.
+             */
+            core::WorkerPool m_encoder;
         };
     }
 }
@@ -138,6 +138,7 @@ namespace di
             connect( m_oglWidget, SIGNAL( screenshotDone( SPtr< core::RGBA8Image >, const std::string&, const std::string& ) ),
                      this, SLOT( screenshotDone( SPtr< core::RGBA8Image >, const std::string&, const std::string& ) ) );
             connect( m_oglWidget, SIGNAL( allScreenshotsDone() ), this, SLOT( allScreenshotsDone() ) );
+            connect( m_screenShotWidget, SIGNAL( screenshotFailed( const QString& ) ), this, SLOT( screenshotFailed( const QString& ) ) );
         }
 
         ViewWidget::~ViewWidget()
@@ -301,6 +302,11 @@ namespace di
             }
         }
 
+        void ViewWidget::screenshotFailed( const QString& filename )
+        {
+            QMessageBox::critical( this, "Screenshot failed.", "Unable to write the screenshot \"" + filename + "\" to disk." );
+        }
+
         void ViewWidget::allScreenshotsDone()
         {
             // Just re-emit a signal.
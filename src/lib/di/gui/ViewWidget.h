@@ -129,6 +129,13 @@ namespace di
              */
             void allScreenshotsDone();
 
+            /**
+             * Writing a screenshot failed in the background.
+             *
+             * \param filename the file that could not be written
+             */
+            void screenshotFailed( const QString& filename );
+
             /**
              * A default view was triggered.
              */
@@ -0,0 +1,165 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <ios>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <di/core/CompressedFile.h>
+#include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
+#include <di/core/Parallel.h>
+#include <di/core/StringUtils.h>
+
+#include "FreeSurferFormat.h"
+#include "RegionLabelReader.h"
+#include "FreeSurferAnnotationReader.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/FreeSurferAnnotationReader"
+
+namespace di
+{
+    namespace io
+    {
+        FreeSurferAnnotationReader::FreeSurferAnnotationReader():
+            Reader()
+        {
+        }
+
+        FreeSurferAnnotationReader::~FreeSurferAnnotationReader()
+        {
+        }
+
+        bool FreeSurferAnnotationReader::canLoad( const std::string& filename ) const
+        {
+            std::string ext = di::core::getFileExtension( di::core::getUncompressedFilename( filename ) );
+            return ( di::core::toLower( ext ) == "annot" );
+        }
+
+        /**
+         * Read a color table entry and map its packed color to the structure index.
+         *
+         * \param stream the stream positioned at the name length of the entry
+         * \param index the structure index
+         * \param structures the map to fill
+         */
+        void readAnnotationColor( FreeSurferStream& stream, int32_t index, std::unordered_map< int32_t, int32_t >& structures )
+        {
+            stream.readString( stream.readInt32() );
+            int32_t rgbt[ 4 ];
+            stream.readArray( rgbt, 4, sizeof( int32_t ) );
+
+            // The annotation value of each vertex is the packed color of its structure.
+            int32_t packed = rgbt[ 0 ] + ( rgbt[ 1 ] << 8 ) + ( rgbt[ 2 ] << 16 );
+            structures.emplace( packed, index );
+        }
+
+        SPtr< di::core::DataSetBase > FreeSurferAnnotationReader::load( const std::string& filename ) const
+        {
+            LogD << "Loading \"" << filename << "\"." << LogEnd;
+
+            auto file = di::core::openFile( filename );
+            FreeSurferStream stream( *file );
+
+            int32_t numVertices = stream.readInt32();
+            if( numVertices <= 0 )
+            {
+                throw std::ios_base::failure( "FreeSurfer annotation \"" + filename + "\" is empty or invalid." );
+            }
+
+            // Pairs of vertex index and annotation value.
+            stream.requireArray( 2 * static_cast< size_t >( numVertices ), sizeof( int32_t ) );
+            std::vector< int32_t > annotation( 2 * static_cast< size_t >( numVertices ) );
+            stream.readArray( annotation.data(), annotation.size(), sizeof( int32_t ) );
+
+            // The color table maps annotation values to structures. Without it, there is nothing to map.
+            std::unordered_map< int32_t, int32_t > structures;
+            if( !stream.atEnd() && ( stream.readInt32() == 1 ) )
+            {
+                int32_t numEntries = stream.readInt32();
+                if( numEntries > 0 )
+                {
+                    // Old format: entries are numbered implicitly.
+                    stream.readString( stream.readInt32() );
+                    for( int32_t i = 0; i < numEntries; ++i )
+                    {
+                        readAnnotationColor( stream, i, structures );
+                    }
+                }
+                else
+                {
+                    if( -numEntries != 2 )
+                    {
+                        throw std::ios_base::failure( "FreeSurfer annotation \"" + filename + "\" uses an unsupported color table version." );
+                    }
+                    stream.readInt32(); // the maximum number of structures
+                    stream.readString( stream.readInt32() );
+                    int32_t numStored = stream.readInt32();
+                    for( int32_t i = 0; i < numStored; ++i )
+                    {
+                        int32_t index = stream.readInt32();
+                        readAnnotationColor( stream, index, structures );
+                    }
+                }
+            }
+            else
+            {
+                LogW << "FreeSurfer annotation \"" << filename << "\" has no color table. All labels are -1." << LogEnd;
+            }
+
+            // Vertices without annotation keep -1.
+            auto labels = std::make_shared< RegionLabelReader::AttributeType >( numVertices, -1 );
+            std::atomic< bool > validIndices( true );
+            di::core::parallelFor( 0, numVertices,
+                [ & ]( size_t begin, size_t end, size_t )
+                {
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        int32_t vertex = annotation[ 2 * i ];
+                        if( ( vertex < 0 ) || ( vertex >= numVertices ) )
+                        {
+                            validIndices = false;
+                            return;
+                        }
+                        auto structure = structures.find( annotation[ 2 * i + 1 ] );
+                        if( structure != structures.end() )
+                        {
+                            ( *labels )[ vertex ] = structure->second;
+                        }
+                    }
+                }
+            );
+            if( !validIndices )
+            {
+                throw std::ios_base::failure( "FreeSurfer annotation \"" + filename + "\" contains invalid vertex indices." );
+            }
+
+            LogD << "Loaded " << numVertices << " labels of " << structures.size() << " structures." << LogEnd;
+            return std::make_shared< RegionLabelReader::DataSetType >( "Mesh Labels", labels );
+        }
+    }
+}
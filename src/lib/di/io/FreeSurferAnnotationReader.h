@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_FREESURFERANNOTATIONREADER_H
+#define DI_FREESURFERANNOTATIONREADER_H
+
+#include <string>
+
+#include <di/core/Reader.h>
+#include <di/core/data/DataSetBase.h>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Implements a loader for FreeSurfer annotations (".annot"). Each vertex gets the index of its structure in the color table as label,
+         * -1 if it has no structure. The result has the same type as the result of \ref RegionLabelReader. It implements the \ref Reader
+         * interface.
+         */
+        class FreeSurferAnnotationReader: public di::core::Reader
+        {
+        public:
+            /**
+             * Constructor;
+             */
+            FreeSurferAnnotationReader();
+
+            /**
+             * Destructor.
+             */
+            virtual ~FreeSurferAnnotationReader();
+
+            /**
+             * Check whether the specified file can be loaded.
+             *
+             * \param filename the file to load
+             *
+             * \return true if this implementation is able to load the data.
+             */
+            virtual bool canLoad( const std::string& filename ) const;
+
+            /**
+             * Load the specified file. This throws an exception if something went wrong.
+             *
+             * \param filename the file to load
+             *
+             * \return the data
+             */
+            virtual SPtr< di::core::DataSetBase > load( const std::string& filename ) const;
+        protected:
+        private:
+        };
+    }
+}
+
+#endif  // DI_FREESURFERANNOTATIONREADER_H
+
@@ -0,0 +1,224 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_FREESURFERFORMAT_H
+#define DI_FREESURFERFORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <string>
+
+#include <di/core/Endianness.h>
+#include <di/core/MappedFile.h>
+#include <di/core/Parallel.h>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * The 3-byte magic number of FreeSurfer triangle surface files.
+         */
+        const uint32_t freeSurferTriangleMagic = 0xFFFFFE;
+
+        /**
+         * The 3-byte magic number of FreeSurfer quad surface files.
+         */
+        const uint32_t freeSurferQuadMagic = 0xFFFFFF;
+
+        /**
+         * The 3-byte magic number of newer FreeSurfer quad surface files.
+         */
+        const uint32_t freeSurferNewQuadMagic = 0xFFFFFD;
+
+        /**
+         * Sequential, range-checked access to the big endian values in a memory-mapped FreeSurfer file.
+         */
+        class FreeSurferStream
+        {
+        public:
+            /**
+             * Start reading at the beginning of the file.
+             *
+             * \param file the file. Needs to outlive the stream.
+             */
+            explicit FreeSurferStream( const di::core::MappedFile& file ):
+                m_file( file )
+            {
+            }
+
+            /**
+             * Read a 32 bit integer.
+             *
+             * \throw std::ios_base::failure if the file is too short
+             *
+             * \return the value
+             */
+            int32_t readInt32()
+            {
+                int32_t value;
+                readArray( &value, 1, sizeof( value ) );
+                return value;
+            }
+
+            /**
+             * Read a 24 bit unsigned integer. Used for the magic numbers.
+             *
+             * \throw std::ios_base::failure if the file is too short
+             *
+             * \return the value
+             */
+            uint32_t readUInt24()
+            {
+                require( 3 );
+                const uint8_t* bytes = reinterpret_cast< const uint8_t* >( m_file.getData() + m_position );
+                m_position += 3;
+                return ( static_cast< uint32_t >( bytes[ 0 ] ) << 16 ) | ( static_cast< uint32_t >( bytes[ 1 ] ) << 8 ) | bytes[ 2 ];
+            }
+
+            /**
+             * Read a string of the given length. Trailing zero bytes are removed.
+             *
+             * \param length the number of bytes
+             *
+             * \throw std::ios_base::failure if the file is too short
+             *
+             * \return the string
+             */
+            std::string readString( size_t length )
+            {
+                require( length );
+                std::string result( m_file.getData() + m_position, length );
+                m_position += length;
+                return result.substr( 0, result.find( '\0' ) );
+            }
+
+            /**
+             * Skip everything up to and including the next line break.
+             *
+             * \throw std::ios_base::failure if there is no line break
+             */
+            void skipLine()
+            {
+                require( 1 );
+                const char* begin = m_file.getData() + m_position;
+                const char* lineEnd = static_cast< const char* >( std::memchr( begin, '\n', m_file.getSize() - m_position ) );
+                if( !lineEnd )
+                {
+                    throw std::ios_base::failure( "FreeSurfer file \"" + m_file.getFilename() + "\" is truncated." );
+                }
+                m_position += ( lineEnd - begin ) + 1;
+            }
+
+            /**
+             * Read an array of big endian values in one go. Byte order is fixed in parallel if needed.
+             *
+             * \param values the target. Needs to provide count * elementSize bytes.
+             * \param count the number of values
+             * \param elementSize the size of each value in bytes
+             *
+             * \throw std::ios_base::failure if the file is too short
+             */
+            void readArray( void* values, size_t count, size_t elementSize )
+            {
+                requireArray( count, elementSize );
+                size_t size = count * elementSize;
+                if( size == 0 )
+                {
+                    return;
+                }
+                std::memcpy( values, m_file.getData() + m_position, size );
+                m_position += size;
+
+                if( di::core::isLittleEndian() && ( elementSize > 1 ) )
+                {
+                    uint8_t* bytes = static_cast< uint8_t* >( values );
+                    di::core::parallelFor( 0, count,
+                        [ & ]( size_t begin, size_t end, size_t )
+                        {
+                            di::core::swapBytes( bytes + begin * elementSize, end - begin, elementSize );
+                        }
+                    );
+                }
+            }
+
+            /**
+             * Ensure that an array is left in the file. Use this before allocating memory for counts read from the file. Overflow-safe.
+             *
+             * \param count the number of values
+             * \param elementSize the size of each value in bytes
+             *
+             * \throw std::ios_base::failure if the file is too short
+             */
+            void requireArray( size_t count, size_t elementSize ) const
+            {
+                if( ( elementSize != 0 ) && ( count > ( m_file.getSize() - m_position ) / elementSize ) )
+                {
+                    throw std::ios_base::failure( "FreeSurfer file \"" + m_file.getFilename() + "\" is truncated." );
+                }
+            }
+
+            /**
+             * Check whether everything was read.
+             *
+             * \return true if at the end of the file.
+             */
+            bool atEnd() const
+            {
+                return m_position >= m_file.getSize();
+            }
+
+        protected:
+        private:
+            /**
+             * Ensure that there are enough bytes left.
+             *
+             * \param bytes the number of bytes needed
+             *
+             * \throw std::ios_base::failure if the file is too short
+             */
+            void require( size_t bytes ) const
+            {
+                if( bytes > m_file.getSize() - m_position )
+                {
+                    throw std::ios_base::failure( "FreeSurfer file \"" + m_file.getFilename() + "\" is truncated." );
+                }
+            }
+
+            /**
+             * The file.
+             */
+            const di::core::MappedFile& m_file;
+
+            /**
+             * The current read position in bytes.
+             */
+            size_t m_position = 0;
+        };
+    }
+}
+
+#endif  // DI_FREESURFERFORMAT_H
+
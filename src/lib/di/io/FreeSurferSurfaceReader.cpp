@@ -0,0 +1,116 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <ios>
+#include <string>
+#include <utility>
+
+#include <di/core/CompressedFile.h>
+#include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
+#include <di/core/StringUtils.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/core/data/TriangleDataSet.h>
+
+#include "FreeSurferFormat.h"
+#include "FreeSurferSurfaceReader.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/FreeSurferSurfaceReader"
+
+namespace di
+{
+    namespace io
+    {
+        FreeSurferSurfaceReader::FreeSurferSurfaceReader():
+            Reader()
+        {
+        }
+
+        FreeSurferSurfaceReader::~FreeSurferSurfaceReader()
+        {
+        }
+
+        bool FreeSurferSurfaceReader::canLoad( const std::string& filename ) const
+        {
+            // FreeSurfer surfaces have no real extension. The usual names are "lh.pial", "rh.white", ...
+            std::string ext = di::core::toLower( di::core::getFileExtension( di::core::getUncompressedFilename( filename ) ) );
+            return ( ext == "pial" ) || ( ext == "white" ) || ( ext == "inflated" ) || ( ext == "orig" ) || ( ext == "smoothwm" ) ||
+                   ( ext == "sphere" ) || ( ext == "midthickness" ) || ( ext == "graymid" );
+        }
+
+        SPtr< di::core::DataSetBase > FreeSurferSurfaceReader::load( const std::string& filename ) const
+        {
+            LogD << "Loading \"" << filename << "\"." << LogEnd;
+
+            auto file = di::core::openFile( filename );
+            FreeSurferStream stream( *file );
+
+            uint32_t magic = stream.readUInt24();
+            if( ( magic == freeSurferQuadMagic ) || ( magic == freeSurferNewQuadMagic ) )
+            {
+                throw std::ios_base::failure( "FreeSurfer file \"" + filename + "\" is a quad surface. Only triangle surfaces are supported." );
+            }
+            if( magic != freeSurferTriangleMagic )
+            {
+                throw std::ios_base::failure( "File \"" + filename + "\" is no FreeSurfer surface." );
+            }
+
+            // Two lines of text: "created by ..." and an empty line.
+            stream.skipLine();
+            stream.skipLine();
+
+            int32_t numVertices = stream.readInt32();
+            int32_t numTriangles = stream.readInt32();
+            if( ( numVertices <= 0 ) || ( numTriangles <= 0 ) )
+            {
+                throw std::ios_base::failure( "FreeSurfer surface \"" + filename + "\" is empty or invalid." );
+            }
+
+            // Both arrays consist of 4-byte values only and match our memory layout after fixing the byte order. Check the size before
+            // allocating. A corrupt header could ask for gigabytes.
+            stream.requireArray( 3 * static_cast< size_t >( numVertices ), sizeof( float ) );
+            Vec3Array vertices( numVertices );
+            stream.readArray( vertices.data(), 3 * vertices.size(), sizeof( float ) );
+            stream.requireArray( 3 * static_cast< size_t >( numTriangles ), sizeof( int32_t ) );
+            IndexVec3Array triangles( numTriangles );
+            stream.readArray( triangles.data(), 3 * triangles.size(), sizeof( int32_t ) );
+
+            if( !di::core::checkTriangleIndices( triangles, vertices.size() ) )
+            {
+                throw std::ios_base::failure( "FreeSurfer surface \"" + filename + "\" contains invalid vertex indices." );
+            }
+
+            LogD << "Loaded " << numTriangles << " triangles with " << numVertices << " vertices." << LogEnd;
+
+            SPtr< di::core::TriangleMesh > mesh( new di::core::TriangleMesh() );
+            mesh->setVertices( std::move( vertices ) );
+            mesh->setTriangles( std::move( triangles ) );
+            mesh->calculateNormals();
+
+            SPtr< RGBAArray > colors( new RGBAArray( mesh->getNumVertices(), glm::vec4( 1.0 ) ) );
+            return SPtr< di::core::TriangleDataSet >( new di::core::TriangleDataSet( filename, mesh, colors ) );
+        }
+    }
+}
@@ -0,0 +1,386 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ios>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <di/core/CompressedFile.h>
+#include <di/core/Endianness.h>
+#include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
+#include <di/core/Parallel.h>
+#include <di/core/StringUtils.h>
+#include <di/core/data/TriangleMesh.h>
+#include <di/core/data/TriangleDataSet.h>
+
+#include "RegionLabelReader.h"
+#include "GiftiReader.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/GiftiReader"
+
+namespace di
+{
+    namespace io
+    {
+        GiftiReader::GiftiReader():
+            Reader()
+        {
+        }
+
+        GiftiReader::~GiftiReader()
+        {
+        }
+
+        bool GiftiReader::canLoad( const std::string& filename ) const
+        {
+            std::string ext = di::core::getFileExtension( di::core::getUncompressedFilename( filename ) );
+            return ( di::core::toLower( ext ) == "gii" );
+        }
+
+        /**
+         * A DataArray element of a GIfTI file. The data itself stays in the mapped file.
+         */
+        struct GiftiDataArray
+        {
+            /**
+             * The attributes of the element, like "Intent", "DataType", "Encoding" or "Dim0".
+             */
+            std::map< std::string, std::string > attributes;
+
+            /**
+             * The first character of the content of the Data element.
+             */
+            const char* data = nullptr;
+
+            /**
+             * The character after the content of the Data element.
+             */
+            const char* dataEnd = nullptr;
+
+            /**
+             * Get an attribute.
+             *
+             * \param name the name
+             * \param defaultValue returned if there is no such attribute
+             *
+             * \return the value
+             */
+            std::string get( const std::string& name, const std::string& defaultValue = "" ) const
+            {
+                auto attribute = attributes.find( name );
+                return ( attribute == attributes.end() ) ? defaultValue : attribute->second;
+            }
+
+            /**
+             * The number of values in the given dimension.
+             *
+             * \param dimension the dimension
+             *
+             * \return the size. 1 for dimensions that do not exist.
+             */
+            size_t getDim( size_t dimension ) const
+            {
+                size_t numDims = std::stoul( get( "Dimensionality", "1" ) );
+                return ( dimension < numDims ) ? std::stoul( get( "Dim" + std::to_string( dimension ), "0" ) ) : 1;
+            }
+        };
+
+        /**
+         * Find the DataArray elements of a GIfTI file. This is no complete XML parser. It only understands the parts of XML used by GIfTI
+         * files.
+         *
+         * \param file the mapped file
+         *
+         * \throw std::ios_base::failure if an element is not closed properly
+         *
+         * \return the arrays in file order
+         */
+        std::vector< GiftiDataArray > findGiftiDataArrays( const di::core::MappedFile& file )
+        {
+            const char* begin = file.getData();
+            const char* end = begin + file.getSize();
+            auto find = [ & ]( const char* from, const std::string& what )
+            {
+                const char* found = std::search( from, end, what.begin(), what.end() );
+                if( found == end )
+                {
+                    throw std::ios_base::failure( "GIfTI file \"" + file.getFilename() + "\" is truncated. Missing \"" + what + "\"." );
+                }
+                return found;
+            };
+
+            std::vector< GiftiDataArray > arrays;
+            const std::string arrayTag = "<DataArray";
+            const char* pos = std::search( begin, end, arrayTag.begin(), arrayTag.end() );
+            while( pos != end )
+            {
+                GiftiDataArray array;
+
+                // Attributes: name="value" or name='value' until the end of the tag.
+                pos += arrayTag.size();
+                const char* tagEnd = find( pos, ">" );
+                while( pos < tagEnd )
+                {
+                    while( ( pos < tagEnd ) && ( std::isspace( static_cast< unsigned char >( *pos ) ) || ( *pos == '/' ) ) )
+                    {
+                        ++pos;
+                    }
+                    const char* nameEnd = std::find( pos, tagEnd, '=' );
+                    if( nameEnd == tagEnd )
+                    {
+                        break;
+                    }
+                    std::string name = di::core::trim( std::string( pos, nameEnd ) );
+                    const char* quote = std::find_if( nameEnd, tagEnd, []( char c ) { return ( c == '"' ) || ( c == '\'' ); } );
+                    const char* valueEnd = ( quote == tagEnd ) ? tagEnd : std::find( quote + 1, tagEnd, *quote );
+                    if( valueEnd == tagEnd )
+                    {
+                        throw std::ios_base::failure( "GIfTI file \"" + file.getFilename() + "\" contains an invalid DataArray attribute." );
+                    }
+                    array.attributes[ name ] = std::string( quote + 1, valueEnd );
+                    pos = valueEnd + 1;
+                }
+                pos = tagEnd + 1;
+
+                // The data element. Not there if the DataArray element is empty.
+                if( *( tagEnd - 1 ) != '/' )
+                {
+                    const char* arrayEnd = find( pos, "</DataArray>" );
+                    const std::string dataTag = "<Data>";
+                    const char* data = std::search( pos, arrayEnd, dataTag.begin(), dataTag.end() );
+                    if( data != arrayEnd )
+                    {
+                        array.data = data + dataTag.size();
+                        array.dataEnd = find( array.data, "</Data>" );
+                    }
+                    pos = arrayEnd;
+                }
+
+                arrays.push_back( std::move( array ) );
+                pos = std::search( pos, end, arrayTag.begin(), arrayTag.end() );
+            }
+            return arrays;
+        }
+
+        /**
+         * Convert the values of a GIfTI data array. Row major order is ensured.
+         *
+         * \tparam ValueType the target type
+         * \param array the array
+         * \param filename the file. Used for error messages.
+         *
+         * \throw std::ios_base::failure if the array is invalid or uses an unsupported encoding or data type
+         *
+         * \return the values
+         */
+        template< typename ValueType >
+        std::vector< ValueType > readGiftiDataArray( const GiftiDataArray& array, const std::string& filename )
+        {
+            size_t rows = array.getDim( 0 );
+            size_t columns = array.getDim( 1 );
+            size_t count = rows * columns;
+            if( !array.data || ( count == 0 ) || ( array.getDim( 2 ) != 1 ) )
+            {
+                throw std::ios_base::failure( "GIfTI file \"" + filename + "\" contains an empty or unsupported data array." );
+            }
+
+            std::vector< ValueType > values( count );
+            std::string encoding = array.get( "Encoding", "ASCII" );
+            if( encoding == "ASCII" )
+            {
+                const char* pos = array.data;
+                for( size_t i = 0; i < count; ++i )
+                {
+                    while( ( pos < array.dataEnd ) && std::isspace( static_cast< unsigned char >( *pos ) ) )
+                    {
+                        ++pos;
+                    }
+                    double value = 0.0;
+                    pos = di::core::parseNumber( pos, array.dataEnd, value );
+                    if( !pos )
+                    {
+                        throw std::ios_base::failure( "GIfTI file \"" + filename + "\" contains invalid or too few ASCII values." );
+                    }
+                    values[ i ] = static_cast< ValueType >( value );
+                }
+            }
+            else if( ( encoding == "Base64Binary" ) || ( encoding == "GZipBase64Binary" ) )
+            {
+                std::vector< uint8_t > bytes;
+                if( !di::core::decodeBase64( array.data, array.dataEnd, bytes ) )
+                {
+                    throw std::ios_base::failure( "GIfTI file \"" + filename + "\" contains invalid base64 data." );
+                }
+                if( encoding == "GZipBase64Binary" )
+                {
+                    std::vector< uint8_t > compressed;
+                    compressed.swap( bytes );
+                    di::core::inflateData( compressed.data(), compressed.size(), bytes );
+                }
+
+                std::string dataType = array.get( "DataType" );
+                size_t valueSize = ( dataType == "NIFTI_TYPE_UINT8" ) ? 1 :
+                                   ( ( dataType == "NIFTI_TYPE_INT32" ) || ( dataType == "NIFTI_TYPE_FLOAT32" ) ) ? 4 : 0;
+                if( valueSize == 0 )
+                {
+                    throw std::ios_base::failure( "GIfTI file \"" + filename + "\" uses the unsupported data type \"" + dataType + "\"." );
+                }
+                if( bytes.size() != count * valueSize )
+                {
+                    throw std::ios_base::failure( "GIfTI file \"" + filename + "\" contains a data array of the wrong size." );
+                }
+
+                bool swap = ( array.get( "Endian", "LittleEndian" ) == "BigEndian" ) == di::core::isLittleEndian();
+                di::core::parallelFor( 0, count,
+                    [ & ]( size_t begin, size_t end, size_t )
+                    {
+                        for( size_t i = begin; i < end; ++i )
+                        {
+                            const uint8_t* value = bytes.data() + i * valueSize;
+                            if( valueSize == 1 )
+                            {
+                                values[ i ] = static_cast< ValueType >( *value );
+                            }
+                            else if( dataType == "NIFTI_TYPE_INT32" )
+                            {
+                                int32_t intValue;
+                                std::memcpy( &intValue, value, sizeof( intValue ) );
+                                if( swap )
+                                {
+                                    di::core::swapBytes( intValue );
+                                }
+                                values[ i ] = static_cast< ValueType >( intValue );
+                            }
+                            else
+                            {
+                                float floatValue;
+                                std::memcpy( &floatValue, value, sizeof( floatValue ) );
+                                if( swap )
+                                {
+                                    di::core::swapBytes( floatValue );
+                                }
+                                values[ i ] = static_cast< ValueType >( floatValue );
+                            }
+                        }
+                    }
+                );
+            }
+            else
+            {
+                throw std::ios_base::failure( "GIfTI file \"" + filename + "\" uses the unsupported encoding \"" + encoding + "\"." );
+            }
+
+            // Column major 2D arrays need to be transposed.
+            if( ( columns > 1 ) && ( array.get( "ArrayIndexingOrder", "RowMajorOrder" ) == "ColumnMajorOrder" ) )
+            {
+                std::vector< ValueType > transposed( count );
+                for( size_t row = 0; row < rows; ++row )
+                {
+                    for( size_t column = 0; column < columns; ++column )
+                    {
+                        transposed[ row * columns + column ] = values[ column * rows + row ];
+                    }
+                }
+                values.swap( transposed );
+            }
+            return values;
+        }
+
+        SPtr< di::core::DataSetBase > GiftiReader::load( const std::string& filename ) const
+        {
+            LogD << "Loading \"" << filename << "\"." << LogEnd;
+
+            auto file = di::core::openFile( filename );
+            auto arrays = findGiftiDataArrays( *file );
+
+            const GiftiDataArray* points = nullptr;
+            const GiftiDataArray* triangles = nullptr;
+            const GiftiDataArray* labels = nullptr;
+            for( const auto& array : arrays )
+            {
+                std::string intent = array.get( "Intent" );
+                if( ( intent == "NIFTI_INTENT_POINTSET" ) && !points )
+                {
+                    points = &array;
+                }
+                else if( ( intent == "NIFTI_INTENT_TRIANGLE" ) && !triangles )
+                {
+                    triangles = &array;
+                }
+                else if( ( intent == "NIFTI_INTENT_LABEL" ) && !labels )
+                {
+                    labels = &array;
+                }
+            }
+
+            if( points && triangles )
+            {
+                if( ( points->getDim( 1 ) != 3 ) || ( triangles->getDim( 1 ) != 3 ) )
+                {
+                    throw std::ios_base::failure( "GIfTI file \"" + filename + "\" contains points or triangles with other than 3 components." );
+                }
+
+                auto coordinates = readGiftiDataArray< float >( *points, filename );
+                auto indices = readGiftiDataArray< int >( *triangles, filename );
+
+                Vec3Array vertexArray( coordinates.size() / 3 );
+                std::memcpy( static_cast< void* >( vertexArray.data() ), coordinates.data(), coordinates.size() * sizeof( float ) );
+                IndexVec3Array triangleArray( indices.size() / 3 );
+                std::memcpy( static_cast< void* >( triangleArray.data() ), indices.data(), indices.size() * sizeof( int ) );
+                if( !di::core::checkTriangleIndices( triangleArray, vertexArray.size() ) )
+                {
+                    throw std::ios_base::failure( "GIfTI file \"" + filename + "\" contains invalid vertex indices." );
+                }
+
+                LogD << "Loaded " << triangleArray.size() << " triangles with " << vertexArray.size() << " vertices." << LogEnd;
+
+                SPtr< di::core::TriangleMesh > mesh( new di::core::TriangleMesh() );
+                mesh->setVertices( std::move( vertexArray ) );
+                mesh->setTriangles( std::move( triangleArray ) );
+                mesh->calculateNormals();
+
+                SPtr< RGBAArray > colors( new RGBAArray( mesh->getNumVertices(), glm::vec4( 1.0 ) ) );
+                return SPtr< di::core::TriangleDataSet >( new di::core::TriangleDataSet( filename, mesh, colors ) );
+            }
+
+            if( labels )
+            {
+                auto values = std::make_shared< RegionLabelReader::AttributeType >(
+                    readGiftiDataArray< RegionLabelReader::value_type >( *labels, filename )
+                );
+                LogD << "Loaded " << values->size() << " labels." << LogEnd;
+                return std::make_shared< RegionLabelReader::DataSetType >( "Mesh Labels", values );
+            }
+
+            throw std::ios_base::failure( "GIfTI file \"" + filename + "\" contains neither a surface nor labels." );
+        }
+    }
+}
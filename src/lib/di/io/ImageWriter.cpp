@@ -0,0 +1,452 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef DI_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+#include <di/core/Parallel.h>
+
+#include "ImageWriter.h"
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Minimum amount of raw pixel data per band when compressing PNG files in parallel. Smaller bands compress worse.
+         */
+        const size_t pngMinBandSize = 256 * 1024;
+
+        /**
+         * Maximum size of a single IDAT chunk.
+         */
+        const size_t pngMaxChunkSize = 1 << 30;
+
+        /**
+         * Get the memory row that is shown in the given image row.
+         *
+         * \param rgba the pixels
+         * \param width the width in pixels
+         * \param height the height in pixels
+         * \param y the image row. 0 is the top row.
+         * \param flipVertically true if the first memory row is the bottom row
+         *
+         * \return pointer to the first pixel of the row
+         */
+        const uint8_t* getImageRow( const uint8_t* rgba, size_t width, size_t height, size_t y, bool flipVertically )
+        {
+            size_t row = flipVertically ? ( height - 1 - y ) : y;
+            return rgba + row * width * 4;
+        }
+
+        /**
+         * Check the image size.
+         *
+         * \param filename the file. Used for error messages.
+         * \param rgba the pixels
+         * \param width the width in pixels
+         * \param height the height in pixels
+         *
+         * \throw std::invalid_argument if the image is empty or too large
+         */
+        void checkImage( const std::string& filename, const uint8_t* rgba, size_t width, size_t height )
+        {
+            if( !rgba || ( width == 0 ) || ( height == 0 ) )
+            {
+                throw std::invalid_argument( "Cannot write empty image to \"" + filename + "\"." );
+            }
+            if( ( width > static_cast< size_t >( std::numeric_limits< int32_t >::max() ) / 4 ) ||
+                ( height > static_cast< size_t >( std::numeric_limits< int32_t >::max() ) ) )
+            {
+                throw std::invalid_argument( "Image is too large to be written to \"" + filename + "\"." );
+            }
+        }
+
+        /**
+         * Store a 32 bit value in big endian byte order.
+         *
+         * \param value the value
+         * \param target the first of four bytes
+         */
+        void storeUInt32BE( uint32_t value, uint8_t* target )
+        {
+            target[ 0 ] = static_cast< uint8_t >( value >> 24 );
+            target[ 1 ] = static_cast< uint8_t >( value >> 16 );
+            target[ 2 ] = static_cast< uint8_t >( value >> 8 );
+            target[ 3 ] = static_cast< uint8_t >( value );
+        }
+
+        /**
+         * Store a value in little endian byte order.
+         *
+         * \param value the value
+         * \param bytes the number of bytes to store
+         * \param target the first byte
+         */
+        void storeLE( uint32_t value, size_t bytes, uint8_t* target )
+        {
+            for( size_t i = 0; i < bytes; ++i )
+            {
+                target[ i ] = static_cast< uint8_t >( value >> ( 8 * i ) );
+            }
+        }
+
+        bool isPNGSupported()
+        {
+#ifdef DI_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        }
+
+#ifdef DI_HAVE_ZLIB
+        /**
+         * Convert a row of RGBA pixels to RGB.
+         *
+         * \param rgba the source row
+         * \param width the number of pixels
+         * \param rgb the target row. Needs 3 * width bytes.
+         */
+        void copyRGBRow( const uint8_t* rgba, size_t width, uint8_t* rgb )
+        {
+            for( size_t x = 0; x < width; ++x )
+            {
+                rgb[ 3 * x + 0 ] = rgba[ 4 * x + 0 ];
+                rgb[ 3 * x + 1 ] = rgba[ 4 * x + 1 ];
+                rgb[ 3 * x + 2 ] = rgba[ 4 * x + 2 ];
+            }
+        }
+
+        /**
+         * The PNG Paeth predictor.
+         *
+         * \param left the left byte
+         * \param up the upper byte
+         * \param upperLeft the upper left byte
+         *
+         * \return the prediction
+         */
+        uint8_t paethPredictor( int left, int up, int upperLeft )
+        {
+            int p = left + up - upperLeft;
+            int pLeft = std::abs( p - left );
+            int pUp = std::abs( p - up );
+            int pUpperLeft = std::abs( p - upperLeft );
+            if( ( pLeft <= pUp ) && ( pLeft <= pUpperLeft ) )
+            {
+                return static_cast< uint8_t >( left );
+            }
+            return static_cast< uint8_t >( ( pUp <= pUpperLeft ) ? up : upperLeft );
+        }
+
+        /**
+         * Filter a row of RGB pixels. All five PNG filters are tried and the one with the smallest sum of absolute differences is used. This is
+         * the heuristic recommended by the PNG specification.
+         *
+         * \param row the row
+         * \param previous the row above. All zero for the first row.
+         * \param rowSize the size of a row in bytes
+         * \param candidate scratch memory of rowSize bytes
+         * \param target the filtered row. Needs rowSize + 1 bytes. The first byte is the filter type.
+         */
+        void filterPNGRow( const uint8_t* row, const uint8_t* previous, size_t rowSize, uint8_t* candidate, uint8_t* target )
+        {
+            const size_t bpp = 3;
+            uint64_t bestCost = std::numeric_limits< uint64_t >::max();
+            for( uint8_t filter = 0; filter < 5; ++filter )
+            {
+                uint64_t cost = 0;
+                for( size_t i = 0; i < rowSize; ++i )
+                {
+                    int left = ( i >= bpp ) ? row[ i - bpp ] : 0;
+                    int up = previous[ i ];
+                    int upperLeft = ( i >= bpp ) ? previous[ i - bpp ] : 0;
+                    int prediction = 0;
+                    switch( filter )
+                    {
+                        case 1:
+                            prediction = left;
+                            break;
+                        case 2:
+                            prediction = up;
+                            break;
+                        case 3:
+                            prediction = ( left + up ) / 2;
+                            break;
+                        case 4:
+                            prediction = paethPredictor( left, up, upperLeft );
+                            break;
+                        default:
+                            break;
+                    }
+                    candidate[ i ] = static_cast< uint8_t >( row[ i ] - prediction );
+
+                    // Interpret as signed difference
+                    cost += std::abs( static_cast< int8_t >( candidate[ i ] ) );
+                }
+
+                if( cost < bestCost )
+                {
+                    bestCost = cost;
+                    target[ 0 ] = filter;
+                    std::copy( candidate, candidate + rowSize, target + 1 );
+                }
+            }
+        }
+
+        /**
+         * Filter and deflate a band of image rows. The result is a raw deflate stream, ending on a byte boundary. If this is not the last band,
+         * the stream is not terminated so that it can be continued by the next band.
+         *
+         * \param rgba the pixels
+         * \param width the width in pixels
+         * \param height the height in pixels
+         * \param flipVertically true if the first memory row is the bottom row
+         * \param firstRow the first image row of the band
+         * \param endRow the row after the last one of the band
+         * \param compressed the compressed data. Replaced.
+         * \param adler the adler32 checksum of the filtered data
+         * \param filteredSize the size of the filtered data
+         *
+         * \throw std::ios_base::failure if compression fails
+         */
+        void compressPNGBand( const uint8_t* rgba, size_t width, size_t height, bool flipVertically, size_t firstRow, size_t endRow,
+                              std::vector< uint8_t >& compressed, uLong& adler, size_t& filteredSize )
+        {
+            size_t rowSize = width * 3;
+            std::vector< uint8_t > previous( rowSize, 0 );
+            std::vector< uint8_t > current( rowSize );
+            std::vector< uint8_t > candidate( rowSize );
+            std::vector< uint8_t > filtered( ( endRow - firstRow ) * ( rowSize + 1 ) );
+
+            // Filters need the row above, even if it belongs to the previous band.
+            if( firstRow > 0 )
+            {
+                copyRGBRow( getImageRow( rgba, width, height, firstRow - 1, flipVertically ), width, previous.data() );
+            }
+
+            for( size_t y = firstRow; y < endRow; ++y )
+            {
+                copyRGBRow( getImageRow( rgba, width, height, y, flipVertically ), width, current.data() );
+                filterPNGRow( current.data(), previous.data(), rowSize, candidate.data(), filtered.data() + ( y - firstRow ) * ( rowSize + 1 ) );
+                std::swap( current, previous );
+            }
+
+            filteredSize = filtered.size();
+            adler = adler32( adler32( 0, Z_NULL, 0 ), filtered.data(), static_cast< uInt >( filtered.size() ) );
+
+            z_stream stream;
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+
+            // Raw deflate. The zlib header and checksum are added once for all bands.
+            if( deflateInit2( &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_FILTERED ) != Z_OK )
+            {
+                throw std::ios_base::failure( "Could not initialize compression." );
+            }
+
+            bool last = ( endRow == height );
+            compressed.resize( deflateBound( &stream, filtered.size() ) + 16 );
+            stream.next_in = filtered.data();
+            stream.avail_in = static_cast< uInt >( filtered.size() );
+            stream.next_out = compressed.data();
+            stream.avail_out = static_cast< uInt >( compressed.size() );
+
+            // A sync flush ends the band on a byte boundary without terminating the stream.
+            int result = deflate( &stream, last ? Z_FINISH : Z_SYNC_FLUSH );
+            bool done = last ? ( result == Z_STREAM_END ) : ( ( result == Z_OK ) && ( stream.avail_out != 0 ) );
+            compressed.resize( compressed.size() - stream.avail_out );
+            deflateEnd( &stream );
+            if( !done )
+            {
+                throw std::ios_base::failure( "Could not compress image data." );
+            }
+        }
+
+        /**
+         * Write a PNG chunk.
+         *
+         * \param out the stream
+         * \param type the four character chunk type
+         * \param data the chunk data
+         * \param size the size of the data
+         */
+        void writePNGChunk( std::ofstream& out, const char* type, const uint8_t* data, size_t size )
+        {
+            uint8_t length[ 4 ];
+            storeUInt32BE( static_cast< uint32_t >( size ), length );
+
+            uLong crc = crc32( 0, Z_NULL, 0 );
+            crc = crc32( crc, reinterpret_cast< const Bytef* >( type ), 4 );
+            if( size > 0 )
+            {
+                crc = crc32( crc, data, static_cast< uInt >( size ) );
+            }
+            uint8_t crcBytes[ 4 ];
+            storeUInt32BE( static_cast< uint32_t >( crc ), crcBytes );
+
+            out.write( reinterpret_cast< const char* >( length ), 4 );
+            out.write( type, 4 );
+            out.write( reinterpret_cast< const char* >( data ), size );
+            out.write( reinterpret_cast< const char* >( crcBytes ), 4 );
+        }
+#endif
+
+        void writePNG( const std::string& filename, const uint8_t* rgba, size_t width, size_t height, bool flipVertically )
+        {
+            checkImage( filename, rgba, width, height );
+
+#ifdef DI_HAVE_ZLIB
+            // Split into bands. Each band is filtered and compressed on its own.
+            size_t rawSize = width * height * 3;
+            size_t numBands = std::max< size_t >( 1, std::min( di::core::getNumberOfThreads(), rawSize / pngMinBandSize ) );
+            numBands = std::min( numBands, height );
+
+            std::vector< std::vector< uint8_t > > bands( numBands );
+            std::vector< uLong > adlers( numBands );
+            std::vector< size_t > filteredSizes( numBands );
+            di::core::parallelFor( 0, height,
+                [ & ]( size_t begin, size_t end, size_t band )
+                {
+                    compressPNGBand( rgba, width, height, flipVertically, begin, end, bands[ band ], adlers[ band ], filteredSizes[ band ] );
+                },
+                numBands
+            );
+
+            // Join the bands to one zlib stream
+            uLong adler = adlers[ 0 ];
+            for( size_t band = 1; band < numBands; ++band )
+            {
+                adler = adler32_combine( adler, adlers[ band ], static_cast< z_off_t >( filteredSizes[ band ] ) );
+            }
+
+            std::ofstream out( filename.c_str(), std::ios::binary );
+            if( !out )
+            {
+                throw std::ios_base::failure( "Could not open \"" + filename + "\" for writing." );
+            }
+
+            const uint8_t signature[ 8 ] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            out.write( reinterpret_cast< const char* >( signature ), 8 );
+
+            // 8 bit RGB, no interlacing
+            uint8_t header[ 13 ] = { 0 };
+            storeUInt32BE( static_cast< uint32_t >( width ), header );
+            storeUInt32BE( static_cast< uint32_t >( height ), header + 4 );
+            header[ 8 ] = 8;
+            header[ 9 ] = 2;
+            writePNGChunk( out, "IHDR", header, 13 );
+
+            // zlib header: deflate, 32K window, default level. Checksum follows the last band.
+            const uint8_t zlibHeader[ 2 ] = { 0x78, 0x9C };
+            writePNGChunk( out, "IDAT", zlibHeader, 2 );
+            for( const auto& band : bands )
+            {
+                for( size_t offset = 0; offset < band.size(); offset += pngMaxChunkSize )
+                {
+                    writePNGChunk( out, "IDAT", band.data() + offset, std::min( pngMaxChunkSize, band.size() - offset ) );
+                }
+            }
+            uint8_t adlerBytes[ 4 ];
+            storeUInt32BE( static_cast< uint32_t >( adler ), adlerBytes );
+            writePNGChunk( out, "IDAT", adlerBytes, 4 );
+
+            writePNGChunk( out, "IEND", nullptr, 0 );
+
+            if( !out.flush() )
+            {
+                throw std::ios_base::failure( "Could not write \"" + filename + "\"." );
+            }
+#else
+            static_cast< void >( flipVertically );
+            throw std::ios_base::failure( "Cannot write \"" + filename + "\". This build does not support PNG." );
+#endif
+        }
+
+        void writeBMP( const std::string& filename, const uint8_t* rgba, size_t width, size_t height, bool flipVertically )
+        {
+            checkImage( filename, rgba, width, height );
+
+            // Rows are padded to 4 bytes and stored bottom-up
+            size_t rowSize = ( width * 3 + 3 ) & ~static_cast< size_t >( 3 );
+            size_t dataSize = rowSize * height;
+            if( dataSize > std::numeric_limits< uint32_t >::max() - 54 )
+            {
+                throw std::invalid_argument( "Image is too large to be written to \"" + filename + "\"." );
+            }
+
+            std::vector< uint8_t > data( 54 + dataSize, 0 );
+
+            // File header
+            data[ 0 ] = 'B';
+            data[ 1 ] = 'M';
+            storeLE( static_cast< uint32_t >( data.size() ), 4, &data[ 2 ] );
+            storeLE( 54, 4, &data[ 10 ] );
+
+            // Info header. 24 bit, uncompressed.
+            storeLE( 40, 4, &data[ 14 ] );
+            storeLE( static_cast< uint32_t >( width ), 4, &data[ 18 ] );
+            storeLE( static_cast< uint32_t >( height ), 4, &data[ 22 ] );
+            storeLE( 1, 2, &data[ 26 ] );
+            storeLE( 24, 2, &data[ 28 ] );
+            storeLE( static_cast< uint32_t >( dataSize ), 4, &data[ 34 ] );
+
+            di::core::parallelFor( 0, height,
+                [ & ]( size_t begin, size_t end, size_t )
+                {
+                    for( size_t y = begin; y < end; ++y )
+                    {
+                        const uint8_t* source = getImageRow( rgba, width, height, height - 1 - y, flipVertically );
+                        uint8_t* target = &data[ 54 + y * rowSize ];
+                        for( size_t x = 0; x < width; ++x )
+                        {
+                            target[ 3 * x + 0 ] = source[ 4 * x + 2 ];
+                            target[ 3 * x + 1 ] = source[ 4 * x + 1 ];
+                            target[ 3 * x + 2 ] = source[ 4 * x + 0 ];
+                        }
+                    }
+                }
+            );
+
+            std::ofstream out( filename.c_str(), std::ios::binary );
+            if( !out || !out.write( reinterpret_cast< const char* >( data.data() ), data.size() ) )
+            {
+                throw std::ios_base::failure( "Could not write \"" + filename + "\"." );
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_IMAGEWRITER_H
+#define DI_IMAGEWRITER_H
+
+#include <cstdint>
+#include <string>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Check whether this build can write PNG files. This needs zlib.
+         *
+         * \return true if supported.
+         */
+        bool isPNGSupported();
+
+        /**
+         * Write an RGBA8 image as compressed 24 bit PNG. The alpha channel is dropped. The rows are filtered and deflated in parallel: the image
+         * is split into bands of rows, each band is compressed independently and the results are joined into a single zlib stream.
+         *
+         * \param filename the file to write
+         * \param rgba the pixels. Tightly packed, 4 bytes per pixel, row by row.
+         * \param width the width in pixels
+         * \param height the height in pixels
+         * \param flipVertically if true, the first row in memory is the bottom row of the image. This is the case for OpenGL read-backs.
+         *
+         * \throw std::invalid_argument if the image is empty
+         * \throw std::ios_base::failure if the file cannot be written or zlib is not available.
+         */
+        void writePNG( const std::string& filename, const uint8_t* rgba, size_t width, size_t height, bool flipVertically = false );
+
+        /**
+         * Write an RGBA8 image as uncompressed 24 bit BMP. The alpha channel is dropped. Use this if \ref isPNGSupported is false.
+         *
+         * \param filename the file to write
+         * \param rgba the pixels. Tightly packed, 4 bytes per pixel, row by row.
+         * \param width the width in pixels
+         * \param height the height in pixels
+         * \param flipVertically if true, the first row in memory is the bottom row of the image. This is the case for OpenGL read-backs.
+         *
+         * \throw std::invalid_argument if the image is empty
+         * \throw std::ios_base::failure if the file cannot be written.
+         */
+        void writeBMP( const std::string& filename, const uint8_t* rgba, size_t width, size_t height, bool flipVertically = false );
+    }
+}
+
+#endif  // DI_IMAGEWRITER_H
+
@@ -0,0 +1,411 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <string>
+#include <vector>
+
+#include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
+#include <di/core/data/TriangleMesh.h>
+
+#include "MeshCache.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/MeshCache"
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * The magic bytes at the start of each mesh cache file.
+         */
+        const char meshCacheMagic[ 8 ] = { 'D', 'I', 'M', 'E', 'S', 'H', 0, 0 };
+
+        /**
+         * Used to detect the byte order of the writing machine.
+         */
+        const uint32_t meshCacheByteOrder = 0x01020304;
+
+        /**
+         * A section to write.
+         */
+        struct MeshCacheSectionData
+        {
+            /**
+             * The table entry. The offset is calculated when writing.
+             */
+            MeshCacheSection section;
+
+            /**
+             * The data to write.
+             */
+            const void* data;
+        };
+
+        std::string getMeshCacheFilename( const std::string& sourceFilename )
+        {
+            return sourceFilename + ".dimesh";
+        }
+
+        /**
+         * Round up to the next multiple of \ref meshCacheAlignment.
+         *
+         * \param offset the offset
+         *
+         * \return the aligned offset
+         */
+        uint64_t alignMeshCacheOffset( uint64_t offset )
+        {
+            return ( ( offset + meshCacheAlignment - 1 ) / meshCacheAlignment ) * meshCacheAlignment;
+        }
+
+        /**
+         * Create a section to write.
+         *
+         * \tparam ValueT the element type
+         * \param type the section type
+         * \param values the values
+         *
+         * \return the section
+         */
+        template< typename ValueT >
+        MeshCacheSectionData makeMeshCacheSection( MeshCacheSectionType type, const std::vector< ValueT >& values )
+        {
+            MeshCacheSectionData result;
+            result.section.type = static_cast< uint32_t >( type );
+            result.section.elementSize = sizeof( ValueT );
+            result.section.offset = 0;
+            result.section.count = values.size();
+            result.data = values.data();
+            return result;
+        }
+
+        void writeMeshCache( const std::string& filename, const di::core::TriangleDataSet& data, const std::string& sourceFilename )
+        {
+            LogD << "Writing \"" << filename << "\"." << LogEnd;
+
+            auto mesh = data.getGrid();
+            auto colors = data.getAttributes< 0 >();
+
+            // The inverse index is stored as uint64_t. Only convert if size_t differs.
+            const auto& inverseIndexOffsets = mesh->getInverseIndexOffsets();
+            const auto& inverseIndexTriangles = mesh->getInverseIndexTriangles();
+            std::vector< uint64_t > offsets64;
+            std::vector< uint64_t > triangles64;
+            if( sizeof( size_t ) != sizeof( uint64_t ) )
+            {
+                offsets64.assign( inverseIndexOffsets.begin(), inverseIndexOffsets.end() );
+                triangles64.assign( inverseIndexTriangles.begin(), inverseIndexTriangles.end() );
+            }
+
+            std::vector< MeshCacheSectionData > sections;
+            sections.push_back( makeMeshCacheSection( MeshCacheSectionType::Vertices, mesh->getVertices() ) );
+            sections.push_back( makeMeshCacheSection( MeshCacheSectionType::Triangles, mesh->getTriangles() ) );
+            if( !mesh->getNormals().empty() )
+            {
+                sections.push_back( makeMeshCacheSection( MeshCacheSectionType::Normals, mesh->getNormals() ) );
+            }
+            if( colors && !colors->empty() )
+            {
+                sections.push_back( makeMeshCacheSection( MeshCacheSectionType::Colors, *colors ) );
+            }
+            if( sizeof( size_t ) == sizeof( uint64_t ) )
+            {
+                sections.push_back( makeMeshCacheSection( MeshCacheSectionType::InverseIndexOffsets, inverseIndexOffsets ) );
+                sections.push_back( makeMeshCacheSection( MeshCacheSectionType::InverseIndexTriangles, inverseIndexTriangles ) );
+            }
+            else
+            {
+                sections.push_back( makeMeshCacheSection( MeshCacheSectionType::InverseIndexOffsets, offsets64 ) );
+                sections.push_back( makeMeshCacheSection( MeshCacheSectionType::InverseIndexTriangles, triangles64 ) );
+            }
+
+            MeshCacheHeader header;
+            std::memset( &header, 0, sizeof( header ) );
+            std::memcpy( header.magic, meshCacheMagic, sizeof( header.magic ) );
+            header.version = meshCacheVersion;
+            header.byteOrder = meshCacheByteOrder;
+            header.numSections = static_cast< uint32_t >( sections.size() );
+            if( !sourceFilename.empty() && !di::core::getFileInfo( sourceFilename, header.sourceSize, header.sourceModificationTime ) )
+            {
+                throw std::ios_base::failure( "Source file \"" + sourceFilename + "\" of mesh cache does not exist." );
+            }
+            const auto& boundingBox = mesh->getBoundingBox();
+            for( int i = 0; i < 3; ++i )
+            {
+                header.boundingBoxMin[ i ] = boundingBox.getMin()[ i ];
+                header.boundingBoxMax[ i ] = boundingBox.getMax()[ i ];
+            }
+
+            // Layout: header, section table, aligned sections
+            uint64_t offset = sizeof( MeshCacheHeader ) + sections.size() * sizeof( MeshCacheSection );
+            for( auto& section : sections )
+            {
+                section.section.offset = alignMeshCacheOffset( offset );
+                offset = section.section.offset + section.section.count * section.section.elementSize;
+            }
+
+            // Write to a temporary file next to the target and rename it when done. This way, nobody reads a partially written cache. Neither
+            // while writing nor after an interrupted write.
+            std::string tempFilename = di::core::getTemporaryFilename( filename );
+            std::ofstream out( tempFilename, std::ios::out | std::ios::binary );
+            if( !out.good() )
+            {
+                throw std::ios_base::failure( "Could not open \"" + tempFilename + "\" for writing." );
+            }
+
+            out.write( reinterpret_cast< const char* >( &header ), sizeof( header ) );
+            for( const auto& section : sections )
+            {
+                out.write( reinterpret_cast< const char* >( &section.section ), sizeof( MeshCacheSection ) );
+            }
+
+            const char padding[ meshCacheAlignment ] = {};
+            uint64_t position = sizeof( MeshCacheHeader ) + sections.size() * sizeof( MeshCacheSection );
+            for( const auto& section : sections )
+            {
+                out.write( padding, section.section.offset - position );
+                out.write( reinterpret_cast< const char* >( section.data ), section.section.count * section.section.elementSize );
+                position = section.section.offset + section.section.count * section.section.elementSize;
+            }
+
+            out.close();
+            if( !out.good() )
+            {
+                std::remove( tempFilename.c_str() );
+                throw std::ios_base::failure( "Could not write \"" + filename + "\"." );
+            }
+
+            if( std::rename( tempFilename.c_str(), filename.c_str() ) != 0 )
+            {
+                std::remove( tempFilename.c_str() );
+                throw std::ios_base::failure( "Could not replace \"" + filename + "\"." );
+            }
+
+            LogD << "Wrote " << mesh->getNumTriangles() << " triangles with " << mesh->getNumVertices() << " vertices to \"" << filename << "\"."
+                 << LogEnd;
+        }
+
+        /**
+         * Copy a section of a mesh cache file into a vector.
+         *
+         * \tparam ValueT the element type in memory
+         * \tparam FileValueT the element type in the file. Converted to ValueT if different.
+         * \param file the mapped file
+         * \param section the section. Bounds and element size are checked before.
+         *
+         * \return the values
+         */
+        template< typename ValueT, typename FileValueT = ValueT >
+        std::vector< ValueT > readMeshCacheSection( const di::core::MappedFile& file, const MeshCacheSection& section )
+        {
+            std::vector< ValueT > result( section.count );
+            const char* data = file.getData() + section.offset;
+            if( sizeof( ValueT ) == sizeof( FileValueT ) )
+            {
+                std::memcpy( static_cast< void* >( result.data() ), data, section.count * sizeof( ValueT ) );
+            }
+            else
+            {
+                for( size_t i = 0; i < result.size(); ++i )
+                {
+                    FileValueT value;
+                    std::memcpy( static_cast< void* >( &value ), data + i * sizeof( FileValueT ), sizeof( FileValueT ) );
+                    result[ i ] = static_cast< ValueT >( value );
+                }
+            }
+            return result;
+        }
+
+        /**
+         * The size of the elements of a section type.
+         *
+         * \param type the type
+         *
+         * \return the size in bytes. 0 for unknown types.
+         */
+        size_t getMeshCacheElementSize( uint32_t type )
+        {
+            switch( static_cast< MeshCacheSectionType >( type ) )
+            {
+                case MeshCacheSectionType::Vertices:
+                case MeshCacheSectionType::Normals:
+                    return sizeof( glm::vec3 );
+                case MeshCacheSectionType::Triangles:
+                    return sizeof( glm::ivec3 );
+                case MeshCacheSectionType::Colors:
+                    return sizeof( glm::vec4 );
+                case MeshCacheSectionType::InverseIndexOffsets:
+                case MeshCacheSectionType::InverseIndexTriangles:
+                    return sizeof( uint64_t );
+                default:
+                    return 0;
+            }
+        }
+
+        SPtr< di::core::TriangleDataSet > readMeshCache( const std::string& filename, const std::string& name, const std::string& sourceFilename )
+        {
+            LogD << "Loading \"" << filename << "\"." << LogEnd;
+
+            SPtr< di::core::MappedFile > file;
+            try
+            {
+                file = std::make_shared< di::core::MappedFile >( filename );
+            }
+            catch( const std::exception& )
+            {
+                LogE << "Failed to open mesh cache " << filename << LogEnd;
+                throw std::ios_base::failure( "Failed to open mesh cache " + filename );
+            }
+
+            MeshCacheHeader header;
+            if( file->getSize() < sizeof( header ) )
+            {
+                throw std::ios_base::failure( "File \"" + filename + "\" is not a mesh cache." );
+            }
+            std::memcpy( &header, file->getData(), sizeof( header ) );
+            if( std::memcmp( header.magic, meshCacheMagic, sizeof( header.magic ) ) != 0 )
+            {
+                throw std::ios_base::failure( "File \"" + filename + "\" is not a mesh cache." );
+            }
+            if( ( header.version != meshCacheVersion ) || ( header.byteOrder != meshCacheByteOrder ) )
+            {
+                throw std::ios_base::failure( "Mesh cache \"" + filename + "\" was written by another version or on another platform." );
+            }
+
+            if( !sourceFilename.empty() )
+            {
+                uint64_t sourceSize = 0;
+                int64_t sourceModificationTime = 0;
+                if( !di::core::getFileInfo( sourceFilename, sourceSize, sourceModificationTime ) ||
+                    ( sourceSize != header.sourceSize ) || ( sourceModificationTime != header.sourceModificationTime ) )
+                {
+                    LogD << "Mesh cache \"" << filename << "\" is outdated." << LogEnd;
+                    return nullptr;
+                }
+            }
+
+            // Read and check the section table
+            uint64_t tableSize = static_cast< uint64_t >( header.numSections ) * sizeof( MeshCacheSection );
+            if( ( file->getSize() - sizeof( header ) ) < tableSize )
+            {
+                throw std::ios_base::failure( "Mesh cache \"" + filename + "\" is truncated." );
+            }
+            std::vector< MeshCacheSection > sections( header.numSections );
+            std::memcpy( sections.data(), file->getData() + sizeof( header ), tableSize );
+
+            const MeshCacheSection* sectionOfType[ 7 ] = {};
+            for( const auto& section : sections )
+            {
+                size_t elementSize = getMeshCacheElementSize( section.type );
+                if( ( elementSize == 0 ) || ( section.elementSize != elementSize ) )
+                {
+                    throw std::ios_base::failure( "Mesh cache \"" + filename + "\" contains an unknown section." );
+                }
+                if( ( section.offset > file->getSize() ) || ( ( file->getSize() - section.offset ) / elementSize < section.count ) )
+                {
+                    throw std::ios_base::failure( "Mesh cache \"" + filename + "\" is truncated." );
+                }
+                sectionOfType[ section.type ] = &section;
+            }
+
+            auto vertexSection = sectionOfType[ static_cast< int >( MeshCacheSectionType::Vertices ) ];
+            auto triangleSection = sectionOfType[ static_cast< int >( MeshCacheSectionType::Triangles ) ];
+            auto normalSection = sectionOfType[ static_cast< int >( MeshCacheSectionType::Normals ) ];
+            auto colorSection = sectionOfType[ static_cast< int >( MeshCacheSectionType::Colors ) ];
+            auto offsetSection = sectionOfType[ static_cast< int >( MeshCacheSectionType::InverseIndexOffsets ) ];
+            auto inverseSection = sectionOfType[ static_cast< int >( MeshCacheSectionType::InverseIndexTriangles ) ];
+            if( !vertexSection || !triangleSection )
+            {
+                throw std::ios_base::failure( "Mesh cache \"" + filename + "\" does not contain a mesh." );
+            }
+
+            auto vertices = readMeshCacheSection< glm::vec3 >( *file, *vertexSection );
+            auto triangles = readMeshCacheSection< glm::ivec3 >( *file, *triangleSection );
+
+            // Broken indices would make the mesh unusable
+            if( !di::core::checkTriangleIndices( triangles, vertices.size() ) )
+            {
+                throw std::ios_base::failure( "Mesh cache \"" + filename + "\" contains invalid vertex indices." );
+            }
+
+            di::core::BoundingBox boundingBox;
+            if( header.boundingBoxMin[ 0 ] <= header.boundingBoxMax[ 0 ] )
+            {
+                boundingBox.include( header.boundingBoxMin[ 0 ], header.boundingBoxMin[ 1 ], header.boundingBoxMin[ 2 ] );
+                boundingBox.include( header.boundingBoxMax[ 0 ], header.boundingBoxMax[ 1 ], header.boundingBoxMax[ 2 ] );
+            }
+
+            auto mesh = std::make_shared< di::core::TriangleMesh >();
+            mesh->setVertices( std::move( vertices ), boundingBox );
+            mesh->setTriangles( std::move( triangles ) );
+
+            // The inverse index is only used if it is consistent. It is cheap to check compared to rebuilding it.
+            if( offsetSection && inverseSection && ( offsetSection->count == mesh->getNumVertices() + 1 ) )
+            {
+                auto offsets = readMeshCacheSection< size_t, uint64_t >( *file, *offsetSection );
+                auto inverse = readMeshCacheSection< size_t, uint64_t >( *file, *inverseSection );
+                bool consistent = ( offsets.front() == 0 ) && ( offsets.back() == inverse.size() );
+                for( size_t i = 1; consistent && ( i < offsets.size() ); ++i )
+                {
+                    consistent = ( offsets[ i - 1 ] <= offsets[ i ] );
+                }
+                consistent = consistent && std::all_of( inverse.begin(), inverse.end(),
+                                                        [ & ]( size_t triangle ) { return triangle < mesh->getNumTriangles(); } );
+                if( consistent )
+                {
+                    mesh->setInverseIndex( std::move( offsets ), std::move( inverse ) );
+                }
+            }
+
+            // Normals are needed in any case. Create them if not stored.
+            if( normalSection && ( normalSection->count == mesh->getNumVertices() ) )
+            {
+                mesh->setNormals( readMeshCacheSection< glm::vec3 >( *file, *normalSection ) );
+            }
+            else
+            {
+                mesh->calculateNormals();
+            }
+
+            auto colors = std::make_shared< RGBAArray >();
+            if( colorSection )
+            {
+                *colors = readMeshCacheSection< glm::vec4 >( *file, *colorSection );
+            }
+
+            LogD << "Loaded " << mesh->getNumTriangles() << " triangles with " << mesh->getNumVertices() << " vertices and " << colors->size()
+                 << " colors from cache." << LogEnd;
+
+            return std::make_shared< di::core::TriangleDataSet >( name, mesh, colors );
+        }
+    }
+}
@@ -0,0 +1,181 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#ifndef DI_MESHCACHE_H
+#define DI_MESHCACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include <di/core/data/TriangleDataSet.h>
+
+#include <di/Types.h>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * The version of the mesh cache format. Increase whenever the layout changes. Files of other versions are rejected.
+         */
+        const uint32_t meshCacheVersion = 1;
+
+        /**
+         * The alignment of each section in a mesh cache file.
+         */
+        const size_t meshCacheAlignment = 64;
+
+        /**
+         * The sections that can appear in a mesh cache file.
+         */
+        enum class MeshCacheSectionType: uint32_t
+        {
+            Vertices = 1,               // glm::vec3
+            Triangles = 2,              // glm::ivec3
+            Normals = 3,                // glm::vec3
+            Colors = 4,                 // glm::vec4
+            InverseIndexOffsets = 5,    // uint64_t
+            InverseIndexTriangles = 6   // uint64_t
+        };
+
+        /**
+         * The header at the start of a mesh cache file. All values are stored in the byte order of the writing machine. It is followed by
+         * \ref numSections instances of \ref MeshCacheSection.
+         */
+        struct MeshCacheHeader
+        {
+            /**
+             * Identifies the file: "DIMESH" padded with zeros.
+             */
+            char magic[ 8 ];
+
+            /**
+             * The format version. See \ref meshCacheVersion.
+             */
+            uint32_t version;
+
+            /**
+             * The value 0x01020304 as written by the writing machine. Used to reject files with foreign byte order.
+             */
+            uint32_t byteOrder;
+
+            /**
+             * The size of the file the mesh was created from. 0 if unknown.
+             */
+            uint64_t sourceSize;
+
+            /**
+             * The modification time of the file the mesh was created from. 0 if unknown.
+             */
+            int64_t sourceModificationTime;
+
+            /**
+             * The bounding box minimum.
+             */
+            double boundingBoxMin[ 3 ];
+
+            /**
+             * The bounding box maximum.
+             */
+            double boundingBoxMax[ 3 ];
+
+            /**
+             * The number of entries in the section table.
+             */
+            uint32_t numSections;
+
+            /**
+             * Unused. Keeps the size a multiple of 8.
+             */
+            uint32_t reserved;
+        };
+
+        /**
+         * An entry of the section table.
+         */
+        struct MeshCacheSection
+        {
+            /**
+             * The contents. See \ref MeshCacheSectionType.
+             */
+            uint32_t type;
+
+            /**
+             * The size of a single element in bytes.
+             */
+            uint32_t elementSize;
+
+            /**
+             * Offset of the data in the file. A multiple of \ref meshCacheAlignment.
+             */
+            uint64_t offset;
+
+            /**
+             * The number of elements.
+             */
+            uint64_t count;
+        };
+
+        /**
+         * The name of the cache file kept next to a source mesh file.
+         *
+         * \param sourceFilename the source mesh
+         *
+         * \return the cache file name
+         */
+        std::string getMeshCacheFilename( const std::string& sourceFilename );
+
+        /**
+         * Write a triangle dataset to a mesh cache file. Besides the mesh and its colors, the normals, the inverse index and the bounding box are
+         * stored. The inverse index is created if not yet done. The cache is written to a temporary file in the same directory first, which then
+         * replaces the target file. Readers never see a partially written cache.
+         *
+         * \param filename the file to write
+         * \param data the data to write
+         * \param sourceFilename if not empty, size and modification time of this file are stored. Use this to validate the cache later.
+         *
+         * \throw std::ios_base::failure if writing fails.
+         */
+        void writeMeshCache( const std::string& filename, const di::core::TriangleDataSet& data, const std::string& sourceFilename = "" );
+
+        /**
+         * Read a mesh cache file. The file is memory-mapped and each section is copied into the mesh with a single bulk copy. Nothing is parsed
+         * or recomputed.
+         *
+         * \param filename the file to read
+         * \param name the name of the resulting dataset
+         * \param sourceFilename if not empty, the cache is only used if size and modification time of this file match the stored ones.
+         *
+         * \throw std::ios_base::failure if the file is not a valid mesh cache.
+         *
+         * \return the data. Nullptr if the cache does not match the source file.
+         */
+        SPtr< di::core::TriangleDataSet > readMeshCache( const std::string& filename, const std::string& name,
+                                                         const std::string& sourceFilename = "" );
+    }
+}
+
+#endif  // DI_MESHCACHE_H
+
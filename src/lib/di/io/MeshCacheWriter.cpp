@@ -0,0 +1,65 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <stdexcept>
+#include <string>
+
+#include <di/core/Filesystem.h>
+#include <di/core/StringUtils.h>
+#include <di/core/data/TriangleDataSet.h>
+
+#include "MeshCache.h"
+#include "MeshCacheWriter.h"
+
+namespace di
+{
+    namespace io
+    {
+        MeshCacheWriter::MeshCacheWriter():
+            Writer()
+        {
+        }
+
+        MeshCacheWriter::~MeshCacheWriter()
+        {
+        }
+
+        bool MeshCacheWriter::canWrite( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            std::string ext = di::core::toLower( di::core::getFileExtension( filename ) );
+            return ( ext == "dimesh" ) && ( std::dynamic_pointer_cast< const di::core::TriangleDataSet >( data ) != nullptr );
+        }
+
+        void MeshCacheWriter::write( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            auto triangles = std::dynamic_pointer_cast< const di::core::TriangleDataSet >( data );
+            if( !triangles )
+            {
+                throw std::invalid_argument( "Mesh cache writer only supports triangle meshes. Cannot write \"" + filename + "\"." );
+            }
+            writeMeshCache( filename, *triangles );
+        }
+    }
+}
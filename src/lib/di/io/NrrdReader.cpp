@@ -0,0 +1,527 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <di/core/Endianness.h>
+#include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
+#include <di/core/Parallel.h>
+#include <di/core/StringUtils.h>
+#include <di/core/data/DataSetTypes.h>
+#include <di/core/data/SlabStreaming.h>
+
+#include "NrrdReader.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/NrrdReader"
+
+namespace di
+{
+    namespace io
+    {
+        NrrdReader::NrrdReader():
+            Reader()
+        {
+        }
+
+        NrrdReader::~NrrdReader()
+        {
+        }
+
+        bool NrrdReader::canLoad( const std::string& filename ) const
+        {
+            std::string ext = di::core::toLower( di::core::getFileExtension( filename ) );
+            return ( ext == "nrrd" ) || ( ext == "nhdr" );
+        }
+
+        /**
+         * The information we need from a NRRD header.
+         */
+        struct NrrdHeader
+        {
+            /**
+             * The normalized value type. One of int8, uint8, int16, uint16, int32, uint32, int64, uint64, float, double.
+             */
+            std::string type;
+
+            /**
+             * Number of dimensions
+             */
+            size_t dimension = 0;
+
+            /**
+             * Number of samples per axis. The first axis is the fastest.
+             */
+            std::array< size_t, 3 > sizes = { { 0, 0, 0 } };
+
+            /**
+             * True if the data is stored in big endian.
+             */
+            bool bigEndian = !di::core::isLittleEndian();
+
+            /**
+             * The encoding.
+             */
+            std::string encoding;
+
+            /**
+             * The detached data file. Empty if attached.
+             */
+            std::string dataFile;
+
+            /**
+             * Bytes to skip in the data file. -1 means the data is at the end of the file.
+             */
+            long byteSkip = 0;
+
+            /**
+             * Lines to skip in the data file.
+             */
+            size_t lineSkip = 0;
+
+            /**
+             * Transforms sample indices to world space.
+             */
+            glm::dmat4 indexToWorld = glm::dmat4( 1.0 );
+        };
+
+        /**
+         * Parse a NRRD vector like "(1.0,0,0)".
+         *
+         * \param value the string
+         *
+         * \return the vector
+         */
+        glm::dvec3 parseNrrdVector( const std::string& value )
+        {
+            auto open = value.find( '(' );
+            auto close = value.find( ')' );
+            if( ( open == std::string::npos ) || ( close == std::string::npos ) || ( close < open ) )
+            {
+                throw std::ios_base::failure( "Invalid NRRD vector \"" + value + "\"." );
+            }
+
+            auto items = di::core::split( value.substr( open + 1, close - open - 1 ), ',' );
+            if( items.size() != 3 )
+            {
+                throw std::ios_base::failure( "Only 3D NRRD vectors are supported: \"" + value + "\"." );
+            }
+            return glm::dvec3( std::atof( items[ 0 ].c_str() ), std::atof( items[ 1 ].c_str() ), std::atof( items[ 2 ].c_str() ) );
+        }
+
+        /**
+         * Map the various NRRD type names to a normalized name.
+         *
+         * \param type the type as found in the header
+         *
+         * \return the normalized name. Empty if unknown.
+         */
+        std::string normalizeNrrdType( const std::string& type )
+        {
+            static const std::vector< std::vector< std::string > > synonyms = {
+                { "int8", "signed char", "int8_t" },
+                { "uint8", "uchar", "unsigned char", "uint8_t" },
+                { "int16", "short", "short int", "signed short", "signed short int", "int16_t" },
+                { "uint16", "ushort", "unsigned short", "unsigned short int", "uint16_t" },
+                { "int32", "int", "signed int", "int32_t" },
+                { "uint32", "uint", "unsigned int", "uint32_t" },
+                { "int64", "longlong", "long long", "long long int", "signed long long", "signed long long int", "int64_t" },
+                { "uint64", "ulonglong", "unsigned long long", "unsigned long long int", "uint64_t" },
+                { "float" },
+                { "double" }
+            };
+
+            for( const auto& names : synonyms )
+            {
+                for( const auto& name : names )
+                {
+                    if( name == type )
+                    {
+                        return names.front();
+                    }
+                }
+            }
+            return "";
+        }
+
+        /**
+         * Parse a NRRD header.
+         *
+         * \param text the header text. Might be followed by the data for attached headers.
+         * \param length the length of the text
+         * \param filename the file name. Used for error messages and relative data files.
+         * \param header the header to fill
+         *
+         * \return the offset of the first byte after the header
+         */
+        size_t parseNrrdHeader( const char* text, size_t length, const std::string& filename, NrrdHeader& header )
+        {
+            if( ( length < 4 ) || ( std::strncmp( text, "NRRD", 4 ) != 0 ) )
+            {
+                throw std::ios_base::failure( "File \"" + filename + "\" is not a NRRD file." );
+            }
+
+            bool hasDirections = false;
+            glm::dvec3 origin( 0.0 );
+            glm::dvec3 spacings( 1.0 );
+
+            // Skip the magic line and parse "field: value" lines until the first empty line
+            size_t pos = 0;
+            bool first = true;
+            while( pos < length )
+            {
+                const char* lineEnd = reinterpret_cast< const char* >( std::memchr( text + pos, '\n', length - pos ) );
+                size_t end = lineEnd ? ( lineEnd - text ) : length;
+                std::string line( text + pos, end - pos );
+                pos = end + 1;
+
+                if( !line.empty() && ( line.back() == '\r' ) )
+                {
+                    line.pop_back();
+                }
+
+                if( first )
+                {
+                    first = false;
+                    continue;
+                }
+
+                // The header ends with an empty line
+                if( line.empty() )
+                {
+                    break;
+                }
+
+                // Comments and key/value pairs
+                if( ( line[ 0 ] == '#' ) || ( line.find( ":=" ) != std::string::npos ) )
+                {
+                    continue;
+                }
+
+                auto separator = line.find( ": " );
+                if( separator == std::string::npos )
+                {
+                    throw std::ios_base::failure( "Invalid NRRD header line \"" + line + "\" in \"" + filename + "\"." );
+                }
+                auto field = di::core::toLower( line.substr( 0, separator ) );
+                auto value = di::core::trim( line.substr( separator + 2 ) );
+
+                if( field == "type" )
+                {
+                    header.type = normalizeNrrdType( di::core::toLower( value ) );
+                    if( header.type.empty() )
+                    {
+                        throw std::ios_base::failure( "Unsupported NRRD type \"" + value + "\" in \"" + filename + "\"." );
+                    }
+                }
+                else if( field == "dimension" )
+                {
+                    header.dimension = std::strtoul( value.c_str(), nullptr, 10 );
+                }
+                else if( field == "sizes" )
+                {
+                    std::istringstream sizes( value );
+                    sizes >> header.sizes[ 0 ] >> header.sizes[ 1 ] >> header.sizes[ 2 ];
+                }
+                else if( field == "endian" )
+                {
+                    header.bigEndian = ( di::core::toLower( value ) == "big" );
+                }
+                else if( field == "encoding" )
+                {
+                    header.encoding = di::core::toLower( value );
+                }
+                else if( ( field == "data file" ) || ( field == "datafile" ) )
+                {
+                    if( ( value.find( ' ' ) != std::string::npos ) || ( value.find( '%' ) != std::string::npos ) )
+                    {
+                        throw std::ios_base::failure( "Only single data files are supported in \"" + filename + "\"." );
+                    }
+                    header.dataFile = ( value[ 0 ] == '/' ) ? value : di::core::getFileDirectory( filename ) + value;
+                }
+                else if( ( field == "byte skip" ) || ( field == "byteskip" ) )
+                {
+                    header.byteSkip = std::strtol( value.c_str(), nullptr, 10 );
+                }
+                else if( ( field == "line skip" ) || ( field == "lineskip" ) )
+                {
+                    header.lineSkip = std::strtoul( value.c_str(), nullptr, 10 );
+                }
+                else if( field == "space directions" )
+                {
+                    // Three vectors, separated by spaces
+                    size_t vectorStart = 0;
+                    for( size_t axis = 0; axis < 3; ++axis )
+                    {
+                        vectorStart = value.find( '(', vectorStart );
+                        if( vectorStart == std::string::npos )
+                        {
+                            throw std::ios_base::failure( "Expected three space directions in \"" + filename + "\"." );
+                        }
+                        header.indexToWorld[ axis ] = glm::dvec4( parseNrrdVector( value.substr( vectorStart ) ), 0.0 );
+                        ++vectorStart;
+                    }
+                    hasDirections = true;
+                }
+                else if( field == "space origin" )
+                {
+                    origin = parseNrrdVector( value );
+                }
+                else if( field == "spacings" )
+                {
+                    std::istringstream values( value );
+                    values >> spacings.x >> spacings.y >> spacings.z;
+                }
+            }
+
+            // Without direction vectors, the spacing defines an axis-aligned grid
+            if( !hasDirections )
+            {
+                header.indexToWorld[ 0 ] = glm::dvec4( spacings.x, 0.0, 0.0, 0.0 );
+                header.indexToWorld[ 1 ] = glm::dvec4( 0.0, spacings.y, 0.0, 0.0 );
+                header.indexToWorld[ 2 ] = glm::dvec4( 0.0, 0.0, spacings.z, 0.0 );
+            }
+            header.indexToWorld[ 3 ] = glm::dvec4( origin, 1.0 );
+
+            return std::min( pos, length );
+        }
+
+        /**
+         * Size of a value of the given normalized NRRD type in bytes.
+         *
+         * \param type the type
+         *
+         * \return the size
+         */
+        size_t getNrrdTypeSize( const std::string& type )
+        {
+            if( ( type == "int8" ) || ( type == "uint8" ) )
+            {
+                return 1;
+            }
+            if( ( type == "int16" ) || ( type == "uint16" ) )
+            {
+                return 2;
+            }
+            if( ( type == "int32" ) || ( type == "uint32" ) || ( type == "float" ) )
+            {
+                return 4;
+            }
+            return 8;
+        }
+
+        /**
+         * Convert raw values to the target type.
+         *
+         * \tparam SourceType the type of the raw values
+         * \tparam TargetType the type to convert to
+         * \param source the raw values. Need not be aligned.
+         * \param target the target values
+         * \param count number of values
+         * \param swap if true, the byte order of each value is reversed before conversion
+         */
+        template< typename SourceType, typename TargetType >
+        void convertNrrdValues( const char* source, TargetType* target, size_t count, bool swap )
+        {
+            di::core::parallelFor( 0, count,
+                [ source, target, swap ]( size_t begin, size_t end, size_t )
+                {
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        SourceType value;
+                        std::memcpy( &value, source + i * sizeof( SourceType ), sizeof( SourceType ) );
+                        if( swap )
+                        {
+                            di::core::swapBytes( value );
+                        }
+                        target[ i ] = static_cast< TargetType >( value );
+                    }
+                }
+            );
+        }
+
+        /**
+         * Create a volume from the raw values in the data file. The values are used without copying if they are in native byte order and properly
+         * aligned.
+         *
+         * \tparam SourceType the type of the raw values
+         * \tparam ValueT the value type of the volume
+         * \param dataFile the mapped data file
+         * \param dataOffset the offset of the first value in the file
+         * \param count number of values
+         * \param swap if true, the byte order of each value needs to be reversed
+         * \param grid the grid of the volume
+         *
+         * \return the volume. Converted values are backed by a swap file if they exceed the memory budget, see \ref di::core::createVolumeArray.
+         */
+        template< typename SourceType, typename ValueT >
+        SPtr< di::core::DataSetBase > createNrrdVolume( SPtr< di::core::MappedFile > dataFile, size_t dataOffset, size_t count, bool swap,
+                                                        SPtr< di::core::GridRegular3 > grid )
+        {
+            SPtr< di::core::ValueArray< ValueT > > values;
+            if( std::is_same< SourceType, ValueT >::value && !swap && ( dataOffset % alignof( ValueT ) == 0 ) )
+            {
+                // Use the file contents as is.
+                values = std::make_shared< di::core::ValueArray< ValueT > >( dataFile, dataOffset, count );
+                LogD << "Using " << count << " values directly from \"" << dataFile->getFilename() << "\"." << LogEnd;
+            }
+            else
+            {
+                // Volumes larger than the memory budget are converted into a swap file.
+                values = di::core::createVolumeArray< ValueT >( count );
+                convertNrrdValues< SourceType >( dataFile->getData() + dataOffset, values->data(), count, swap );
+                LogD << "Converted " << count << " values from \"" << dataFile->getFilename() << "\"." << LogEnd;
+            }
+
+            return std::make_shared< di::core::DataSetScalarRegular3< ValueT > >( "Volume", grid, values );
+        }
+
+        di::SPtr< di::core::DataSetBase > NrrdReader::load( const std::string& filename ) const
+        {
+            LogD << "Loading \"" << filename << "\"." << LogEnd;
+
+            NrrdHeader header;
+            SPtr< di::core::MappedFile > dataFile;
+            size_t dataOffset = 0;
+
+            // Detached headers refer to a separate data file. Attached headers are parsed directly from the mapped file.
+            if( di::core::toLower( di::core::getFileExtension( filename ) ) == "nhdr" )
+            {
+                auto text = di::core::readTextFile( filename );
+                parseNrrdHeader( text.c_str(), text.size(), filename, header );
+                if( header.dataFile.empty() )
+                {
+                    throw std::ios_base::failure( "Detached NRRD header \"" + filename + "\" does not specify a data file." );
+                }
+                dataFile = std::make_shared< di::core::MappedFile >( header.dataFile );
+            }
+            else
+            {
+                dataFile = std::make_shared< di::core::MappedFile >( filename );
+                dataOffset = parseNrrdHeader( dataFile->getData(), dataFile->getSize(), filename, header );
+                if( !header.dataFile.empty() )
+                {
+                    dataFile = std::make_shared< di::core::MappedFile >( header.dataFile );
+                    dataOffset = 0;
+                }
+            }
+
+            if( header.dimension != 3 )
+            {
+                throw std::ios_base::failure( "Only 3D NRRD volumes are supported. \"" + filename + "\" has " +
+                                              std::to_string( header.dimension ) + " dimensions." );
+            }
+            if( header.type.empty() )
+            {
+                throw std::ios_base::failure( "NRRD file \"" + filename + "\" does not specify a type." );
+            }
+            if( header.encoding != "raw" )
+            {
+                throw std::ios_base::failure( "Unsupported NRRD encoding \"" + header.encoding + "\" in \"" + filename + "\"." );
+            }
+
+            size_t count = header.sizes[ 0 ] * header.sizes[ 1 ] * header.sizes[ 2 ];
+            size_t typeSize = getNrrdTypeSize( header.type );
+            size_t bytes = count * typeSize;
+
+            // Find the data inside the data file
+            for( size_t line = 0; line < header.lineSkip; ++line )
+            {
+                const char* data = dataFile->getData();
+                const void* lineEnd = std::memchr( data + dataOffset, '\n', dataFile->getSize() - dataOffset );
+                if( !lineEnd )
+                {
+                    throw std::ios_base::failure( "Cannot skip lines in \"" + dataFile->getFilename() + "\"." );
+                }
+                dataOffset = reinterpret_cast< const char* >( lineEnd ) - data + 1;
+            }
+            if( header.byteSkip < 0 )
+            {
+                dataOffset = ( dataFile->getSize() >= bytes ) ? dataFile->getSize() - bytes : dataFile->getSize();
+            }
+            else
+            {
+                dataOffset += static_cast< size_t >( header.byteSkip );
+            }
+            if( ( dataOffset > dataFile->getSize() ) || ( dataFile->getSize() - dataOffset < bytes ) )
+            {
+                throw std::ios_base::failure( "NRRD data file \"" + dataFile->getFilename() + "\" is too small." );
+            }
+
+            bool swap = ( typeSize > 1 ) && ( header.bigEndian == di::core::isLittleEndian() );
+
+            // GridTransformation maps world space to grid space
+            di::core::GridTransformation< 3 > transform( glm::mat4( glm::inverse( header.indexToWorld ) ) );
+            auto grid = std::make_shared< di::core::GridRegular3 >( transform, header.sizes[ 0 ], header.sizes[ 1 ], header.sizes[ 2 ] );
+
+            // Types supported by the volume algorithms are kept. All others are converted to double.
+            if( header.type == "uint8" )
+            {
+                return createNrrdVolume< uint8_t, uint8_t >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "uint16" )
+            {
+                return createNrrdVolume< uint16_t, uint16_t >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "float" )
+            {
+                return createNrrdVolume< float, float >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "double" )
+            {
+                return createNrrdVolume< double, double >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "int8" )
+            {
+                return createNrrdVolume< int8_t, double >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "int16" )
+            {
+                return createNrrdVolume< int16_t, double >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "int32" )
+            {
+                return createNrrdVolume< int32_t, double >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "uint32" )
+            {
+                return createNrrdVolume< uint32_t, double >( dataFile, dataOffset, count, swap, grid );
+            }
+            if( header.type == "int64" )
+            {
+                return createNrrdVolume< int64_t, double >( dataFile, dataOffset, count, swap, grid );
+            }
+            return createNrrdVolume< uint64_t, double >( dataFile, dataOffset, count, swap, grid );
+        }
+    }
+}
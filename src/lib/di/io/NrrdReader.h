@@ -0,0 +1,80 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_NRRDREADER_H
+#define DI_NRRDREADER_H
+
+#include <string>
+
+#include <di/core/Reader.h>
+#include <di/core/data/DataSetBase.h>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Implements a loader for NRRD volume files. It supports attached headers (.nrrd) and detached headers (.nhdr) referring to a raw data
+         * file. Volumes of type double, float, uint16 and uint8 are provided as \ref di::core::DataSetScalarRegular3 of the same value type. If the
+         * values are stored in native byte order, the data file is mapped into memory and used without copying. All other scalar types are
+         * converted to double while reading. It implements the \ref Reader interface.
+         */
+        class NrrdReader: public di::core::Reader
+        {
+        public:
+            /**
+             * Constructor;
+             */
+            NrrdReader();
+
+            /**
+             * Destructor.
+             */
+            virtual ~NrrdReader();
+
+            /**
+             * Check whether the specified file can be loaded.
+             *
+             * \param filename the file to load
+             *
+             * \return true if this implementation is able to load the data.
+             */
+            virtual bool canLoad( const std::string& filename ) const;
+
+            /**
+             * Load the specified file. This throws an exception if something went wrong.
+             *
+             * \param filename the file to load
+             *
+             * \return the data
+             */
+            virtual SPtr< di::core::DataSetBase > load( const std::string& filename ) const;
+        protected:
+        private:
+        };
+    }
+}
+
+#endif  // DI_NRRDREADER_H
+
@@ -0,0 +1,229 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ios>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <di/core/Endianness.h>
+#include <di/core/Filesystem.h>
+#include <di/core/StringUtils.h>
+#include <di/core/data/DataSetTypes.h>
+
+#include "NrrdWriter.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/NrrdWriter"
+
+namespace di
+{
+    namespace io
+    {
+        NrrdWriter::NrrdWriter():
+            Writer()
+        {
+        }
+
+        NrrdWriter::~NrrdWriter()
+        {
+        }
+
+        bool NrrdWriter::canWrite( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            std::string ext = di::core::toLower( di::core::getFileExtension( filename ) );
+            return ( ( ext == "nrrd" ) || ( ext == "nhdr" ) ) &&
+                   ( ( std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3d >( data ) != nullptr ) ||
+                     ( std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3f >( data ) != nullptr ) ||
+                     ( std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3u16 >( data ) != nullptr ) ||
+                     ( std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3u8 >( data ) != nullptr ) );
+        }
+
+        /**
+         * Format a vector the NRRD way: "(x,y,z)".
+         *
+         * \param v the vector
+         *
+         * \return the string
+         */
+        std::string formatNrrdVector( const glm::dvec3& v )
+        {
+            std::ostringstream result;
+            result << std::setprecision( std::numeric_limits< double >::max_digits10 ) << "(" << v.x << "," << v.y << "," << v.z << ")";
+            return result.str();
+        }
+
+        /**
+         * Write a volume of the given value type.
+         *
+         * \tparam ValueT the value type
+         * \param filename the file to write
+         * \param volume the volume
+         * \param type the NRRD name of the value type
+         */
+        template< typename ValueT >
+        void writeNrrdVolume( const std::string& filename, ConstSPtr< di::core::DataSetScalarRegular3< ValueT > > volume, const std::string& type )
+        {
+            LogD << "Writing \"" << filename << "\"." << LogEnd;
+
+            auto grid = volume->getGrid();
+            auto values = volume->template getAttributes< 0 >();
+
+            // The grid knows the world-to-grid transform. NRRD wants the grid-to-world axes.
+            auto indexToWorld = glm::inverse( grid->getTransformation().getMatrix() );
+            auto origin = glm::dvec3( indexToWorld[ 3 ] );
+            auto dirX = glm::dvec3( indexToWorld[ 0 ] );
+            auto dirY = glm::dvec3( indexToWorld[ 1 ] );
+            auto dirZ = glm::dvec3( indexToWorld[ 2 ] );
+
+            bool detached = ( di::core::toLower( di::core::getFileExtension( filename ) ) == "nhdr" );
+            std::string dataFilename = detached ? filename.substr( 0, filename.size() - 4 ) + "raw" : filename;
+
+            std::ostringstream text;
+            text << "NRRD0004" << "\n"
+                 << "# Written by DirectionalityIndicator" << "\n"
+                 << "type: " << type << "\n"
+                 << "dimension: 3" << "\n"
+                 << "space dimension: 3" << "\n"
+                 << "sizes: " << grid->getSizeX() << " " << grid->getSizeY() << " " << grid->getSizeZ() << "\n"
+                 << "space directions: " << formatNrrdVector( dirX ) << " " << formatNrrdVector( dirY ) << " " << formatNrrdVector( dirZ ) << "\n"
+                 << "space origin: " << formatNrrdVector( origin ) << "\n"
+                 << "endian: " << ( di::core::isLittleEndian() ? "little" : "big" ) << "\n"
+                 << "encoding: raw" << "\n";
+
+            if( detached )
+            {
+                // Relative to the header
+                auto directory = di::core::getFileDirectory( dataFilename );
+                text << "data file: " << dataFilename.substr( directory.size() ) << "\n";
+            }
+            else
+            {
+                // Pad the header with a comment. This way, the data is aligned and NrrdReader can map it without copying.
+                size_t headerSize = text.str().size() + 3;  // "#", line end and the final empty line
+                text << "#" << std::string( ( sizeof( ValueT ) - headerSize % sizeof( ValueT ) ) % sizeof( ValueT ), ' ' ) << "\n";
+            }
+            text << "\n";
+
+            // Write to temporary files and rename them when done. The targets might be mapped by the volume being written, as NrrdReader maps
+            // raw data. Truncating them in place would pull the data away under our feet.
+            std::string tempFilename = di::core::getTemporaryFilename( filename );
+            std::string tempDataFilename = detached ? di::core::getTemporaryFilename( dataFilename ) : tempFilename;
+            try
+            {
+                std::ofstream header( tempFilename, std::ios::out | std::ios::binary );
+                if( !header.good() )
+                {
+                    throw std::ios_base::failure( "Could not open \"" + tempFilename + "\" for writing." );
+                }
+                header << text.str();
+
+                std::ofstream detachedData;
+                if( detached )
+                {
+                    detachedData.open( tempDataFilename, std::ios::out | std::ios::binary );
+                    if( !detachedData.good() )
+                    {
+                        throw std::ios_base::failure( "Could not open \"" + tempDataFilename + "\" for writing." );
+                    }
+                }
+                std::ofstream& out = detached ? detachedData : header;
+
+                // Stream the values in large blocks. This avoids any intermediate copy.
+                const size_t blockSize = 16 * 1024 * 1024;
+                const char* bytes = reinterpret_cast< const char* >( values->data() );
+                size_t remaining = values->size() * sizeof( ValueT );
+                while( remaining > 0 )
+                {
+                    size_t block = std::min( remaining, blockSize );
+                    if( !out.write( bytes, block ) )
+                    {
+                        throw std::ios_base::failure( "Could not write \"" + dataFilename + "\"." );
+                    }
+                    bytes += block;
+                    remaining -= block;
+                }
+
+                header.close();
+                detachedData.close();
+                if( !header.good() || ( detached && !detachedData.good() ) )
+                {
+                    throw std::ios_base::failure( "Could not write \"" + filename + "\"." );
+                }
+
+                // The data first. The header refers to it.
+                if( detached && ( std::rename( tempDataFilename.c_str(), dataFilename.c_str() ) != 0 ) )
+                {
+                    throw std::ios_base::failure( "Could not replace \"" + dataFilename + "\"." );
+                }
+                if( std::rename( tempFilename.c_str(), filename.c_str() ) != 0 )
+                {
+                    throw std::ios_base::failure( "Could not replace \"" + filename + "\"." );
+                }
+            }
+            catch( ... )
+            {
+                std::remove( tempFilename.c_str() );
+                std::remove( tempDataFilename.c_str() );
+                throw;
+            }
+
+            LogD << "Wrote " << values->size() << " values to \"" << dataFilename << "\"." << LogEnd;
+        }
+
+        void NrrdWriter::write( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            auto volumeD = std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3d >( data );
+            auto volumeF = std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3f >( data );
+            auto volumeU16 = std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3u16 >( data );
+            auto volumeU8 = std::dynamic_pointer_cast< const di::core::DataSetScalarRegular3u8 >( data );
+            if( volumeD )
+            {
+                writeNrrdVolume< double >( filename, volumeD, "double" );
+            }
+            else if( volumeF )
+            {
+                writeNrrdVolume< float >( filename, volumeF, "float" );
+            }
+            else if( volumeU16 )
+            {
+                writeNrrdVolume< uint16_t >( filename, volumeU16, "uint16" );
+            }
+            else if( volumeU8 )
+            {
+                writeNrrdVolume< uint8_t >( filename, volumeU8, "uint8" );
+            }
+            else
+            {
+                throw std::invalid_argument( "NRRD writer only supports scalar volumes. Cannot write \"" + filename + "\"." );
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_NRRDWRITER_H
+#define DI_NRRDWRITER_H
+
+#include <string>
+
+#include <di/core/Writer.h>
+#include <di/core/data/DataSetBase.h>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Writes \ref di::core::DataSetScalarRegular3 volumes (double, float, uint16, uint8) as NRRD. Files ending with ".nhdr" get a detached header and a ".raw" data file next
+         * to it. All other files get an attached header. The values are written raw and native-endian, directly streamed from the dataset.
+         * The result can be loaded without copying by \ref NrrdReader. It implements the \ref Writer interface.
+         */
+        class NrrdWriter: public di::core::Writer
+        {
+        public:
+            /**
+             * Constructor;
+             */
+            NrrdWriter();
+
+            /**
+             * Destructor.
+             */
+            virtual ~NrrdWriter();
+
+            /**
+             * Check whether the specified data can be written to the given file.
+             *
+             * \param filename the file to write
+             * \param data the data to write
+             *
+             * \return true if this implementation is able to write the data.
+             */
+            virtual bool canWrite( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const;
+
+            /**
+             * Write the data to the specified file. This throws an exception if something went wrong.
+             *
+             * \param filename the file to write
+             * \param data the data to write
+             */
+            virtual void write( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const;
+        protected:
+        private:
+        };
+    }
+}
+
+#endif  // DI_NRRDWRITER_H
+
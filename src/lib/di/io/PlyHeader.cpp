@@ -0,0 +1,313 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <ios>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "PlyHeader.h"
+
+namespace di
+{
+    namespace io
+    {
+        bool PlyElement::hasLists() const
+        {
+            for( const auto& property : properties )
+            {
+                if( property.isList )
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        size_t PlyElement::getRecordSize() const
+        {
+            return getPropertyOffset( properties.size() );
+        }
+
+        int PlyElement::findProperty( const std::string& propertyName ) const
+        {
+            for( size_t i = 0; i < properties.size(); ++i )
+            {
+                if( properties[ i ].name == propertyName )
+                {
+                    return static_cast< int >( i );
+                }
+            }
+            return -1;
+        }
+
+        size_t PlyElement::getPropertyOffset( size_t index ) const
+        {
+            size_t offset = 0;
+            for( size_t i = 0; ( i < index ) && ( i < properties.size() ); ++i )
+            {
+                offset += getPlyTypeSize( properties[ i ].type );
+            }
+            return offset;
+        }
+
+        int PlyHeader::findElement( const std::string& elementName ) const
+        {
+            for( size_t i = 0; i < elements.size(); ++i )
+            {
+                if( elements[ i ].name == elementName )
+                {
+                    return static_cast< int >( i );
+                }
+            }
+            return -1;
+        }
+
+        PlyType parsePlyType( const std::string& name )
+        {
+            if( ( name == "char" ) || ( name == "int8" ) )
+            {
+                return PlyType::Int8;
+            }
+            if( ( name == "uchar" ) || ( name == "uint8" ) )
+            {
+                return PlyType::UInt8;
+            }
+            if( ( name == "short" ) || ( name == "int16" ) )
+            {
+                return PlyType::Int16;
+            }
+            if( ( name == "ushort" ) || ( name == "uint16" ) )
+            {
+                return PlyType::UInt16;
+            }
+            if( ( name == "int" ) || ( name == "int32" ) )
+            {
+                return PlyType::Int32;
+            }
+            if( ( name == "uint" ) || ( name == "uint32" ) )
+            {
+                return PlyType::UInt32;
+            }
+            if( ( name == "float" ) || ( name == "float32" ) )
+            {
+                return PlyType::Float32;
+            }
+            if( ( name == "double" ) || ( name == "float64" ) )
+            {
+                return PlyType::Float64;
+            }
+            throw std::ios_base::failure( "Unknown PLY type \"" + name + "\"." );
+        }
+
+        std::string getPlyTypeName( PlyType type )
+        {
+            switch( type )
+            {
+                case PlyType::Int8:
+                    return "char";
+                case PlyType::UInt8:
+                    return "uchar";
+                case PlyType::Int16:
+                    return "short";
+                case PlyType::UInt16:
+                    return "ushort";
+                case PlyType::Int32:
+                    return "int";
+                case PlyType::UInt32:
+                    return "uint";
+                case PlyType::Float32:
+                    return "float";
+                case PlyType::Float64:
+                default:
+                    return "double";
+            }
+        }
+
+        size_t getPlyTypeSize( PlyType type )
+        {
+            switch( type )
+            {
+                case PlyType::Int8:
+                case PlyType::UInt8:
+                    return 1;
+                case PlyType::Int16:
+                case PlyType::UInt16:
+                    return 2;
+                case PlyType::Int32:
+                case PlyType::UInt32:
+                case PlyType::Float32:
+                    return 4;
+                case PlyType::Float64:
+                default:
+                    return 8;
+            }
+        }
+
+        PlyHeader parsePlyHeader( const char* data, size_t size, const std::string& filename )
+        {
+            PlyHeader header;
+
+            size_t pos = 0;
+            bool first = true;
+            bool hasFormat = false;
+            while( pos < size )
+            {
+                const char* lineEnd = reinterpret_cast< const char* >( std::memchr( data + pos, '\n', size - pos ) );
+                if( !lineEnd )
+                {
+                    break;
+                }
+                std::string line( data + pos, lineEnd - ( data + pos ) );
+                pos = lineEnd - data + 1;
+                if( !line.empty() && ( line.back() == '\r' ) )
+                {
+                    line.pop_back();
+                }
+
+                std::istringstream tokens( line );
+                std::string keyword;
+                tokens >> keyword;
+
+                if( first )
+                {
+                    if( keyword != "ply" )
+                    {
+                        throw std::ios_base::failure( "File \"" + filename + "\" is not a PLY file." );
+                    }
+                    first = false;
+                    continue;
+                }
+
+                if( keyword == "end_header" )
+                {
+                    if( !hasFormat )
+                    {
+                        throw std::ios_base::failure( "PLY file \"" + filename + "\" does not specify a format." );
+                    }
+                    header.bodyOffset = pos;
+                    return header;
+                }
+                else if( keyword == "format" )
+                {
+                    std::string format;
+                    tokens >> format;
+                    if( format == "ascii" )
+                    {
+                        header.format = PlyFormat::Ascii;
+                    }
+                    else if( format == "binary_little_endian" )
+                    {
+                        header.format = PlyFormat::BinaryLittleEndian;
+                    }
+                    else if( format == "binary_big_endian" )
+                    {
+                        header.format = PlyFormat::BinaryBigEndian;
+                    }
+                    else
+                    {
+                        throw std::ios_base::failure( "Unknown PLY format \"" + format + "\" in \"" + filename + "\"." );
+                    }
+                    hasFormat = true;
+                }
+                else if( keyword == "element" )
+                {
+                    PlyElement element;
+                    tokens >> element.name >> element.count;
+                    if( tokens.fail() )
+                    {
+                        throw std::ios_base::failure( "Invalid PLY element \"" + line + "\" in \"" + filename + "\"." );
+                    }
+                    header.elements.push_back( element );
+                }
+                else if( keyword == "property" )
+                {
+                    if( header.elements.empty() )
+                    {
+                        throw std::ios_base::failure( "PLY property without element in \"" + filename + "\"." );
+                    }
+
+                    PlyProperty property;
+                    std::string type;
+                    tokens >> type;
+                    if( type == "list" )
+                    {
+                        std::string countType;
+                        tokens >> countType >> type;
+                        property.isList = true;
+                        property.countType = parsePlyType( countType );
+                    }
+                    property.type = parsePlyType( type );
+                    tokens >> property.name;
+                    if( tokens.fail() )
+                    {
+                        throw std::ios_base::failure( "Invalid PLY property \"" + line + "\" in \"" + filename + "\"." );
+                    }
+                    header.elements.back().properties.push_back( property );
+                }
+                // NOTE: comment and obj_info lines are ignored.
+            }
+
+            throw std::ios_base::failure( "PLY header of \"" + filename + "\" is incomplete." );
+        }
+
+        std::string formatPlyHeader( const PlyHeader& header, const std::string& comment )
+        {
+            std::ostringstream text;
+            text << "ply\n";
+            switch( header.format )
+            {
+                case PlyFormat::Ascii:
+                    text << "format ascii 1.0\n";
+                    break;
+                case PlyFormat::BinaryLittleEndian:
+                    text << "format binary_little_endian 1.0\n";
+                    break;
+                case PlyFormat::BinaryBigEndian:
+                    text << "format binary_big_endian 1.0\n";
+                    break;
+            }
+            if( !comment.empty() )
+            {
+                text << "comment " << comment << "\n";
+            }
+            for( const auto& element : header.elements )
+            {
+                text << "element " << element.name << " " << element.count << "\n";
+                for( const auto& property : element.properties )
+                {
+                    text << "property ";
+                    if( property.isList )
+                    {
+                        text << "list " << getPlyTypeName( property.countType ) << " ";
+                    }
+                    text << getPlyTypeName( property.type ) << " " << property.name << "\n";
+                }
+            }
+            text << "end_header\n";
+            return text.str();
+        }
+    }
+}
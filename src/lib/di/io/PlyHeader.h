@@ -0,0 +1,285 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+#ifndef DI_PLYHEADER_H
+#define DI_PLYHEADER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <di/core/Endianness.h>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * The scalar types allowed in PLY files.
+         */
+        enum class PlyType
+        {
+            Int8,    // char, int8
+            UInt8,   // uchar, uint8
+            Int16,   // short, int16
+            UInt16,  // ushort, uint16
+            Int32,   // int, int32
+            UInt32,  // uint, uint32
+            Float32, // float, float32
+            Float64  // double, float64
+        };
+
+        /**
+         * The storage formats of the PLY body.
+         */
+        enum class PlyFormat
+        {
+            Ascii,
+            BinaryLittleEndian,
+            BinaryBigEndian
+        };
+
+        /**
+         * A property of a PLY element.
+         */
+        struct PlyProperty
+        {
+            /**
+             * The name of the property.
+             */
+            std::string name;
+
+            /**
+             * The type of the value. For lists, the type of the list items.
+             */
+            PlyType type = PlyType::Float32;
+
+            /**
+             * True if this is a list property.
+             */
+            bool isList = false;
+
+            /**
+             * For lists, the type of the item count.
+             */
+            PlyType countType = PlyType::UInt8;
+        };
+
+        /**
+         * An element of a PLY file, like "vertex" or "face".
+         */
+        struct PlyElement
+        {
+            /**
+             * The name of the element.
+             */
+            std::string name;
+
+            /**
+             * The number of element records in the body.
+             */
+            size_t count = 0;
+
+            /**
+             * The properties of each record in order.
+             */
+            std::vector< PlyProperty > properties;
+
+            /**
+             * Check whether the element contains list properties. If not, each record has the same size in binary files.
+             *
+             * \return true if there is a list property.
+             */
+            bool hasLists() const;
+
+            /**
+             * Size of a record in binary files. Only valid if there are no lists.
+             *
+             * \return the size in bytes
+             */
+            size_t getRecordSize() const;
+
+            /**
+             * Find a property.
+             *
+             * \param propertyName the name of the property
+             *
+             * \return the index of the property or -1 if not found.
+             */
+            int findProperty( const std::string& propertyName ) const;
+
+            /**
+             * The byte offset of a property inside a binary record. Only valid if no list property precedes the property.
+             *
+             * \param index the index of the property
+             *
+             * \return the offset in bytes
+             */
+            size_t getPropertyOffset( size_t index ) const;
+        };
+
+        /**
+         * The parsed header of a PLY file.
+         */
+        struct PlyHeader
+        {
+            /**
+             * The format of the body.
+             */
+            PlyFormat format = PlyFormat::Ascii;
+
+            /**
+             * All elements in the order they appear in the body.
+             */
+            std::vector< PlyElement > elements;
+
+            /**
+             * The offset of the first byte after the header.
+             */
+            size_t bodyOffset = 0;
+
+            /**
+             * Find an element.
+             *
+             * \param elementName the name of the element
+             *
+             * \return the index of the element or -1 if not found.
+             */
+            int findElement( const std::string& elementName ) const;
+        };
+
+        /**
+         * Parse the header of a PLY file.
+         *
+         * \param data the file contents. Only the header part is read.
+         * \param size the size of the data
+         * \param filename the filename. Used for error messages.
+         *
+         * \throw std::ios_base::failure if the header is invalid.
+         *
+         * \return the header
+         */
+        PlyHeader parsePlyHeader( const char* data, size_t size, const std::string& filename );
+
+        /**
+         * Create the text of a PLY header. This is the counterpart of \ref parsePlyHeader. The body offset is ignored.
+         *
+         * \param header the header
+         * \param comment a comment line to add. Ignored if empty.
+         *
+         * \return the header text including the final "end_header" line.
+         */
+        std::string formatPlyHeader( const PlyHeader& header, const std::string& comment = "" );
+
+        /**
+         * Parse a PLY type name.
+         *
+         * \param name the type name like "float" or "uint8".
+         *
+         * \throw std::ios_base::failure if the name is unknown.
+         *
+         * \return the type
+         */
+        PlyType parsePlyType( const std::string& name );
+
+        /**
+         * The name of a PLY type as used in headers.
+         *
+         * \param type the type
+         *
+         * \return the name
+         */
+        std::string getPlyTypeName( PlyType type );
+
+        /**
+         * Size of a PLY type in binary files.
+         *
+         * \param type the type
+         *
+         * \return the size in bytes
+         */
+        size_t getPlyTypeSize( PlyType type );
+
+        /**
+         * Read a single binary value.
+         *
+         * \tparam SourceT the type of the raw value
+         * \param data the raw value. Need not be aligned.
+         * \param swap if true, the byte order is reversed
+         *
+         * \return the value
+         */
+        template< typename SourceT >
+        SourceT readPlyScalar( const char* data, bool swap )
+        {
+            // NOTE: memcpy handles unaligned data. Compilers turn it into a plain load.
+            SourceT value;
+            std::memcpy( &value, data, sizeof( SourceT ) );
+            if( swap )
+            {
+                core::swapBytes( value );
+            }
+            return value;
+        }
+
+        /**
+         * Read a single binary value of the given type and convert it.
+         *
+         * \tparam TargetT the type to convert to
+         * \param data the raw value. Need not be aligned.
+         * \param type the type of the raw value
+         * \param swap if true, the byte order is reversed before conversion
+         *
+         * \return the converted value
+         */
+        template< typename TargetT >
+        TargetT readPlyValue( const char* data, PlyType type, bool swap )
+        {
+            switch( type )
+            {
+                case PlyType::Int8:
+                    return static_cast< TargetT >( readPlyScalar< int8_t >( data, swap ) );
+                case PlyType::UInt8:
+                    return static_cast< TargetT >( readPlyScalar< uint8_t >( data, swap ) );
+                case PlyType::Int16:
+                    return static_cast< TargetT >( readPlyScalar< int16_t >( data, swap ) );
+                case PlyType::UInt16:
+                    return static_cast< TargetT >( readPlyScalar< uint16_t >( data, swap ) );
+                case PlyType::Int32:
+                    return static_cast< TargetT >( readPlyScalar< int32_t >( data, swap ) );
+                case PlyType::UInt32:
+                    return static_cast< TargetT >( readPlyScalar< uint32_t >( data, swap ) );
+                case PlyType::Float32:
+                    return static_cast< TargetT >( readPlyScalar< float >( data, swap ) );
+                case PlyType::Float64:
+                default:
+                    return static_cast< TargetT >( readPlyScalar< double >( data, swap ) );
+            }
+        }
+    }
+}
+
+#endif  // DI_PLYHEADER_H
+
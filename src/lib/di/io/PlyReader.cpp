@@ -24,19 +24,28 @@
 
 #include <iostream>
 #include <string>
-#include <clocale>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
 #include <functional>
 #include <chrono>
 #include <thread>
 
+#include <di/core/CompressedFile.h>
+#include <di/core/Endianness.h>
 #include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
+#include <di/core/Parallel.h>
 #include <di/core/StringUtils.h>
+#include <di/core/data/ColorPalette.h>
 #include <di/core/data/TriangleMesh.h>
 #include <di/core/data/TriangleDataSet.h>
 
 #include <di/ext/rply/rply.h>
 
+#include "MeshCache.h"
+#include "PlyHeader.h"
 #include "PlyReader.h"
 
 #include <di/core/Logger.h>
@@ -46,8 +55,11 @@ namespace di
 {
     namespace io
     {
-        PlyReader::PlyReader():
-            Reader()
+        PlyReader::PlyReader( bool analyzeColors, bool useCache, size_t previewTriangles ):
+            Reader(),
+            m_analyzeColors( analyzeColors ),
+            m_useCache( useCache ),
+            m_previewTriangles( previewTriangles )
         {
         }
 
@@ -57,10 +69,42 @@ namespace di
 
         bool PlyReader::canLoad( const std::string& filename ) const
         {
-            std::string ext = di::core::getFileExtension( filename );
+            std::string ext = di::core::getFileExtension( di::core::getUncompressedFilename( filename ) );
             return ( di::core::toLower( ext ) == "ply" );
         }
 
+        /**
+         * The state of a single rply load. Rply calls back for each value. The values of the current vertex, face and color are collected here
+         * until complete. Each load has its own context, so that multiple files can be loaded concurrently.
+         */
+        struct RplyLoadContext
+        {
+            /**
+             * The mesh to fill.
+             */
+            di::core::TriangleMesh* mesh = nullptr;
+
+            /**
+             * The colors to fill.
+             */
+            RGBAArray* colors = nullptr;
+
+            /**
+             * The vertex currently read.
+             */
+            glm::vec3 vertex = glm::vec3( 0.0, 0.0, 0.0 );
+
+            /**
+             * The face currently read.
+             */
+            glm::ivec3 face = glm::ivec3( 0, 0, 0 );
+
+            /**
+             * The color currently read.
+             */
+            glm::vec4 color = glm::vec4( 1.0, 0.0, 0.0, 1.0 );
+        };
+
         /**
          * Callback to handle rply vertices. Keep in mind that this is old-fashioned C code.
          *
@@ -72,22 +116,20 @@ namespace di
         {
             // Query the idata and pdata (user data allowed by rply)
             long index;
-            void* meshPlain = nullptr;
+            void* contextPlain = nullptr;
             // do query
-            ply_get_argument_user_data( argument, &meshPlain, &index );
+            ply_get_argument_user_data( argument, &contextPlain, &index );
 
-            // the pointer was a mesh
-            di::core::TriangleMesh* mesh = reinterpret_cast< di::core::TriangleMesh* >( meshPlain );
+            // the pointer was the load context
+            RplyLoadContext* context = reinterpret_cast< RplyLoadContext* >( contextPlain );
 
-            // always use this vector. Static variable.
-            static glm::vec3 vertex = { 0.0, 0.0, 0.0 };
-            // Store value there
-            vertex[ index ] = ply_get_argument_value( argument );
+            // Store value in the vertex of this load
+            context->vertex[ index ] = ply_get_argument_value( argument );
 
             // if this is the last index, add vertex
             if( index == 2 )
             {
-                mesh->addVertex( vertex );
+                context->mesh->addVertex( context->vertex );
             }
 
             return 1;
@@ -112,18 +154,16 @@ namespace di
             }
 
             // get the idata and pdata (user data allowed by rply)
-            void* meshPlain = nullptr;
+            void* contextPlain = nullptr;
             // query
-            ply_get_argument_user_data( argument, &meshPlain, NULL );
-            // the pointer was a mesh
-            di::core::TriangleMesh* mesh = reinterpret_cast< di::core::TriangleMesh* >( meshPlain );
+            ply_get_argument_user_data( argument, &contextPlain, NULL );
+            // the pointer was the load context
+            RplyLoadContext* context = reinterpret_cast< RplyLoadContext* >( contextPlain );
 
-            // always use this vector. Static variable.
-            static glm::ivec3 face = { 0, 0, 0 };
-            face[ index ] = ply_get_argument_value( argument );
+            context->face[ index ] = ply_get_argument_value( argument );
             if( index == 2 )
             {
-                mesh->addTriangle( face );
+                context->mesh->addTriangle( context->face );
             }
             return 1;
         }
@@ -140,41 +180,41 @@ namespace di
             // get the indices of this face
             long index;
             // get the idata and pdata (user data allowed by rply)
-            void* colorsPlain = nullptr;
+            void* contextPlain = nullptr;
             // query
-            ply_get_argument_user_data( argument, &colorsPlain, &index );
-            // the pointer was a color array
-            RGBAArray* colors = reinterpret_cast< RGBAArray* >( colorsPlain );
+            ply_get_argument_user_data( argument, &contextPlain, &index );
+            // the pointer was the load context
+            RplyLoadContext* context = reinterpret_cast< RplyLoadContext* >( contextPlain );
 
-            // always use this vector. Static variable.
-            static glm::vec4 color = { 1.0, 0.0, 0.0, 1.0 };
-            color[ index ] = ( 1.0 / 255.0 ) * ply_get_argument_value( argument );  // we normalize here
+            context->color[ index ] = ( 1.0 / 255.0 ) * ply_get_argument_value( argument );  // we normalize here
             if( index == 2 )
             {
                 // It is a std::vector
-                colors->push_back( color );
+                context->colors->push_back( context->color );
             }
             return 1;
         }
 
-        SPtr< di::core::DataSetBase > PlyReader::load( const std::string& filename ) const
+        /**
+         * Load the mesh using rply. This works with all kinds of binary PLY files, but is slow as rply calls back for each single value. Do not
+         * use it for ASCII files. Rply uses strtod, which depends on the current locale.
+         *
+         * \param filename the file to load
+         * \param mesh the mesh to fill
+         * \param colors the colors to fill
+         * \param numVertices the number of vertices according to the header
+         * \param numTriangles the number of faces according to the header
+         */
+        void loadPlyWithRply( const std::string& filename, di::core::TriangleMesh* mesh, RGBAArray* colors, long& numVertices, long& numTriangles )
         {
-            // Use C style numeric locale to ensure that all loaders work properly.
-            // Keep old locale
-            const char* oldLocale = setlocale( LC_NUMERIC, NULL );
-            setlocale( LC_NUMERIC, "C" );
-
-            LogD << "Loading \"" << filename << "\"." << LogEnd;
-
-            // store the mesh and a color array:
-            SPtr< di::core::TriangleMesh > mesh( new di::core::TriangleMesh() );
-            SPtr< RGBAArray > colors( new RGBAArray() );
-
             // to actually do the parsing, we use rply. It works with ASCII and binary PLY files.
             // ref: http://w3.impa.br/~diego/software/rply/
-            long numVertices;
             long numColors;
-            long numTriangles;
+
+            // The callbacks collect the values in here.
+            RplyLoadContext context;
+            context.mesh = mesh;
+            context.colors = colors;
 
             // open the file
             p_ply ply = ply_open( filename.c_str(), NULL, 0, NULL );
@@ -192,17 +232,17 @@ namespace di
             }
 
             // load vertices using these callbacks:
-            numVertices = ply_set_read_cb( ply, "vertex", "x", vertexCallback, mesh.get(), 0 );
-                          ply_set_read_cb( ply, "vertex", "y", vertexCallback, mesh.get(), 1 );
-                          ply_set_read_cb( ply, "vertex", "z", vertexCallback, mesh.get(), 2 );
+            numVertices = ply_set_read_cb( ply, "vertex", "x", vertexCallback, &context, 0 );
+                          ply_set_read_cb( ply, "vertex", "y", vertexCallback, &context, 1 );
+                          ply_set_read_cb( ply, "vertex", "z", vertexCallback, &context, 2 );
 
             // also load colors
-            numColors = ply_set_read_cb( ply, "vertex", "red", colorCallback, colors.get(), 0 );
-                        ply_set_read_cb( ply, "vertex", "green", colorCallback, colors.get(), 1 );
-                        ply_set_read_cb( ply, "vertex", "blue", colorCallback, colors.get(), 2 );
+            numColors = ply_set_read_cb( ply, "vertex", "red", colorCallback, &context, 0 );
+                        ply_set_read_cb( ply, "vertex", "green", colorCallback, &context, 1 );
+                        ply_set_read_cb( ply, "vertex", "blue", colorCallback, &context, 2 );
 
             // finally, read face indices
-            numTriangles = ply_set_read_cb( ply, "face", "vertex_index", faceCallback, mesh.get(), 0 );
+            numTriangles = ply_set_read_cb( ply, "face", "vertex_index", faceCallback, &context, 0 );
 
             LogD << "Going to load " << numTriangles << " triangles with " << numVertices << " vertices and " << numColors << " colors." << LogEnd;
 
@@ -215,6 +255,685 @@ namespace di
 
             // done. Close the file.
             ply_close( ply );
+        }
+
+        /**
+         * Check that the triangles in [first, last) reference existing vertices. Broken indices would make the mesh unusable.
+         *
+         * \param triangles the triangles to check
+         * \param first the first triangle to check
+         * \param last the triangle after the last one to check
+         * \param numVertices the number of vertices
+         * \param filename the file. Used for error messages.
+         *
+         * \throw std::ios_base::failure if there is an invalid index.
+         */
+        void validateTriangles( const IndexVec3Array& triangles, size_t first, size_t last, size_t numVertices, const std::string& filename )
+        {
+            if( !di::core::checkTriangleIndices( triangles, numVertices, first, last ) )
+            {
+                LogE << "PLY file \"" << filename << "\" contains invalid vertex indices." << LogEnd;
+                throw std::ios_base::failure( "PLY file \"" + filename + "\" contains invalid vertex indices." );
+            }
+        }
+
+
+        /**
+         * Check that all triangles reference existing vertices.
+         *
+         * \param triangles the triangles to check
+         * \param numVertices the number of vertices
+         * \param filename the file. Used for error messages.
+         *
+         * \throw std::ios_base::failure if there is an invalid index.
+         */
+        void validateTriangles( const IndexVec3Array& triangles, size_t numVertices, const std::string& filename )
+        {
+            validateTriangles( triangles, 0, triangles.size(), numVertices, filename );
+        }
+
+        /**
+         * Check whether a block of records lies within the file. Overflow-safe, as the counts come from the header.
+         *
+         * \param offset the start of the block
+         * \param count the number of records
+         * \param recordSize the size of a record
+         * \param fileSize the size of the file
+         *
+         * \return true if offset + count * recordSize <= fileSize.
+         */
+        bool fitsPlyBlock( size_t offset, size_t count, size_t recordSize, size_t fileSize )
+        {
+            return ( offset <= fileSize ) && ( ( recordSize == 0 ) || ( count <= ( fileSize - offset ) / recordSize ) );
+        }
+
+        /**
+         * Parse the next value of an ASCII PLY record.
+         *
+         * \param pos the position to start at
+         * \param end the end of the data
+         * \param singleLine if false, line breaks are skipped. If true, a line break ends the record and there is no value.
+         * \param value the parsed value
+         *
+         * \return the position after the value or nullptr if there is no valid value.
+         */
+        const char* parseAsciiPlyValue( const char* pos, const char* end, bool singleLine, double& value )
+        {
+            if( !singleLine )
+            {
+                while( ( pos < end ) && std::isspace( static_cast< unsigned char >( *pos ) ) )
+                {
+                    ++pos;
+                }
+            }
+            return di::core::parseNumber( pos, end, value );
+        }
+
+        /**
+         * Parse an ASCII PLY record.
+         *
+         * \tparam FunctionType something callable as func( size_t propertyIndex, size_t itemIndex, double value ). For non-list properties,
+         * the item index is always 0.
+         * \param pos the start of the record
+         * \param end the end of the data
+         * \param element the element this record belongs to
+         * \param singleLine if true, the record must not span multiple lines.
+         * \param func called for each value
+         *
+         * \return the position after the record or nullptr if the record is invalid.
+         */
+        template< typename FunctionType >
+        const char* parseAsciiPlyRecord( const char* pos, const char* end, const PlyElement& element, bool singleLine, FunctionType func )
+        {
+            double value = 0.0;
+            for( size_t property = 0; property < element.properties.size(); ++property )
+            {
+                size_t count = 1;
+                if( element.properties[ property ].isList )
+                {
+                    pos = parseAsciiPlyValue( pos, end, singleLine, value );
+                    if( !pos || ( value < 0.0 ) )
+                    {
+                        return nullptr;
+                    }
+                    count = static_cast< size_t >( value );
+                }
+
+                for( size_t item = 0; item < count; ++item )
+                {
+                    pos = parseAsciiPlyValue( pos, end, singleLine, value );
+                    if( !pos )
+                    {
+                        return nullptr;
+                    }
+                    func( property, item, value );
+                }
+            }
+            return pos;
+        }
+
+        /**
+         * Load an ASCII PLY file directly from memory. Usually, each record is on its own line. The body is split into line-aligned chunks, which
+         * are parsed in parallel into preallocated arrays. If records do not match lines, the body is parsed sequentially. Numbers are parsed
+         * independent of the current locale.
+         *
+         * \param file the mapped file
+         * \param header the parsed header
+         * \param mesh the mesh to fill
+         * \param colors the colors to fill
+         *
+         * \throw std::ios_base::failure if the file is invalid.
+         */
+        void loadAsciiPly( const di::core::MappedFile& file, const PlyHeader& header, di::core::TriangleMesh* mesh, RGBAArray* colors )
+        {
+            int vertexElement = header.findElement( "vertex" );
+            int faceElement = header.findElement( "face" );
+            if( vertexElement < 0 )
+            {
+                LogE << "PLY file \"" << file.getFilename() << "\" does not contain vertices." << LogEnd;
+                throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" does not contain vertices." );
+            }
+
+            const auto& vertices = header.elements[ vertexElement ];
+            int x = vertices.findProperty( "x" );
+            int y = vertices.findProperty( "y" );
+            int z = vertices.findProperty( "z" );
+            int red = vertices.findProperty( "red" );
+            int green = vertices.findProperty( "green" );
+            int blue = vertices.findProperty( "blue" );
+            bool hasColors = ( red >= 0 ) && ( green >= 0 ) && ( blue >= 0 );
+            if( ( x < 0 ) || ( y < 0 ) || ( z < 0 ) )
+            {
+                LogE << "PLY file \"" << file.getFilename() << "\" does not contain vertex positions." << LogEnd;
+                throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" does not contain vertex positions." );
+            }
+
+            // A file without faces is a valid but empty mesh.
+            int indices = -1;
+            size_t numFaces = 0;
+            if( faceElement >= 0 )
+            {
+                const auto& faces = header.elements[ faceElement ];
+                indices = faces.findProperty( "vertex_index" );
+                indices = ( indices < 0 ) ? faces.findProperty( "vertex_indices" ) : indices;
+                numFaces = ( indices < 0 ) ? 0 : faces.count;
+            }
+
+            // Records are numbered over all elements in file order. Find the ranges of vertices and faces.
+            size_t vertexBegin = 0;
+            size_t faceBegin = 0;
+            size_t firstRecord = 0;
+            for( size_t i = 0; i < header.elements.size(); ++i )
+            {
+                vertexBegin = ( static_cast< int >( i ) == vertexElement ) ? firstRecord : vertexBegin;
+                faceBegin = ( static_cast< int >( i ) == faceElement ) ? firstRecord : faceBegin;
+                firstRecord += header.elements[ i ].count;
+            }
+            size_t vertexEnd = vertexBegin + vertices.count;
+            size_t faceEnd = faceBegin + numFaces;
+            size_t numRecords = std::max( vertexEnd, faceEnd );
+
+            Vec3Array vertexArray( vertices.count );
+            IndexVec3Array triangleArray( numFaces );
+            if( hasColors )
+            {
+                colors->resize( vertices.count );
+            }
+
+            // Parse the given record into the arrays.
+            auto parseRecord = [ & ]( const char* pos, const char* end, size_t record, bool singleLine ) -> const char*
+            {
+                if( ( record >= vertexBegin ) && ( record < vertexEnd ) )
+                {
+                    glm::vec3 vertex( 0.0 );
+                    glm::vec4 color( 0.0, 0.0, 0.0, 1.0 );
+                    pos = parseAsciiPlyRecord( pos, end, vertices, singleLine,
+                        [ & ]( size_t property, size_t, double value )
+                        {
+                            int p = static_cast< int >( property );
+                            vertex.x = ( p == x ) ? value : vertex.x;
+                            vertex.y = ( p == y ) ? value : vertex.y;
+                            vertex.z = ( p == z ) ? value : vertex.z;
+                            // we normalize here
+                            color.r = ( p == red ) ? ( 1.0 / 255.0 ) * value : color.r;
+                            color.g = ( p == green ) ? ( 1.0 / 255.0 ) * value : color.g;
+                            color.b = ( p == blue ) ? ( 1.0 / 255.0 ) * value : color.b;
+                        }
+                    );
+                    vertexArray[ record - vertexBegin ] = vertex;
+                    if( hasColors )
+                    {
+                        ( *colors )[ record - vertexBegin ] = color;
+                    }
+                    return pos;
+                }
+
+                if( ( record >= faceBegin ) && ( record < faceEnd ) )
+                {
+                    // Like the rply callbacks, use the first three indices of each face.
+                    glm::ivec3 triangle( 0 );
+                    size_t numIndices = 0;
+                    pos = parseAsciiPlyRecord( pos, end, header.elements[ faceElement ], singleLine,
+                        [ & ]( size_t property, size_t item, double value )
+                        {
+                            if( ( static_cast< int >( property ) == indices ) )
+                            {
+                                numIndices = item + 1;
+                                if( item < 3 )
+                                {
+                                    triangle[ item ] = static_cast< int >( value );
+                                }
+                            }
+                        }
+                    );
+                    // In single line mode, this might be caused by records spanning multiple lines. Let the caller retry.
+                    if( singleLine && ( numIndices < 3 ) )
+                    {
+                        return nullptr;
+                    }
+                    if( pos && ( numIndices < 3 ) )
+                    {
+                        throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" contains faces with less than three vertices." );
+                    }
+                    triangleArray[ record - faceBegin ] = triangle;
+                    return pos;
+                }
+
+                // Some other element. Skip.
+                const PlyElement* element = &header.elements.back();
+                size_t elementRecord = 0;
+                for( const auto& candidate : header.elements )
+                {
+                    if( record < elementRecord + candidate.count )
+                    {
+                        element = &candidate;
+                        break;
+                    }
+                    elementRecord += candidate.count;
+                }
+                return parseAsciiPlyRecord( pos, end, *element, singleLine, []( size_t, size_t, double ) {} );
+            };
+
+            const char* body = file.getData() + header.bodyOffset;
+            const char* end = file.getData() + file.getSize();
+            size_t bodySize = end - body;
+
+            // Split into line-aligned chunks. Use some more chunks than threads as lines differ in length. The threads take the chunks one by
+            // one until none are left. This balances the load without starting more threads than cores.
+            size_t numChunks = std::max( static_cast< size_t >( 1 ), std::min( 4 * di::core::getNumberOfThreads(), bodySize / ( 64 * 1024 ) ) );
+            std::vector< const char* > chunkBegin( numChunks + 1, end );
+            chunkBegin[ 0 ] = body;
+            for( size_t chunk = 1; chunk < numChunks; ++chunk )
+            {
+                const char* pos = std::max( chunkBegin[ chunk - 1 ], body + ( chunk * bodySize ) / numChunks );
+                const char* lineEnd = static_cast< const char* >( std::memchr( pos, '\n', end - pos ) );
+                chunkBegin[ chunk ] = lineEnd ? ( lineEnd + 1 ) : end;
+            }
+
+            size_t numThreads = std::min( numChunks, di::core::getNumberOfThreads() );
+            auto forEachChunk = [ numChunks, numThreads ]( std::function< void( size_t ) > func )
+            {
+                std::atomic< size_t > nextChunk( 0 );
+                di::core::parallelFor( 0, numThreads,
+                    [ & ]( size_t, size_t, size_t )
+                    {
+                        for( size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++ )
+                        {
+                            func( chunk );
+                        }
+                    },
+                    numThreads
+                );
+            };
+
+            // The record index of the first line in each chunk
+            std::vector< size_t > chunkFirstLine( numChunks + 1, 0 );
+            forEachChunk(
+                [ & ]( size_t chunk )
+                {
+                    chunkFirstLine[ chunk + 1 ] = std::count( chunkBegin[ chunk ], chunkBegin[ chunk + 1 ], '\n' );
+                }
+            );
+            for( size_t chunk = 0; chunk < numChunks; ++chunk )
+            {
+                chunkFirstLine[ chunk + 1 ] += chunkFirstLine[ chunk ];
+            }
+            size_t numLines = chunkFirstLine[ numChunks ] + ( ( ( bodySize > 0 ) && ( end[ -1 ] != '\n' ) ) ? 1 : 0 );
+
+            std::atomic< bool > lineBased( numLines >= numRecords );
+            if( lineBased )
+            {
+                forEachChunk(
+                    [ & ]( size_t chunk )
+                    {
+                        const char* pos = chunkBegin[ chunk ];
+                        const char* chunkEnd = chunkBegin[ chunk + 1 ];
+                        for( size_t record = chunkFirstLine[ chunk ]; ( pos < chunkEnd ) && ( record < numRecords ) && lineBased; ++record )
+                        {
+                            pos = parseRecord( pos, chunkEnd, record, true );
+                            while( pos && ( pos < chunkEnd ) && ( ( *pos == ' ' ) || ( *pos == '\t' ) || ( *pos == '\r' ) ) )
+                            {
+                                ++pos;
+                            }
+                            if( !pos || ( ( pos < chunkEnd ) && ( *pos != '\n' ) ) )
+                            {
+                                lineBased = false;
+                                return;
+                            }
+                            ++pos;
+                        }
+                    }
+                );
+            }
+
+            if( !lineBased )
+            {
+                LogD << "Records in \"" << file.getFilename() << "\" do not match lines. Parsing sequentially." << LogEnd;
+                const char* pos = body;
+                for( size_t record = 0; record < numRecords; ++record )
+                {
+                    pos = parseRecord( pos, end, record, false );
+                    if( !pos )
+                    {
+                        LogE << "Failed to read PLY file " << file.getFilename() << LogEnd;
+                        throw std::ios_base::failure( "Failed to read PLY file " + file.getFilename() );
+                    }
+                }
+            }
+
+            validateTriangles( triangleArray, vertices.count, file.getFilename() );
+            mesh->setVertices( std::move( vertexArray ) );
+            mesh->setTriangles( std::move( triangleArray ) );
+        }
+
+        /**
+         * Load a binary PLY file directly from memory. This requires the usual layout: a "vertex" element with scalar properties followed by a
+         * "face" element with a "vertex_index" list. Only elements without lists may precede the face element. Vertices and colors are
+         * converted in parallel into preallocated arrays. If all faces are triangles, faces are converted in parallel too.
+         *
+         * \param file the mapped file
+         * \param header the parsed header
+         * \param mesh the mesh to fill
+         * \param colors the colors to fill
+         * \param previewTriangles if not 0, faces are converted in batches of this size and the preview function is called after each but the
+         * last batch. Only done if all faces are triangles.
+         * \param preview called with the vertices, the triangle array and the number of valid triangles in it. Colors are complete at this point.
+         *
+         * \return false if the layout is not supported. Use rply then.
+         */
+        bool loadBinaryPly( const di::core::MappedFile& file, const PlyHeader& header, di::core::TriangleMesh* mesh, RGBAArray* colors,
+                            size_t previewTriangles = 0,
+                            std::function< void( const Vec3Array&, const IndexVec3Array&, size_t ) > preview = nullptr )
+        {
+            int vertexElement = header.findElement( "vertex" );
+            int faceElement = header.findElement( "face" );
+            if( ( header.format == PlyFormat::Ascii ) || ( vertexElement < 0 ) || ( faceElement < vertexElement ) )
+            {
+                return false;
+            }
+
+            // Find the start of the vertex and face data. Only possible if all elements in front have a fixed size.
+            size_t vertexStart = header.bodyOffset;
+            size_t faceStart = header.bodyOffset;
+            for( int i = 0; i < faceElement; ++i )
+            {
+                const auto& element = header.elements[ i ];
+                if( element.hasLists() )
+                {
+                    return false;
+                }
+                if( !fitsPlyBlock( faceStart, element.count, element.getRecordSize(), file.getSize() ) )
+                {
+                    throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" is truncated." );
+                }
+                if( i < vertexElement )
+                {
+                    vertexStart += element.count * element.getRecordSize();
+                }
+                faceStart += element.count * element.getRecordSize();
+            }
+
+            const auto& vertices = header.elements[ vertexElement ];
+            const auto& faces = header.elements[ faceElement ];
+            int x = vertices.findProperty( "x" );
+            int y = vertices.findProperty( "y" );
+            int z = vertices.findProperty( "z" );
+            int red = vertices.findProperty( "red" );
+            int green = vertices.findProperty( "green" );
+            int blue = vertices.findProperty( "blue" );
+            int indices = faces.findProperty( "vertex_index" );
+            indices = ( indices < 0 ) ? faces.findProperty( "vertex_indices" ) : indices;
+            if( ( x < 0 ) || ( y < 0 ) || ( z < 0 ) || ( indices < 0 ) || !faces.properties[ indices ].isList )
+            {
+                return false;
+            }
+
+            // The face record: fixed-size scalars, the index list, fixed-size scalars
+            size_t faceListOffset = faces.getPropertyOffset( indices );
+            size_t faceTailSize = 0;
+            for( size_t i = indices + 1; i < faces.properties.size(); ++i )
+            {
+                if( faces.properties[ i ].isList )
+                {
+                    return false;
+                }
+                faceTailSize += getPlyTypeSize( faces.properties[ i ].type );
+            }
+            for( int i = 0; i < indices; ++i )
+            {
+                if( faces.properties[ i ].isList )
+                {
+                    return false;
+                }
+            }
+
+            // All elements in front of the faces were checked to be within the file.
+            size_t vertexSize = vertices.getRecordSize();
+
+            bool swap = ( header.format == PlyFormat::BinaryLittleEndian ) != di::core::isLittleEndian();
+            const char* data = file.getData();
+
+            // Vertices
+            Vec3Array vertexArray( vertices.count );
+            PlyType typeX = vertices.properties[ x ].type;
+            size_t offsetX = vertices.getPropertyOffset( x );
+            size_t offsetY = vertices.getPropertyOffset( y );
+            size_t offsetZ = vertices.getPropertyOffset( z );
+            if( !swap && ( vertexSize == sizeof( glm::vec3 ) ) && ( typeX == PlyType::Float32 ) && ( offsetX == 0 ) && ( offsetY == 4 ) &&
+                ( offsetZ == 8 ) )
+            {
+                // The block is exactly our vertex array.
+                std::memcpy( vertexArray.data(), data + vertexStart, vertices.count * vertexSize );
+            }
+            else
+            {
+                PlyType typeY = vertices.properties[ y ].type;
+                PlyType typeZ = vertices.properties[ z ].type;
+                di::core::parallelFor( 0, vertices.count,
+                    [ & ]( size_t begin, size_t end, size_t )
+                    {
+                        for( size_t i = begin; i < end; ++i )
+                        {
+                            const char* record = data + vertexStart + i * vertexSize;
+                            vertexArray[ i ] = glm::vec3( readPlyValue< float >( record + offsetX, typeX, swap ),
+                                                          readPlyValue< float >( record + offsetY, typeY, swap ),
+                                                          readPlyValue< float >( record + offsetZ, typeZ, swap ) );
+                        }
+                    }
+                );
+            }
+
+            // Colors
+            if( ( red >= 0 ) && ( green >= 0 ) && ( blue >= 0 ) )
+            {
+                colors->resize( vertices.count );
+                PlyType typeR = vertices.properties[ red ].type;
+                PlyType typeG = vertices.properties[ green ].type;
+                PlyType typeB = vertices.properties[ blue ].type;
+                size_t offsetR = vertices.getPropertyOffset( red );
+                size_t offsetG = vertices.getPropertyOffset( green );
+                size_t offsetB = vertices.getPropertyOffset( blue );
+                di::core::parallelFor( 0, vertices.count,
+                    [ & ]( size_t begin, size_t end, size_t )
+                    {
+                        for( size_t i = begin; i < end; ++i )
+                        {
+                            const char* record = data + vertexStart + i * vertexSize;
+                            // we normalize here
+                            ( *colors )[ i ] = glm::vec4( ( 1.0 / 255.0 ) * readPlyValue< double >( record + offsetR, typeR, swap ),
+                                                          ( 1.0 / 255.0 ) * readPlyValue< double >( record + offsetG, typeG, swap ),
+                                                          ( 1.0 / 255.0 ) * readPlyValue< double >( record + offsetB, typeB, swap ),
+                                                          1.0 );
+                        }
+                    }
+                );
+            }
+
+            // Faces. Usually, all of them are triangles. Then, each record has the same size.
+            PlyType countType = faces.properties[ indices ].countType;
+            PlyType indexType = faces.properties[ indices ].type;
+            size_t countSize = getPlyTypeSize( countType );
+            size_t indexSize = getPlyTypeSize( indexType );
+            size_t triangleSize = faceListOffset + countSize + 3 * indexSize + faceTailSize;
+
+            // Even without indices, each face needs some bytes. This bounds the face count by the file size.
+            if( !fitsPlyBlock( faceStart, faces.count, faceListOffset + countSize + faceTailSize, file.getSize() ) )
+            {
+                throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" is truncated." );
+            }
+
+            std::atomic< bool > onlyTriangles( fitsPlyBlock( faceStart, faces.count, triangleSize, file.getSize() ) );
+            IndexVec3Array triangleArray( onlyTriangles ? faces.count : 0 );
+            size_t batchSize = ( preview && ( previewTriangles > 0 ) ) ? previewTriangles : std::max( faces.count, static_cast< size_t >( 1 ) );
+            for( size_t batchBegin = 0; ( batchBegin < faces.count ) && onlyTriangles; batchBegin += batchSize )
+            {
+                size_t batchEnd = std::min( faces.count, batchBegin + batchSize );
+                di::core::parallelFor( batchBegin, batchEnd,
+                    [ & ]( size_t begin, size_t end, size_t )
+                    {
+                        for( size_t i = begin; ( i < end ) && onlyTriangles; ++i )
+                        {
+                            const char* list = data + faceStart + i * triangleSize + faceListOffset;
+                            if( readPlyValue< double >( list, countType, swap ) != 3.0 )
+                            {
+                                onlyTriangles = false;
+                                return;
+                            }
+                            list += countSize;
+                            triangleArray[ i ] = glm::ivec3( readPlyValue< int >( list, indexType, swap ),
+                                                             readPlyValue< int >( list + indexSize, indexType, swap ),
+                                                             readPlyValue< int >( list + 2 * indexSize, indexType, swap ) );
+                        }
+                    }
+                );
+                if( !onlyTriangles )
+                {
+                    break;
+                }
+
+                validateTriangles( triangleArray, batchBegin, batchEnd, vertices.count, file.getFilename() );
+                if( preview && ( batchEnd < faces.count ) )
+                {
+                    preview( vertexArray, triangleArray, batchEnd );
+                }
+            }
+
+            if( !onlyTriangles )
+            {
+                // Walk the records one by one. Like the rply callbacks, use the first three indices of each face.
+                triangleArray.clear();
+                size_t pos = faceStart;
+                for( size_t i = 0; i < faces.count; ++i )
+                {
+                    if( pos + faceListOffset + countSize > file.getSize() )
+                    {
+                        throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" is truncated." );
+                    }
+                    const char* list = data + pos + faceListOffset;
+                    pos += faceListOffset + countSize;
+
+                    // Negative or absurd counts would let the position wrap around. Read signed and check against the remaining bytes.
+                    double rawCount = readPlyValue< double >( list, countType, swap );
+                    if( !( rawCount >= 0.0 ) || ( rawCount > static_cast< double >( ( file.getSize() - pos ) / indexSize ) ) )
+                    {
+                        throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" is truncated or has an invalid face." );
+                    }
+                    size_t count = static_cast< size_t >( rawCount );
+                    pos += count * indexSize;
+                    if( !fitsPlyBlock( pos, 1, faceTailSize, file.getSize() ) )
+                    {
+                        throw std::ios_base::failure( "PLY file \"" + file.getFilename() + "\" is truncated." );
+                    }
+                    pos += faceTailSize;
+
+                    if( count >= 3 )
+                    {
+                        list += countSize;
+                        triangleArray.push_back( glm::ivec3( readPlyValue< int >( list, indexType, swap ),
+                                                             readPlyValue< int >( list + indexSize, indexType, swap ),
+                                                             readPlyValue< int >( list + 2 * indexSize, indexType, swap ) ) );
+                    }
+                }
+                validateTriangles( triangleArray, vertices.count, file.getFilename() );
+            }
+
+            mesh->setVertices( std::move( vertexArray ) );
+            mesh->setTriangles( std::move( triangleArray ) );
+            return true;
+        }
+
+        SPtr< di::core::DataSetBase > PlyReader::load( const std::string& filename ) const
+        {
+            return loadProgressive( filename, PreviewCallback() );
+        }
+
+        SPtr< di::core::DataSetBase > PlyReader::loadProgressive( const std::string& filename, PreviewCallback preview ) const
+        {
+            LogD << "Loading \"" << filename << "\"." << LogEnd;
+
+            // A valid cache is much faster than any PLY file. A broken one is not a reason to fail.
+            std::string cacheFilename = getMeshCacheFilename( filename );
+            uint64_t cacheSize = 0;
+            int64_t cacheModificationTime = 0;
+            if( m_useCache && di::core::getFileInfo( cacheFilename, cacheSize, cacheModificationTime ) )
+            {
+                try
+                {
+                    auto cached = readMeshCache( cacheFilename, filename, filename );
+                    if( cached )
+                    {
+                        return cached;
+                    }
+                }
+                catch( const std::exception& e )
+                {
+                    LogW << "Ignoring mesh cache \"" << cacheFilename << "\": " << e.what() << LogEnd;
+                }
+            }
+
+            // store the mesh and a color array:
+            SPtr< di::core::TriangleMesh > mesh( new di::core::TriangleMesh() );
+            SPtr< RGBAArray > colors( new RGBAArray() );
+
+            long numVertices;
+            long numTriangles;
+
+            // Files are parsed directly from memory. Only binary files with unusual layouts go through rply.
+            SPtr< di::core::MappedFile > file;
+            try
+            {
+                file = di::core::openFile( filename );
+            }
+            catch( const std::exception& e )
+            {
+                LogE << "Failed to open PLY file " << filename << ": " << e.what() << LogEnd;
+                throw std::ios_base::failure( "Failed to open PLY file " + filename );
+            }
+
+            auto header = parsePlyHeader( file->getData(), file->getSize(), filename );
+            if( header.format == PlyFormat::Ascii )
+            {
+                loadAsciiPly( *file, header, mesh.get(), colors.get() );
+                numVertices = mesh->getNumVertices();
+                numTriangles = mesh->getNumTriangles();
+                LogD << "Loaded " << numTriangles << " triangles with " << numVertices << " vertices and " << colors->size()
+                     << " colors from ASCII data." << LogEnd;
+            }
+            else if( loadBinaryPly( *file, header, mesh.get(), colors.get(), preview ? m_previewTriangles : 0,
+                        [ & ]( const Vec3Array& vertices, const IndexVec3Array& triangles, size_t numValid )
+                        {
+                            // The snapshot needs its own copy as the arrays are still being filled. Colors are complete already and get shared.
+                            SPtr< di::core::TriangleMesh > previewMesh( new di::core::TriangleMesh() );
+                            previewMesh->setVertices( vertices );
+                            previewMesh->setTriangles( IndexVec3Array( triangles.begin(), triangles.begin() + numValid ) );
+                            previewMesh->calculateNormals();
+
+                            auto previewData = SPtr< di::core::TriangleDataSet >(
+                                new di::core::TriangleDataSet( filename, previewMesh, colors )
+                            );
+                            previewData->setPreview();
+
+                            LogD << "Preview with " << numValid << " of " << triangles.size() << " triangles." << LogEnd;
+                            preview( previewData );
+                        }
+                     ) )
+            {
+                numVertices = header.elements[ header.findElement( "vertex" ) ].count;
+                numTriangles = header.elements[ header.findElement( "face" ) ].count;
+                LogD << "Loaded " << numTriangles << " triangles with " << numVertices << " vertices and " << colors->size()
+                     << " colors from binary data." << LogEnd;
+            }
+            else
+            {
+                // Rply reads from disk on its own.
+                if( di::core::getFileCompression( filename ) != di::core::Compression::None )
+                {
+                    throw std::ios_base::failure( "The layout of the compressed PLY file " + filename + " is not supported. Decompress it first." );
+                }
+                file.reset();
+                loadPlyWithRply( filename, mesh.get(), colors.get(), numVertices, numTriangles );
+            }
+            long numColors = colors->size();
 
             // sanity check:
             if( !(
@@ -230,26 +949,30 @@ namespace di
 
             LogD << "Loading \"" << filename << "\" done." << LogEnd;
 
-            std::vector< glm::vec4 > diffColors;
-            for( auto c : *colors )
+            if( m_analyzeColors )
             {
-                if( std::find( diffColors.begin(), diffColors.end(), c ) == diffColors.end() )
-                {
-                    diffColors.push_back( c );
-                }
+                auto palette = di::core::extractColorPalette( *colors );
+                LogD << "From " << numColors << " specified colors, " << palette.colors.size() << " different where found." << LogEnd;
             }
-            LogD << "From " << numColors << " specified colors, " << diffColors.size() << " different where found." << LogEnd;
 
-            // Restore locale.
-            setlocale( LC_ALL, oldLocale );
-
-            // Optimize mesh. As we did not load normals, create:
+            // Optimize mesh. As we did not load normals, create. This also creates the inverse index.
             mesh->calculateNormals();
-            mesh->calculateInverseIndex();
 
             // construct the dataset
-            return SPtr< di::core::TriangleDataSet >( new di::core::TriangleDataSet( filename, mesh, colors ) );
+            auto result = SPtr< di::core::TriangleDataSet >( new di::core::TriangleDataSet( filename, mesh, colors ) );
+
+            if( m_useCache )
+            {
+                try
+                {
+                    writeMeshCache( cacheFilename, *result, filename );
+                }
+                catch( const std::exception& e )
+                {
+                    LogW << "Could not write mesh cache \"" << cacheFilename << "\": " << e.what() << LogEnd;
+                }
+            }
+            return result;
         }
     }
 }
-
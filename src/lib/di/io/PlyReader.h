@@ -35,15 +35,22 @@ namespace di
     namespace io
     {
         /**
-         * Implements a loader for PLY mesh+attributes files. It implements the \ref Reader interface.
+         * Implements a loader for PLY mesh+attributes files. Files compressed with gzip (".ply.gz") or zstd (".ply.zst") are decompressed while
+         * reading. It implements the \ref Reader interface.
          */
         class PlyReader: public di::core::Reader
         {
         public:
             /**
              * Constructor;
+             *
+             * \param analyzeColors if true, the number of distinct colors is reported after loading. Not needed in batch mode.
+             * \param useCache if true, a mesh cache file is kept next to each loaded file. It is used instead of the PLY file as long as the PLY file
+             * does not change. See \ref readMeshCache.
+             * \param previewTriangles during progressive loading, publish a preview each time this number of triangles is loaded. 0 disables
+             * previews. Previews are only available for binary files with triangle faces.
              */
-            PlyReader();
+            explicit PlyReader( bool analyzeColors = true, bool useCache = false, size_t previewTriangles = 0 );
 
             /**
              * Destructor.
@@ -67,8 +74,32 @@ namespace di
              * \return the data
              */
             virtual SPtr< di::core::DataSetBase > load( const std::string& filename ) const;
+
+            /**
+             * Load the specified file and publish previews with a growing number of triangles while loading. See \ref Reader::loadProgressive.
+             *
+             * \param filename the file to load
+             * \param preview called for each preview
+             *
+             * \return the complete data
+             */
+            virtual SPtr< di::core::DataSetBase > loadProgressive( const std::string& filename, PreviewCallback preview ) const;
         protected:
         private:
+            /**
+             * Report the distinct colors after loading?
+             */
+            bool m_analyzeColors;
+
+            /**
+             * Keep and use mesh cache files?
+             */
+            bool m_useCache;
+
+            /**
+             * The number of triangles between two previews. 0 to disable.
+             */
+            size_t m_previewTriangles;
         };
     }
 }
@@ -0,0 +1,276 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <di/core/Endianness.h>
+#include <di/core/Filesystem.h>
+#include <di/core/Parallel.h>
+#include <di/core/StringUtils.h>
+#include <di/core/data/DataSetTypes.h>
+
+#include "PlyHeader.h"
+#include "PlyWriter.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/PlyWriter"
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * Records are converted and written in blocks of about this size.
+         */
+        const size_t plyWriteBlockSize = 16 * 1024 * 1024;
+
+        PlyWriter::PlyWriter():
+            Writer()
+        {
+        }
+
+        PlyWriter::~PlyWriter()
+        {
+        }
+
+        bool PlyWriter::canWrite( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            std::string ext = di::core::toLower( di::core::getFileExtension( filename ) );
+            return ( ext == "ply" ) && ( ( std::dynamic_pointer_cast< const di::core::TriangleDataSet >( data ) != nullptr ) ||
+                                         ( std::dynamic_pointer_cast< const di::core::TriangleVectorField >( data ) != nullptr ) ||
+                                         ( std::dynamic_pointer_cast< const di::core::TriangleAnnotatedVectorField >( data ) != nullptr ) );
+        }
+
+        /**
+         * Add a scalar property to an element.
+         *
+         * \param element the element
+         * \param name the property name
+         * \param type the property type
+         */
+        void addPlyProperty( PlyElement& element, const std::string& name, PlyType type )
+        {
+            PlyProperty property;
+            property.name = name;
+            property.type = type;
+            element.properties.push_back( property );
+        }
+
+        /**
+         * Write records of an element in large blocks. Each block is filled in parallel and written at once.
+         *
+         * \tparam FillFunction something callable as fill( char* record, size_t index )
+         * \param out the stream
+         * \param count the number of records
+         * \param recordSize the size of a record in bytes
+         * \param fill fills a record
+         * \param filename the file. Used for error messages.
+         *
+         * \throw std::ios_base::failure if writing failed
+         */
+        template< typename FillFunction >
+        void writePlyRecords( std::ofstream& out, size_t count, size_t recordSize, FillFunction fill, const std::string& filename )
+        {
+            size_t recordsPerBlock = std::max< size_t >( 1, plyWriteBlockSize / recordSize );
+            std::vector< char > block( std::min( count, recordsPerBlock ) * recordSize );
+            for( size_t first = 0; first < count; first += recordsPerBlock )
+            {
+                size_t blockCount = std::min( recordsPerBlock, count - first );
+                di::core::parallelFor( 0, blockCount,
+                    [ & ]( size_t begin, size_t end, size_t )
+                    {
+                        for( size_t i = begin; i < end; ++i )
+                        {
+                            fill( block.data() + i * recordSize, first + i );
+                        }
+                    }
+                );
+                if( !out.write( block.data(), blockCount * recordSize ) )
+                {
+                    throw std::ios_base::failure( "Could not write \"" + filename + "\"." );
+                }
+            }
+        }
+
+        /**
+         * Write a triangle mesh with the given per-vertex attributes as binary PLY file. Normals are written if the mesh has them.
+         *
+         * \param filename the file to write
+         * \param mesh the mesh
+         * \param colors the vertex colors. Can be nullptr.
+         * \param labels the vertex labels. Can be nullptr.
+         * \param vectors the vertex vectors. Can be nullptr.
+         *
+         * \throw std::invalid_argument if an attribute does not match the number of vertices
+         * \throw std::ios_base::failure if the file cannot be written
+         */
+        void writeBinaryPly( const std::string& filename, const di::core::TriangleMesh& mesh, const di::RGBAArray* colors,
+                             const di::core::ValueArray< int32_t >* labels, const di::Vec3Array* vectors )
+        {
+            const auto& vertices = mesh.getVertices();
+            const auto& normals = mesh.getNormals();
+            const auto& triangles = mesh.getTriangles();
+            bool hasNormals = !vertices.empty() && ( normals.size() == vertices.size() );
+            if( ( colors && ( colors->size() != vertices.size() ) ) || ( labels && ( labels->size() != vertices.size() ) ) ||
+                ( vectors && ( vectors->size() != vertices.size() ) ) )
+            {
+                throw std::invalid_argument( "Vertex attributes do not match the mesh. Cannot write \"" + filename + "\"." );
+            }
+
+            LogD << "Writing \"" << filename << "\"." << LogEnd;
+
+            PlyHeader header;
+            header.format = di::core::isLittleEndian() ? PlyFormat::BinaryLittleEndian : PlyFormat::BinaryBigEndian;
+
+            PlyElement vertex;
+            vertex.name = "vertex";
+            vertex.count = vertices.size();
+            for( auto name : { "x", "y", "z" } )
+            {
+                addPlyProperty( vertex, name, PlyType::Float32 );
+            }
+            if( hasNormals )
+            {
+                for( auto name : { "nx", "ny", "nz" } )
+                {
+                    addPlyProperty( vertex, name, PlyType::Float32 );
+                }
+            }
+            if( colors )
+            {
+                for( auto name : { "red", "green", "blue", "alpha" } )
+                {
+                    addPlyProperty( vertex, name, PlyType::UInt8 );
+                }
+            }
+            if( labels )
+            {
+                addPlyProperty( vertex, "label", PlyType::Int32 );
+            }
+            if( vectors )
+            {
+                for( auto name : { "vx", "vy", "vz" } )
+                {
+                    addPlyProperty( vertex, name, PlyType::Float32 );
+                }
+            }
+            header.elements.push_back( vertex );
+
+            PlyElement face;
+            face.name = "face";
+            face.count = triangles.size();
+            PlyProperty indices;
+            indices.name = "vertex_indices";
+            indices.type = PlyType::Int32;
+            indices.isList = true;
+            indices.countType = PlyType::UInt8;
+            face.properties.push_back( indices );
+            header.elements.push_back( face );
+
+            std::ofstream out( filename, std::ios::out | std::ios::binary );
+            if( !out.good() )
+            {
+                throw std::ios_base::failure( "Could not open \"" + filename + "\" for writing." );
+            }
+            out << formatPlyHeader( header, "written by DirectionalityIndicator" );
+
+            // The offsets of the optional parts. Each part is contiguous in the record.
+            size_t normalOffset = hasNormals ? vertex.getPropertyOffset( vertex.findProperty( "nx" ) ) : 0;
+            size_t colorOffset = colors ? vertex.getPropertyOffset( vertex.findProperty( "red" ) ) : 0;
+            size_t labelOffset = labels ? vertex.getPropertyOffset( vertex.findProperty( "label" ) ) : 0;
+            size_t vectorOffset = vectors ? vertex.getPropertyOffset( vertex.findProperty( "vx" ) ) : 0;
+
+            writePlyRecords( out, vertices.size(), vertex.getRecordSize(),
+                [ & ]( char* record, size_t index )
+                {
+                    std::memcpy( record, &vertices[ index ], 3 * sizeof( float ) );
+                    if( hasNormals )
+                    {
+                        std::memcpy( record + normalOffset, &normals[ index ], 3 * sizeof( float ) );
+                    }
+                    if( colors )
+                    {
+                        for( int component = 0; component < 4; ++component )
+                        {
+                            float value = std::min( 1.0f, std::max( 0.0f, ( *colors )[ index ][ component ] ) );
+                            record[ colorOffset + component ] = static_cast< char >( static_cast< uint8_t >( value * 255.0f + 0.5f ) );
+                        }
+                    }
+                    if( labels )
+                    {
+                        std::memcpy( record + labelOffset, &( *labels )[ index ], sizeof( int32_t ) );
+                    }
+                    if( vectors )
+                    {
+                        std::memcpy( record + vectorOffset, &( *vectors )[ index ], 3 * sizeof( float ) );
+                    }
+                },
+                filename
+            );
+
+            writePlyRecords( out, triangles.size(), sizeof( uint8_t ) + 3 * sizeof( int32_t ),
+                [ & ]( char* record, size_t index )
+                {
+                    record[ 0 ] = 3;
+                    std::memcpy( record + 1, &triangles[ index ], 3 * sizeof( int32_t ) );
+                },
+                filename
+            );
+
+            LogD << "Wrote " << triangles.size() << " triangles with " << vertices.size() << " vertices to \"" << filename << "\"." << LogEnd;
+        }
+
+        void PlyWriter::write( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            auto annotated = std::dynamic_pointer_cast< const di::core::TriangleAnnotatedVectorField >( data );
+            auto vectorField = std::dynamic_pointer_cast< const di::core::TriangleVectorField >( data );
+            auto triangleData = std::dynamic_pointer_cast< const di::core::TriangleDataSet >( data );
+            if( annotated )
+            {
+                writeBinaryPly( filename, *annotated->getGrid(), annotated->getAttributes< 1 >().get(), annotated->getAttributes< 2 >().get(),
+                                annotated->getAttributes< 0 >().get() );
+            }
+            else if( vectorField )
+            {
+                writeBinaryPly( filename, *vectorField->getGrid(), nullptr, nullptr, vectorField->getAttributes< 0 >().get() );
+            }
+            else if( triangleData )
+            {
+                writeBinaryPly( filename, *triangleData->getGrid(), triangleData->getAttributes< 0 >().get(), nullptr, nullptr );
+            }
+            else
+            {
+                throw std::invalid_argument( "PLY writer only supports triangle meshes and vector fields. Cannot write \"" + filename + "\"." );
+            }
+        }
+    }
+}
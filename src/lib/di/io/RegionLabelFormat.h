@@ -0,0 +1,80 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#ifndef DI_REGIONLABELFORMAT_H
+#define DI_REGIONLABELFORMAT_H
+
+#include <cstdint>
+
+namespace di
+{
+    namespace io
+    {
+        /**
+         * The version of the binary label format. Files of other versions are rejected.
+         */
+        const uint32_t regionLabelVersion = 1;
+
+        /**
+         * The header at the start of a binary label file. All values are stored in the byte order of the writing machine. It is followed by
+         * \ref count labels of type int32_t.
+         */
+        struct RegionLabelHeader
+        {
+            /**
+             * Identifies the file: "DILABELS".
+             */
+            char magic[ 8 ];
+
+            /**
+             * The format version. See \ref regionLabelVersion.
+             */
+            uint32_t version;
+
+            /**
+             * The value 0x01020304 as written by the writing machine. Used to detect foreign byte order.
+             */
+            uint32_t byteOrder;
+
+            /**
+             * The number of labels.
+             */
+            uint64_t count;
+        };
+
+        /**
+         * The magic bytes at the start of each binary label file.
+         */
+        const char regionLabelMagic[ 8 ] = { 'D', 'I', 'L', 'A', 'B', 'E', 'L', 'S' };
+
+        /**
+         * Used to detect the byte order of the writing machine.
+         */
+        const uint32_t regionLabelByteOrder = 0x01020304;
+    }
+}
+
+#endif  // DI_REGIONLABELFORMAT_H
+
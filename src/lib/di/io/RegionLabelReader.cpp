@@ -27,10 +27,17 @@
 #include <stdexcept>
 #include <limits>
 #include <algorithm>
+#include <cctype>
+#include <cstring>
 
+#include <di/core/CompressedFile.h>
+#include <di/core/Endianness.h>
 #include <di/core/Filesystem.h>
+#include <di/core/MappedFile.h>
+#include <di/core/Parallel.h>
 #include <di/core/StringUtils.h>
 
+#include "RegionLabelFormat.h"
 #include "RegionLabelReader.h"
 
 #include <di/core/Logger.h>
@@ -51,37 +58,197 @@ namespace di
 
         bool RegionLabelReader::canLoad( const std::string& filename ) const
         {
-            std::string ext = di::core::getFileExtension( filename );
+            std::string ext = di::core::getFileExtension( di::core::getUncompressedFilename( filename ) );
             return ( di::core::toLower( ext ) == "labelorder" ) ||
                    ( di::core::toLower( ext ) == "labels" ) ||
                    ( di::core::toLower( ext ) == "csv" );
         }
 
-        di::SPtr< di::core::DataSetBase > RegionLabelReader::load( const std::string& filename ) const
+        /**
+         * Parse a label like atoi does: skip whitespace, read an optional sign and the digits. Everything else is ignored.
+         *
+         * \param pos the start of the label text
+         * \param end the end of the label text
+         *
+         * \return the label. 0 if there are no digits.
+         */
+        RegionLabelReader::value_type parseLabel( const char* pos, const char* end )
         {
-            LogD << "Loading \"" << filename << "\"." << LogEnd;
-            auto file = core::readTextFile( filename );
+            while( ( pos < end ) && std::isspace( static_cast< unsigned char >( *pos ) ) )
+            {
+                ++pos;
+            }
+            bool negative = false;
+            if( ( pos < end ) && ( ( *pos == '-' ) || ( *pos == '+' ) ) )
+            {
+                negative = ( *pos == '-' );
+                ++pos;
+            }
+            int64_t value = 0;
+            while( ( pos < end ) && std::isdigit( static_cast< unsigned char >( *pos ) ) )
+            {
+                value = std::min( value * 10 + ( *pos - '0' ), static_cast< int64_t >( std::numeric_limits< RegionLabelReader::value_type >::max() ) );
+                ++pos;
+            }
+            return static_cast< RegionLabelReader::value_type >( negative ? -value : value );
+        }
+
+        /**
+         * Load the labels of a binary label file.
+         *
+         * \param file the mapped file
+         *
+         * \return the labels. Uses the mapped file directly if the byte order matches.
+         */
+        SPtr< RegionLabelReader::AttributeType > loadBinaryLabels( SPtr< di::core::MappedFile > file )
+        {
+            RegionLabelHeader header;
+            std::memcpy( &header, file->getData(), sizeof( header ) );
+
+            // Written on a machine with other byte order?
+            bool swap = ( header.byteOrder != regionLabelByteOrder );
+            if( swap )
+            {
+                di::core::swapBytes( header.version );
+                di::core::swapBytes( header.byteOrder );
+                di::core::swapBytes( header.count );
+                if( header.byteOrder != regionLabelByteOrder )
+                {
+                    throw std::ios_base::failure( "File \"" + file->getFilename() + "\" is not a valid label file." );
+                }
+            }
+            if( header.version != regionLabelVersion )
+            {
+                throw std::ios_base::failure( "Label file \"" + file->getFilename() + "\" was written by another version." );
+            }
+            if( ( file->getSize() - sizeof( header ) ) / sizeof( RegionLabelReader::value_type ) < header.count )
+            {
+                throw std::ios_base::failure( "Label file \"" + file->getFilename() + "\" is truncated." );
+            }
+
+            if( !swap )
+            {
+                return std::make_shared< RegionLabelReader::AttributeType >( file, sizeof( header ), header.count );
+            }
+
+            auto labels = std::make_shared< RegionLabelReader::AttributeType >( header.count );
+            std::memcpy( labels->data(), file->getData() + sizeof( header ), header.count * sizeof( RegionLabelReader::value_type ) );
+            di::core::swapBytes( labels->data(), labels->size(), sizeof( RegionLabelReader::value_type ) );
+            return labels;
+        }
+
+        /**
+         * Parse the labels of a text file. Labels are separated by commas, or by line breaks if there is no comma. The file is split into chunks
+         * at separators. The chunks are parsed in parallel into a preallocated array.
+         *
+         * \param file the mapped file
+         *
+         * \return the labels
+         */
+        SPtr< RegionLabelReader::AttributeType > loadTextLabels( const di::core::MappedFile& file )
+        {
+            const char* begin = file.getData();
+            const char* end = begin + file.getSize();
+            char separator = ( std::memchr( begin, ',', file.getSize() ) != nullptr ) ? ',' : '\n';
 
-            auto labels = std::make_shared< std::vector< value_type > >();
-            value_type min = std::numeric_limits< value_type >::max();
-            value_type max = std::numeric_limits< value_type >::min();
+            // Only split large files. A chunk always ends behind a separator.
+            const size_t minChunkSize = 1024 * 1024;
+            size_t numChunks = std::max( static_cast< size_t >( 1 ), std::min( di::core::getNumberOfThreads(), file.getSize() / minChunkSize ) );
+            std::vector< const char* > chunkBegin( numChunks + 1, end );
+            chunkBegin[ 0 ] = begin;
+            for( size_t chunk = 1; chunk < numChunks; ++chunk )
+            {
+                const char* pos = std::max( chunkBegin[ chunk - 1 ], begin + ( chunk * file.getSize() ) / numChunks );
+                const char* next = static_cast< const char* >( std::memchr( pos, separator, end - pos ) );
+                chunkBegin[ chunk ] = next ? ( next + 1 ) : end;
+            }
 
-            // each line
-            auto items = core::split( file, ',' );
-            if( items.size() <= 1 )
+            // Each separator terminates a label. Count them to know where each chunk writes to.
+            std::vector< size_t > chunkFirstLabel( numChunks + 1, 0 );
+            di::core::parallelFor( 0, numChunks,
+                [ & ]( size_t firstChunk, size_t lastChunk, size_t )
+                {
+                    for( size_t chunk = firstChunk; chunk < lastChunk; ++chunk )
+                    {
+                        chunkFirstLabel[ chunk + 1 ] = std::count( chunkBegin[ chunk ], chunkBegin[ chunk + 1 ], separator );
+                    }
+                },
+                numChunks
+            );
+            for( size_t chunk = 0; chunk < numChunks; ++chunk )
             {
-                items = core::split( file );
+                chunkFirstLabel[ chunk + 1 ] += chunkFirstLabel[ chunk ];
             }
-            for( auto line : items )
+
+            // The text after the last separator is a label too, unless it is only whitespace.
+            const char* tail = end;
+            while( ( tail > begin ) && ( *( tail - 1 ) != separator ) )
             {
-                value_type l = std::atoi( line.c_str() );
-                // A line contains a region label - line number corresponds to the mesh vertex IDs
-                labels->push_back( l );
+                --tail;
+            }
+            bool hasTailLabel = std::any_of( tail, end, []( char c ) { return !std::isspace( static_cast< unsigned char >( c ) ); } );
+            size_t numLabels = chunkFirstLabel[ numChunks ] + ( hasTailLabel ? 1 : 0 );
+
+            auto labels = std::make_shared< RegionLabelReader::AttributeType >( numLabels );
+            di::core::parallelFor( 0, numChunks,
+                [ & ]( size_t firstChunk, size_t lastChunk, size_t )
+                {
+                    for( size_t chunk = firstChunk; chunk < lastChunk; ++chunk )
+                    {
+                        const char* pos = chunkBegin[ chunk ];
+                        const char* chunkEnd = chunkBegin[ chunk + 1 ];
+                        size_t label = chunkFirstLabel[ chunk ];
+                        while( ( pos < chunkEnd ) && ( label < numLabels ) )
+                        {
+                            const char* next = static_cast< const char* >( std::memchr( pos, separator, chunkEnd - pos ) );
+                            next = next ? next : chunkEnd;
+                            ( *labels )[ label++ ] = parseLabel( pos, next );
+                            pos = next + 1;
+                        }
+                    }
+                },
+                numChunks
+            );
+            return labels;
+        }
+
+        di::SPtr< di::core::DataSetBase > RegionLabelReader::load( const std::string& filename ) const
+        {
+            LogD << "Loading \"" << filename << "\"." << LogEnd;
 
-                min = std::min( min, l );
-                max = std::max( max, l );
+            SPtr< di::core::MappedFile > file;
+            try
+            {
+                file = di::core::openFile( filename );
+            }
+            catch( const std::exception& e )
+            {
+                throw std::invalid_argument( "File \"" + filename + "\" could not be opened for reading: " + e.what() );
             }
-            LogD << "Read " << labels->size() << " labels from file. Labels range: [" << min << ", " << max << "]" << LogEnd;
+
+            bool binary = ( file->getSize() >= sizeof( RegionLabelHeader ) ) &&
+                          ( std::memcmp( file->getData(), regionLabelMagic, sizeof( regionLabelMagic ) ) == 0 );
+            auto labels = binary ? loadBinaryLabels( file ) : loadTextLabels( *file );
+
+            // Range, for information only.
+            size_t numChunks = di::core::getNumberOfThreads();
+            std::vector< value_type > chunkMin( numChunks, std::numeric_limits< value_type >::max() );
+            std::vector< value_type > chunkMax( numChunks, std::numeric_limits< value_type >::min() );
+            di::core::parallelFor( 0, labels->size(),
+                [ & ]( size_t begin, size_t end, size_t chunk )
+                {
+                    for( size_t i = begin; i < end; ++i )
+                    {
+                        chunkMin[ chunk ] = std::min( chunkMin[ chunk ], ( *labels )[ i ] );
+                        chunkMax[ chunk ] = std::max( chunkMax[ chunk ], ( *labels )[ i ] );
+                    }
+                },
+                numChunks
+            );
+            value_type min = *std::min_element( chunkMin.begin(), chunkMin.end() );
+            value_type max = *std::max_element( chunkMax.begin(), chunkMax.end() );
+            LogD << "Read " << labels->size() << " labels from " << ( binary ? "binary" : "text" ) << " file. Labels range: [" << min << ", "
+                 << max << "]" << LogEnd;
 
             return std::make_shared< DataSetType >( "Mesh Labels", labels );
         }
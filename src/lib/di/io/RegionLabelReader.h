@@ -25,6 +25,7 @@
 #ifndef DI_REGIONLABELREADER_H
 #define DI_REGIONLABELREADER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -33,13 +34,17 @@
 #include <di/core/Reader.h>
 #include <di/core/data/DataSetBase.h>
 #include <di/core/data/DataSetCollection.h>
+#include <di/core/data/ValueArray.h>
 
 namespace di
 {
     namespace io
     {
         /**
-         * Implements a loader for the region label data format. It implements the \ref di::core::Reader interface.
+         * Implements a loader for the region label data format. Text files contain comma or newline separated integer labels. They are parsed in a
+         * single pass over the memory-mapped file, in parallel for large files. Binary files as written by \ref RegionLabelWriter are used
+         * directly from the memory-mapped file without copying. Compressed files (".labels.gz", ".labels.zst") are decompressed into memory
+         * first. It implements the \ref di::core::Reader interface.
          */
         class RegionLabelReader: public di::core::Reader
         {
@@ -47,12 +52,12 @@ namespace di
             /**
              * The type to use for storing each label value.
              */
-            typedef double value_type;
+            typedef int32_t value_type;
 
             /**
              * The attribute type
              */
-            typedef std::vector< value_type > AttributeType;
+            typedef core::ValueArray< value_type > AttributeType;
 
             /**
              * The resulting data set type after loading.
@@ -0,0 +1,93 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+
+#include <di/core/Filesystem.h>
+#include <di/core/StringUtils.h>
+
+#include "RegionLabelFormat.h"
+#include "RegionLabelReader.h"
+#include "RegionLabelWriter.h"
+
+#include <di/core/Logger.h>
+#define LogTag "io/RegionLabelWriter"
+
+namespace di
+{
+    namespace io
+    {
+        RegionLabelWriter::RegionLabelWriter():
+            Writer()
+        {
+        }
+
+        RegionLabelWriter::~RegionLabelWriter()
+        {
+        }
+
+        bool RegionLabelWriter::canWrite( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            std::string ext = di::core::toLower( di::core::getFileExtension( filename ) );
+            return ( ext == "labels" ) && ( std::dynamic_pointer_cast< const RegionLabelReader::DataSetType >( data ) != nullptr );
+        }
+
+        void RegionLabelWriter::write( const std::string& filename, ConstSPtr< di::core::DataSetBase > data ) const
+        {
+            auto labelData = std::dynamic_pointer_cast< const RegionLabelReader::DataSetType >( data );
+            if( !labelData )
+            {
+                throw std::invalid_argument( "Label writer only supports label data. Cannot write \"" + filename + "\"." );
+            }
+            auto labels = labelData->getAttributes< 0 >();
+
+            LogD << "Writing \"" << filename << "\"." << LogEnd;
+
+            RegionLabelHeader header;
+            std::memcpy( header.magic, regionLabelMagic, sizeof( header.magic ) );
+            header.version = regionLabelVersion;
+            header.byteOrder = regionLabelByteOrder;
+            header.count = labels->size();
+
+            std::ofstream out( filename, std::ios::out | std::ios::binary );
+            if( !out.good() )
+            {
+                throw std::ios_base::failure( "Could not open \"" + filename + "\" for writing." );
+            }
+            out.write( reinterpret_cast< const char* >( &header ), sizeof( header ) );
+            out.write( reinterpret_cast< const char* >( labels->data() ), labels->size() * sizeof( RegionLabelReader::value_type ) );
+            if( !out.good() )
+            {
+                throw std::ios_base::failure( "Could not write \"" + filename + "\"." );
+            }
+
+            LogD << "Wrote " << labels->size() << " labels to \"" << filename << "\"." << LogEnd;
+        }
+    }
+}
@@ -0,0 +1,219 @@
+//---------------------------------------------------------------------------------------
+//
+// Project: DirectionalityIndicator
+//
+// Copyright 2014-2015 Sebastian Eichelbaum (http://www.sebastian-eichelbaum.de)
+//           2014-2015 Max Planck Research Group "Neuroanatomy and Connectivity"
+//
+// This file is part of DirectionalityIndicator.
+//
+// DirectionalityIndicator is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DirectionalityIndicator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DirectionalityIndicator. If not, see <http://www.gnu.org/licenses/>.
+//
+//---------------------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <di/core/CommandQueue.h>
+
+/**
+ * The clock used for all measurements.
+ */
+typedef std::chrono::steady_clock BenchmarkClock;
+
+/**
+ * A command doing nothing but remembering when it was committed.
+ */
+class BenchmarkCommand: public di::core::Command
+{
+public:
+    /**
+     * Name of the command.
+     *
+     * \return the name
+     */
+    std::string getName() const override
+    {
+        return "Benchmark";
+    }
+
+    /**
+     * Description of the command.
+     *
+     * \return the description
+     */
+    std::string getDescription() const override
+    {
+        return "Does nothing.";
+    }
+
+    /**
+     * The time of the commit. Only set for latency measurements.
+     */
+    BenchmarkClock::time_point m_committed;
+};
+
+/**
+ * A queue that only counts the processed commands and optionally measures the time between commit and processing.
+ */
+class BenchmarkQueue: public di::core::CommandQueue
+{
+public:
+    /**
+     * Count the command.
+     *
+     * \param command the command
+     */
+    void process( di::SPtr< di::core::Command > command ) override
+    {
+        if( m_measureLatency )
+        {
+            auto committed = std::static_pointer_cast< BenchmarkCommand >( command )->m_committed;
+            m_latencySum += std::chrono::duration< double, std::micro >( BenchmarkClock::now() - committed ).count();
+        }
+        command->success();
+        m_processed++;
+    }
+
+    /**
+     * Measure the latency of each command. Set before starting the queue.
+     */
+    bool m_measureLatency = false;
+
+    /**
+     * Sum of all latencies in microseconds. Only written by the queue thread.
+     */
+    double m_latencySum = 0.0;
+
+    /**
+     * Number of processed commands.
+     */
+    std::atomic< size_t > m_processed{ 0 };
+};
+
+/**
+ * Commit from several threads at once and report the mean time a commit takes per producer.
+ *
+ * \param producers the number of committing threads
+ * \param commandsPerProducer the number of commands each of them commits
+ */
+static void benchmarkContention( size_t producers, size_t commandsPerProducer )
+{
+    BenchmarkQueue queue;
+    queue.start();
+
+    // Create the commands beforehand. Only the commit is measured.
+    std::vector< di::SPtr< BenchmarkCommand > > commands( producers * commandsPerProducer );
+    for( auto& command : commands )
+    {
+        command = std::make_shared< BenchmarkCommand >();
+    }
+
+    std::vector< double > commitTimes( producers, 0.0 );
+    std::vector< std::thread > threads;
+    auto start = BenchmarkClock::now();
+    for( size_t producer = 0; producer < producers; ++producer )
+    {
+        threads.emplace_back( [ &, producer ]()
+        {
+            auto begin = BenchmarkClock::now();
+            for( size_t i = 0; i < commandsPerProducer; ++i )
+            {
+                queue.commit( commands[ producer * commandsPerProducer + i ] );
+            }
+            commitTimes[ producer ] = std::chrono::duration< double, std::nano >( BenchmarkClock::now() - begin ).count() / commandsPerProducer;
+        } );
+    }
+
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+
+    while( queue.m_processed < commands.size() )
+    {
+        std::this_thread::yield();
+    }
+    double total = std::chrono::duration< double, std::milli >( BenchmarkClock::now() - start ).count();
+    queue.stop();
+
+    double commitTime = 0.0;
+    for( auto time : commitTimes )
+    {
+        commitTime += time;
+    }
+
+    std::cerr << "Producers: " << producers << ", mean commit: " << commitTime / producers << " ns, "
+              << "all processed after: " << total << " ms" << std::endl;
+}
+
+/**
+ * Commit single commands to an idle queue and report the mean time until the queue thread processes them.
+ *
+ * \param samples the number of commands to commit
+ */
+static void benchmarkWakeUp( size_t samples )
+{
+    BenchmarkQueue queue;
+    queue.m_measureLatency = true;
+    queue.start();
+
+    for( size_t i = 0; i < samples; ++i )
+    {
+        // Give the queue thread time to fall asleep.
+        std::this_thread::sleep_for( std::chrono::microseconds( 500 ) );
+
+        auto command = std::make_shared< BenchmarkCommand >();
+        command->m_committed = BenchmarkClock::now();
+        queue.commit( command );
+    }
+
+    while( queue.m_processed < samples )
+    {
+        std::this_thread::yield();
+    }
+    queue.stop();
+
+    std::cerr << "Wake-up latency: " << queue.m_latencySum / samples << " us" << std::endl;
+}
+
+/**
+ * Measure the contention of \ref di::core::CommandQueue::commit and the wake-up latency of the queue thread. The producer count goes up to twice
+ * the number of cores. The numbers are only meaningful on a multi-core machine.
+ *
+ * The results go to stderr, as the library logs to stdout. Run as "CommandQueueBenchmark > /dev/null". The numbers include the cost of the
+ * command state logging, as this is what the application pays too.
+ *
+ * \return 0 always.
+ */
+int main()
+{
+    size_t cores = std::max( 1u, std::thread::hardware_concurrency() );
+    std::cerr << "Hardware threads: " << cores << std::endl;
+
+    const size_t commandsPerProducer = 50000;
+    for( size_t producers = 1; producers <= 2 * cores; producers *= 2 )
+    {
+        benchmarkContention( producers, commandsPerProducer );
+    }
+
+    benchmarkWakeUp( 500 );
+    return 0;
+}